@@ -0,0 +1,66 @@
+#ifndef NN_CLI_AUGMENTATIONRNG_HPP
+#define NN_CLI_AUGMENTATIONRNG_HPP
+
+#include <cstdint>
+#include <limits>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * AugmentationRNG: counter-based random generator for data augmentation (SplitMix64 over a per-sample key).
+ *
+ * The key is mixed from (seed, epoch, entry index) and the n-th value drawn is a hash of key + n, so a sample's random
+ * stream depends on those three numbers only: not on the thread that loads it, the chunk or batch it is loaded in, or
+ * the samples loaded before it. Setting one up costs a few multiplications (std::mt19937 fills 2.5 KB of state).
+ *
+ * It is a UniformRandomBitGenerator, so it drives the std distributions like any engine.
+ */
+  class AugmentationRNG
+  {
+    public:
+      using result_type = std::uint64_t;
+
+      AugmentationRNG(std::uint64_t seed, std::uint64_t epoch, std::uint64_t entryIndex)
+        : key(mix(mix(mix(seed + gamma) + epoch) + entryIndex))
+      {
+      }
+
+      static constexpr result_type min()
+      {
+        return 0;
+      }
+
+      static constexpr result_type max()
+      {
+        return std::numeric_limits<result_type>::max();
+      }
+
+      result_type operator()()
+      {
+        this->counter++;
+        return mix(this->key + this->counter * gamma);
+      }
+
+    private:
+      static constexpr std::uint64_t gamma = 0x9E3779B97F4A7C15ull; // SplitMix64's increment (2^64 / golden ratio)
+
+      // SplitMix64's finaliser: a bijection in which every input bit affects every output bit
+      static constexpr std::uint64_t mix(std::uint64_t z)
+      {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+      }
+
+      std::uint64_t key;
+      std::uint64_t counter = 0;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_AUGMENTATIONRNG_HPP
@@ -0,0 +1,79 @@
+#ifndef NN_CLI_BOUNDEDQUEUE_HPP
+#define NN_CLI_BOUNDEDQUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * BoundedQueue: blocking FIFO with a fixed capacity, connecting the stages of a pipeline.
+ *
+ * push() waits while the queue is full and pop() while it is empty, so a fast stage cannot run ahead of a slow one
+ * by more than the capacity. close() ends the stream: pending items can still be popped, further pushes fail, and
+ * every blocked caller is woken (this is also how a failing stage stops the others).
+ */
+  template <typename T>
+  class BoundedQueue
+  {
+    public:
+      explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1)
+      {
+      }
+
+      // Returns false (dropping item) if the queue was closed.
+      bool push(T item)
+      {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->notFull.wait(lock, [this]() { return this->closed || this->items.size() < this->capacity; });
+
+        if (this->closed)
+          return false;
+
+        this->items.push_back(std::move(item));
+        this->notEmpty.notify_one();
+        return true;
+      }
+
+      // Returns false once the queue is closed and drained.
+      bool pop(T& item)
+      {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->notEmpty.wait(lock, [this]() { return this->closed || !this->items.empty(); });
+
+        if (this->items.empty())
+          return false;
+
+        item = std::move(this->items.front());
+        this->items.pop_front();
+        this->notFull.notify_one();
+        return true;
+      }
+
+      void close()
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->closed = true;
+        this->notEmpty.notify_all();
+        this->notFull.notify_all();
+      }
+
+    private:
+      size_t capacity;
+      std::mutex mutex;
+      std::condition_variable notEmpty;
+      std::condition_variable notFull;
+      std::deque<T> items;
+      bool closed = false;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_BOUNDEDQUEUE_HPP
@@ -0,0 +1,88 @@
+#include "NN-CLI_CheckpointWriter.hpp"
+
+#include <QtConcurrent>
+
+#include <exception>
+#include <iostream>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  CheckpointWriter::CheckpointWriter(LogLevel logLevel) : logLevel(logLevel)
+  {
+    this->pool.setMaxThreadCount(1);
+  }
+
+  //===================================================================================================================//
+
+  CheckpointWriter::~CheckpointWriter()
+  {
+    this->flush();
+    this->pool.waitForDone();
+  }
+
+  //===================================================================================================================//
+
+  void CheckpointWriter::submit(const std::string& filePath, WriteFunction write)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->pending.has_value() && this->logLevel >= LogLevel::INFO)
+      std::cout << "\nCheckpoint superseded before it was written: " << this->pending->filePath << "\n";
+
+    this->pending = Job{filePath, std::move(write)};
+
+    if (!this->running) {
+      this->running = true;
+      QtConcurrent::run(&this->pool, [this]() { this->drain(); });
+    }
+  }
+
+  //===================================================================================================================//
+
+  void CheckpointWriter::flush()
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->idle.wait(lock, [this]() { return !this->running; });
+  }
+
+  //===================================================================================================================//
+
+  void CheckpointWriter::drain()
+  {
+    while (true) {
+      Job job;
+
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        if (!this->pending.has_value()) {
+          this->running = false;
+          this->idle.notify_all();
+          return;
+        }
+
+        job = std::move(*this->pending);
+        this->pending.reset();
+      }
+
+      // A failed checkpoint must not abort training; report it and carry on
+      try {
+        job.write(job.filePath);
+
+        if (this->logLevel > LogLevel::QUIET)
+          std::cout << "\nCheckpoint saved to: " << job.filePath << "\n";
+      } catch (const std::exception& e) {
+        std::cerr << "\nFailed to save checkpoint " << job.filePath << ": " << e.what() << "\n";
+      } catch (...) {
+        // Anything escaping would leave `running` set, and flush() would wait forever
+        std::cerr << "\nFailed to save checkpoint " << job.filePath << ": unknown error\n";
+      }
+    }
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,67 @@
+#ifndef NN_CLI_CHECKPOINTWRITER_HPP
+#define NN_CLI_CHECKPOINTWRITER_HPP
+
+#include "NN-CLI_LogLevel.hpp"
+
+#include <QThreadPool>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * CheckpointWriter: writes checkpoints on a background thread so training never waits for serialisation or disk.
+ *
+ * The training callback takes a snapshot and submits a job that writes it. At most one job is pending: if a newer
+ * checkpoint arrives before the pending one has started, it replaces it (only the most recent state matters).
+ * The job currently being written always completes.
+ */
+  class CheckpointWriter
+  {
+    public:
+      // Writes the snapshot captured by the job to the given path.
+      using WriteFunction = std::function<void(const std::string& filePath)>;
+
+      explicit CheckpointWriter(LogLevel logLevel);
+
+      // Waits for outstanding writes.
+      ~CheckpointWriter();
+
+      CheckpointWriter(const CheckpointWriter&) = delete;
+      CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+      // Queue a checkpoint; returns immediately.
+      void submit(const std::string& filePath, WriteFunction write);
+
+      // Block until every submitted checkpoint has been written (or superseded).
+      void flush();
+
+    private:
+      struct Job {
+          std::string filePath;
+          WriteFunction write;
+      };
+
+      void drain();
+
+      LogLevel logLevel;
+      QThreadPool pool; // Single writer thread
+
+      std::mutex mutex;
+      std::condition_variable idle;
+      std::optional<Job> pending;
+      bool running = false; // A drain task is scheduled or writing
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_CHECKPOINTWRITER_HPP
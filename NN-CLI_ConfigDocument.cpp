@@ -0,0 +1,158 @@
+#include "NN-CLI_ConfigDocument.hpp"
+#include "NN-CLI_JsonStream.hpp"
+#include "NN-CLI_ModelFile.hpp"
+
+#include <QByteArray>
+#include <QFile>
+
+#include <stdexcept>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+  //-- Shared state --//
+  //===================================================================================================================//
+
+  struct ConfigDocument::Data {
+      std::string filePath;
+      QFile file;
+      uchar* mapped = nullptr;
+      QByteArray fileData; // Used instead of the mapping for files that cannot be mapped
+      const char* bytes = nullptr;
+      size_t size = 0;
+
+      nlohmann::json json;
+      bool hasParameters = false;
+      JsonStream::Range parametersRange;
+      nlohmann::json inlineParameters; // Scalar "parameters" (never deferred), or a binary model's blob layout
+
+      bool binaryModel = false;
+      size_t blobOffset = 0;
+
+      ~Data()
+      {
+        if (this->mapped)
+          this->file.unmap(this->mapped);
+      }
+  };
+
+  //===================================================================================================================//
+
+  ConfigDocument ConfigDocument::load(const std::string& filePath)
+  {
+    auto data = std::make_shared<Data>();
+    data->filePath = filePath;
+    data->file.setFileName(QString::fromStdString(filePath));
+
+    if (!data->file.open(QIODevice::ReadOnly)) {
+      throw std::runtime_error("Failed to open config file: " + filePath);
+    }
+
+    qint64 fileSize = data->file.size();
+    data->mapped = (fileSize > 0) ? data->file.map(0, fileSize) : nullptr;
+
+    if (data->mapped) {
+      data->bytes = reinterpret_cast<const char*>(data->mapped);
+      data->size = static_cast<size_t>(fileSize);
+    } else {
+      data->fileData = data->file.readAll();
+      data->bytes = data->fileData.constData();
+      data->size = static_cast<size_t>(data->fileData.size());
+    }
+
+    if (ModelFile::isBinaryModel(data->bytes, data->size)) {
+      // Binary model: the header is small JSON; parameter values stay in the mapping until copied out
+      data->binaryModel = true;
+      data->json = ModelFile::readBinaryHeader(data->bytes, data->size, filePath, data->blobOffset);
+
+      if (data->json.contains("parameters")) {
+        data->hasParameters = true;
+        data->inlineParameters = std::move(data->json.at("parameters"));
+        data->json.erase("parameters");
+      }
+
+      ConfigDocument document;
+      document.data = std::move(data);
+      return document;
+    }
+
+    std::map<std::string, JsonStream::Range> deferred;
+    data->json = JsonStream::parseDeferring(data->bytes, data->size, filePath, {"parameters"}, deferred);
+
+    auto it = deferred.find("parameters");
+
+    if (it != deferred.end()) {
+      data->hasParameters = true;
+      data->parametersRange = it->second;
+    } else if (data->json.is_object() && data->json.contains("parameters")) {
+      // A scalar "parameters" is left in the DOM by the parser; move it out so json() is consistent either way
+      data->hasParameters = true;
+      data->inlineParameters = std::move(data->json.at("parameters"));
+      data->json.erase("parameters");
+    }
+
+    ConfigDocument document;
+    document.data = std::move(data);
+    return document;
+  }
+
+  //===================================================================================================================//
+
+  const std::string& ConfigDocument::filePath() const
+  {
+    return this->data->filePath;
+  }
+
+  //===================================================================================================================//
+
+  const nlohmann::json& ConfigDocument::json() const
+  {
+    return this->data->json;
+  }
+
+  //===================================================================================================================//
+
+  bool ConfigDocument::hasParameters() const
+  {
+    return this->data->hasParameters;
+  }
+
+  //===================================================================================================================//
+
+  nlohmann::json ConfigDocument::parameters() const
+  {
+    if (!this->data->hasParameters) {
+      throw std::runtime_error("Config file has no 'parameters': " + this->data->filePath);
+    }
+
+    if (this->data->parametersRange.end == 0)
+      return this->data->inlineParameters;
+
+    return JsonStream::parseRange(this->data->bytes, this->data->parametersRange, this->data->filePath);
+  }
+
+  //===================================================================================================================//
+
+  bool ConfigDocument::isBinaryModel() const
+  {
+    return this->data->binaryModel;
+  }
+
+  //===================================================================================================================//
+
+  const char* ConfigDocument::blobData() const
+  {
+    return this->data->binaryModel ? this->data->bytes + this->data->blobOffset : nullptr;
+  }
+
+  //===================================================================================================================//
+
+  size_t ConfigDocument::blobDataSize() const
+  {
+    return this->data->binaryModel ? this->data->size - this->data->blobOffset : 0;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,55 @@
+#ifndef NN_CLI_CONFIGDOCUMENT_HPP
+#define NN_CLI_CONFIGDOCUMENT_HPP
+
+#include <json.hpp>
+
+#include <memory>
+#include <string>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * ConfigDocument: a config or model file, read and parsed once and shared by every Loader entry point.
+ *
+ * A trained model carries its weights under "parameters", which can be hundreds of MB of JSON. That value is only
+ * located during the initial parse; it is materialised by parameters() when the network loader actually needs it.
+ * The file stays memory-mapped for the lifetime of the document (copies share the same parsed state).
+ *
+ * Binary models (.nnb, see ModelFile) are detected by their magic: json() is their header, parameters() the layout
+ * of the float32 blobs, and blobData() points at the mapped blob region.
+ */
+  class ConfigDocument
+  {
+    public:
+      // Read and parse a config file. Throws if it cannot be opened or is not valid JSON.
+      static ConfigDocument load(const std::string& filePath);
+
+      const std::string& filePath() const;
+
+      // Everything in the file except "parameters".
+      const nlohmann::json& json() const;
+
+      bool hasParameters() const;
+
+      // Parse and return the "parameters" value (throws if absent). Each call parses it again.
+      nlohmann::json parameters() const;
+
+      bool isBinaryModel() const;
+
+      // Blob region of a binary model (nullptr / 0 for JSON files).
+      const char* blobData() const;
+      size_t blobDataSize() const;
+
+    private:
+      struct Data;
+      std::shared_ptr<const Data> data;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_CONFIGDOCUMENT_HPP
@@ -1,4 +1,8 @@
 #include "NN-CLI_DataLoader.hpp"
+#include "NN-CLI_AugmentationRNG.hpp"
+#include "NN-CLI_JsonStream.hpp"
+#include "NN-CLI_ProgressBar.hpp"
+#include "NN-CLI_ScratchArena.hpp"
 
 #include <QFile>
 #include <QFileInfo>
@@ -10,6 +14,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <stdexcept>
 
 namespace NN_CLI
@@ -37,14 +42,10 @@ namespace NN_CLI
     if (!file.open(QIODevice::ReadOnly))
       throw std::runtime_error("Failed to open samples file: " + samplesFilePath);
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
-    const nlohmann::json& samplesArray = json.at("samples");
-
     this->manifest.clear();
-    this->manifest.reserve(samplesArray.size());
 
-    for (const auto& sampleJson : samplesArray) {
+    // Stream the "samples" array so only one entry exists as JSON at a time
+    JsonStream::forEachArrayElement(file, "samples", [&](const nlohmann::json& sampleJson) {
       SampleManifest entry;
 
       // Store input reference (path or raw data — but do NOT load images)
@@ -66,11 +67,15 @@ namespace NN_CLI
       }
 
       this->manifest.push_back(std::move(entry));
-    }
+    });
+
+    this->manifest.shrink_to_fit();
 
     // Initialize entries as 1:1 mapping to manifest (no augmentation yet)
-    this->fromMemory = false;
+    this->source = SampleSource::MANIFEST;
     this->memorySamples.clear();
+    this->packed.reset();
+    this->idx.reset();
     this->entries.clear();
     this->entries.reserve(this->manifest.size());
     for (ulong i = 0; i < this->manifest.size(); i++) {
@@ -88,8 +93,10 @@ namespace NN_CLI
     this->inputC = inputC;
     this->inputH = inputH;
     this->inputW = inputW;
-    this->fromMemory = true;
+    this->source = SampleSource::MEMORY;
     this->manifest.clear();
+    this->packed.reset();
+    this->idx.reset();
     this->memorySamples = std::move(samples);
 
     this->entries.clear();
@@ -100,10 +107,94 @@ namespace NN_CLI
   }
 
   //===================================================================================================================//
-  //-- planAugmentation --//
+  //-- loadPacked --//
+  //===================================================================================================================//
+
+  template <typename SampleT>
+  void DataLoader<SampleT>::loadPacked(const std::string& packedFilePath, int inputC, int inputH, int inputW)
+  {
+    std::shared_ptr<const PackedDataset> dataset = PackedDataset::open(packedFilePath);
+    const PackedDataset::Layout& layout = dataset->layout();
+
+    bool hasShape = (inputC > 0 && inputH > 0 && inputW > 0);
+
+    if (hasShape && layout.inputSize != static_cast<ulong>(inputC) * inputH * inputW) {
+      throw std::runtime_error("Packed dataset input size (" + std::to_string(layout.inputSize) +
+                               ") does not match expected input shape size (" +
+                               std::to_string(static_cast<ulong>(inputC) * inputH * inputW) + "): " + packedFilePath);
+    }
+
+    this->inputC = inputC;
+    this->inputH = inputH;
+    this->inputW = inputW;
+    this->outputC = layout.outputC;
+    this->outputH = layout.outputH;
+    this->outputW = layout.outputW;
+    this->source = SampleSource::PACKED;
+    this->manifest.clear();
+    this->memorySamples.clear();
+    this->idx.reset();
+    this->packed = std::move(dataset);
+
+    this->entries.clear();
+    this->entries.reserve(this->packed->numSamples());
+    for (ulong i = 0; i < this->packed->numSamples(); i++) {
+      this->entries.push_back({i, false});
+    }
+  }
+
+  //===================================================================================================================//
+  //-- loadIDX --//
+  //===================================================================================================================//
+
+  template <typename SampleT>
+  void DataLoader<SampleT>::loadIDX(const std::string& dataPath, const std::string& labelsPath, int inputC,
+                                    int inputH, int inputW)
+  {
+    std::shared_ptr<const IDXDataset> dataset = IDXDataset::open(dataPath, labelsPath);
+
+    bool hasShape = (inputC > 0 && inputH > 0 && inputW > 0);
+
+    if (hasShape && dataset->inputSize() != static_cast<ulong>(inputC) * inputH * inputW) {
+      throw std::runtime_error("IDX data item size (" + std::to_string(dataset->inputSize()) +
+                               ") does not match expected input shape size (" +
+                               std::to_string(static_cast<ulong>(inputC) * inputH * inputW) + ")");
+    }
+
+    this->inputC = inputC;
+    this->inputH = inputH;
+    this->inputW = inputW;
+    this->outputC = 0;
+    this->outputH = 0;
+    this->outputW = 0;
+    this->source = SampleSource::IDX;
+    this->manifest.clear();
+    this->memorySamples.clear();
+    this->packed.reset();
+    this->idx = std::move(dataset);
+
+    this->entries.clear();
+    this->entries.reserve(this->idx->numSamples());
+    for (ulong i = 0; i < this->idx->numSamples(); i++) {
+      this->entries.push_back({i, false});
+    }
+  }
+
+  //===================================================================================================================//
+  //-- Source accessors --//
   //===================================================================================================================//
 
-  // Helper to get the output vector from a sample (works for both ANN and CNN).
+  // Helpers to get the input/output vectors from a sample (works for both ANN and CNN).
+  static const std::vector<float>& sampleInput(const ANN::Sample<float>& s)
+  {
+    return s.input;
+  }
+
+  static const std::vector<float>& sampleInput(const CNN::Sample<float>& s)
+  {
+    return s.input.data;
+  }
+
   static const std::vector<float>& sampleOutput(const ANN::Sample<float>& s)
   {
     return s.output;
@@ -114,10 +205,120 @@ namespace NN_CLI
     return s.output;
   }
 
+  template <typename SampleT>
+  ulong DataLoader<SampleT>::numSourceSamples() const
+  {
+    switch (this->source) {
+    case SampleSource::MEMORY:
+      return this->memorySamples.size();
+    case SampleSource::PACKED:
+      return this->packed->numSamples();
+    case SampleSource::IDX:
+      return this->idx->numSamples();
+    case SampleSource::MANIFEST:
+      break;
+    }
+
+    return this->manifest.size();
+  }
+
+  template <typename SampleT>
+  std::vector<float> DataLoader<SampleT>::sourceOutput(ulong sourceIndex) const
+  {
+    switch (this->source) {
+    case SampleSource::MEMORY:
+      return sampleOutput(this->memorySamples[sourceIndex]);
+    case SampleSource::PACKED: {
+      std::vector<float> output(this->packed->layout().outputSize);
+      this->packed->readOutput(sourceIndex, output.data());
+      return output;
+    }
+
+    case SampleSource::IDX: {
+      std::vector<float> output(this->idx->numClasses());
+      this->idx->readOutput(sourceIndex, output.data());
+      return output;
+    }
+
+    case SampleSource::MANIFEST:
+      break;
+    }
+
+    return this->manifest[sourceIndex].output;
+  }
+
+  //===================================================================================================================//
+  //-- exportPacked --//
+  //===================================================================================================================//
+
+  template <typename SampleT>
+  void DataLoader<SampleT>::exportPacked(const std::string& packedFilePath, bool quantizeInputs,
+                                         ulong progressReports) const
+  {
+    ulong total = this->numSourceSamples();
+
+    if (total == 0)
+      throw std::runtime_error("No samples to convert.");
+
+    // Original samples occupy the first numSourceSamples() entries (augmented ones are appended after them).
+    // Load in chunks through the regular parallel batch path so decode runs on ioPool.
+    const ulong chunkSize = 1024;
+    std::unique_ptr<PackedDataset> dataset;
+
+    for (ulong start = 0; start < total; start += chunkSize) {
+      ulong end = std::min(start + chunkSize, total);
+      std::vector<ulong> indices(end - start);
+      std::iota(indices.begin(), indices.end(), start);
+
+      std::vector<SampleT> chunk = this->loadBatch(indices, {}, 0.0f, 0);
+
+      if (!dataset) {
+        PackedDataset::Layout layout;
+        layout.numSamples = total;
+        layout.inputSize = sampleInput(chunk[0]).size();
+        layout.outputSize = sampleOutput(chunk[0]).size();
+        layout.inputType = quantizeInputs ? PackedDataset::ElementType::UINT8 : PackedDataset::ElementType::FLOAT32;
+        layout.inputC = this->inputC;
+        layout.inputH = this->inputH;
+        layout.inputW = this->inputW;
+        layout.outputC = this->outputC;
+        layout.outputH = this->outputH;
+        layout.outputW = this->outputW;
+        dataset = PackedDataset::create(packedFilePath, layout);
+      }
+
+      const PackedDataset::Layout& layout = dataset->layout();
+
+      for (ulong i = 0; i < chunk.size(); i++) {
+        const std::vector<float>& input = sampleInput(chunk[i]);
+        const std::vector<float>& output = sampleOutput(chunk[i]);
+
+        if (input.size() != layout.inputSize || output.size() != layout.outputSize) {
+          throw std::runtime_error("Sample " + std::to_string(start + i) +
+                                   " has a different input/output size than the first sample — "
+                                   "packed datasets require fixed-size samples.");
+        }
+
+        dataset->writeInput(start + i, input.data());
+        dataset->writeOutput(start + i, output.data());
+      }
+
+      this->recycle(std::move(chunk));
+
+      ProgressBar::printLoadingProgress("Converting samples:", end, total, progressReports);
+    }
+
+    dataset->finish();
+  }
+
+  //===================================================================================================================//
+  //-- planAugmentation --//
+  //===================================================================================================================//
+
   template <typename SampleT>
   void DataLoader<SampleT>::planAugmentation(ulong augmentationFactor, bool balanceAugmentation)
   {
-    ulong originalCount = this->fromMemory ? this->memorySamples.size() : this->manifest.size();
+    ulong originalCount = this->numSourceSamples();
 
     if (augmentationFactor == 0 && !balanceAugmentation)
       return;
@@ -132,9 +333,7 @@ namespace NN_CLI
 
     std::map<ulong, std::vector<ulong>> classIndices;
     for (ulong i = 0; i < originalCount; i++) {
-      const std::vector<float>& output =
-        this->fromMemory ? sampleOutput(this->memorySamples[i]) : this->manifest[i].output;
-      ulong cls = getClassIndex(output);
+      ulong cls = getClassIndex(this->sourceOutput(i));
       classIndices[cls].push_back(i);
     }
 
@@ -182,10 +381,7 @@ namespace NN_CLI
     std::vector<std::vector<float>> outputs;
     outputs.reserve(this->entries.size());
     for (const auto& entry : this->entries) {
-      if (this->fromMemory)
-        outputs.push_back(sampleOutput(this->memorySamples[entry.sourceIndex]));
-      else
-        outputs.push_back(this->manifest[entry.sourceIndex].output);
+      outputs.push_back(this->sourceOutput(entry.sourceIndex));
     }
 
     return outputs;
@@ -198,10 +394,23 @@ namespace NN_CLI
   template <typename SampleT>
   std::vector<SampleT> DataLoader<SampleT>::loadBatch(const std::vector<ulong>& entryIndices,
                                                       const Loader::AugmentationTransforms& transforms,
-                                                      float augmentationProbability) const
+                                                      float augmentationProbability, ulong epoch) const
   {
     ulong count = entryIndices.size();
-    std::vector<SampleT> batch(count);
+
+    // A recycled batch keeps its samples' buffers, which loadSample fills in place
+    std::vector<SampleT> batch;
+
+    {
+      std::lock_guard<std::mutex> lock(this->batchPool->mutex);
+
+      if (!this->batchPool->batches.empty()) {
+        batch = std::move(this->batchPool->batches.back());
+        this->batchPool->batches.pop_back();
+      }
+    }
+
+    batch.resize(count);
 
     // Load all images in parallel using a dedicated I/O thread pool
     // (separate from the global pool used by the training loop).
@@ -221,11 +430,9 @@ namespace NN_CLI
       offset = chunkEnd;
 
       futures.append(QtConcurrent::run(this->ioPool.get(), [this, &entryIndices, &batch, &transforms,
-                                                            augmentationProbability, chunkStart, chunkEnd]() {
-        std::mt19937 rng(std::random_device{}());
-
+                                                            augmentationProbability, epoch, chunkStart, chunkEnd]() {
         for (ulong i = chunkStart; i < chunkEnd; i++) {
-          batch[i] = this->loadSample(entryIndices[i], rng, transforms, augmentationProbability);
+          this->loadSample(entryIndices[i], epoch, transforms, augmentationProbability, batch[i]);
         }
       }));
     }
@@ -233,9 +440,23 @@ namespace NN_CLI
     for (auto& f : futures)
       f.waitForFinished();
 
+    ScratchArena::recordBatch();
     return batch;
   }
 
+  //===================================================================================================================//
+
+  template <typename SampleT>
+  void DataLoader<SampleT>::recycle(std::vector<SampleT>&& batch) const
+  {
+    std::lock_guard<std::mutex> lock(this->batchPool->mutex);
+
+    if (this->batchPool->batches.size() < maxPooledBatches)
+      this->batchPool->batches.push_back(std::move(batch));
+  }
+
+  //===================================================================================================================//
+
   template <typename SampleT>
   typename DataLoader<SampleT>::ProviderT
   DataLoader<SampleT>::makeSampleProvider(const Loader::AugmentationTransforms& transforms,
@@ -246,27 +467,41 @@ namespace NN_CLI
     auto prefetchPool = std::make_shared<QThreadPool>();
     prefetchPool->setMaxThreadCount(1);
 
-    using BatchPtr = std::shared_ptr<std::vector<SampleT>>;
-    auto prefetch = std::make_shared<QFuture<BatchPtr>>();
-    auto hasPrefetch = std::make_shared<bool>(false);
+    // The prefetched batch is loaded straight into this state, so handing it over is a move
+    struct Prefetch {
+        QFuture<void> future;
+        std::vector<SampleT> batch;
+        bool pending = false;
+        ulong epoch = 0; // Index of the current epoch (augmentation is keyed by it)
+        bool started = false;
+    };
+
+    auto prefetch = std::make_shared<Prefetch>();
 
-    return [this, prefetchPool, prefetch, hasPrefetch, transforms, augmentationProbability](
+    return [this, prefetchPool, prefetch, transforms, augmentationProbability](
              const std::vector<ulong>& sampleIndices, ulong batchSize, ulong batchIndex) -> std::vector<SampleT> {
       ulong numSamples = sampleIndices.size();
       ulong start = batchIndex * batchSize;
       ulong end = std::min(start + batchSize, numSamples);
 
+      // Every epoch starts again from batch 0
+      if (batchIndex == 0) {
+        prefetch->epoch += prefetch->started ? 1 : 0;
+        prefetch->started = true;
+      }
+
+      ulong epoch = prefetch->epoch;
+
       // If the previous call prefetched this batch, retrieve it; otherwise load now.
-      BatchPtr batchPtr;
+      std::vector<SampleT> batch;
 
-      if (*hasPrefetch) {
-        prefetch->waitForFinished();
-        batchPtr = prefetch->result();
-        *hasPrefetch = false;
+      if (prefetch->pending) {
+        prefetch->pending = false;
+        prefetch->future.waitForFinished();
+        batch = std::move(prefetch->batch);
       } else {
         std::vector<ulong> indices(sampleIndices.begin() + start, sampleIndices.begin() + end);
-        batchPtr =
-          std::make_shared<std::vector<SampleT>>(this->loadBatch(indices, transforms, augmentationProbability));
+        batch = this->loadBatch(indices, transforms, augmentationProbability, epoch);
       }
 
       // Prefetch the next batch on the dedicated prefetch pool.
@@ -277,48 +512,112 @@ namespace NN_CLI
         ulong nextEnd = std::min(nextStart + batchSize, numSamples);
         std::vector<ulong> nextIndices(sampleIndices.begin() + nextStart, sampleIndices.begin() + nextEnd);
 
-        *prefetch = QtConcurrent::run(
-          prefetchPool.get(),
-          [this, indices = std::move(nextIndices), transforms, augmentationProbability]() -> BatchPtr {
-            return std::make_shared<std::vector<SampleT>>(
-              this->loadBatch(indices, transforms, augmentationProbability));
-          });
+        // The task holds the state weakly: the state owns the task's future, so a strong reference would be a cycle
+        std::weak_ptr<Prefetch> target = prefetch;
+
+        prefetch->future = QtConcurrent::run(prefetchPool.get(), [this, target, indices = std::move(nextIndices),
+                                                                  transforms, augmentationProbability, epoch]() {
+          if (auto state = target.lock())
+            state->batch = this->loadBatch(indices, transforms, augmentationProbability, epoch);
+        });
 
-        *hasPrefetch = true;
+        prefetch->pending = true;
       }
 
-      return std::move(*batchPtr);
+      return batch;
     };
   }
 
+  //===================================================================================================================//
+  //-- loadManifestImage --//
+  //===================================================================================================================//
+
+  template <typename SampleT>
+  void DataLoader<SampleT>::loadManifestImage(const std::string& imagePath, ulong sourceIndex, bool isOutput, int c,
+                                              int h, int w, float* data) const
+  {
+    std::string fullPath = ImageLoader::resolvePath(imagePath, this->baseDir);
+
+    if (!this->imageCache && !this->diskImageCache) {
+      ImageLoader::loadImage(fullPath, c, h, w, data);
+      return;
+    }
+
+    ulong cacheKey = sourceIndex * 2 + (isOutput ? 1 : 0);
+    ImageCache::Pixels pixels = this->imageCache ? this->imageCache->find(cacheKey) : nullptr;
+
+    if (!pixels) {
+      // Not in memory: try the on-disk cache (written by an earlier epoch or run) before decoding
+      std::vector<unsigned char> decoded;
+
+      if (!this->diskImageCache || !this->diskImageCache->load(fullPath, c, h, w, decoded)) {
+        decoded = ImageLoader::decodeImage(fullPath, c, h, w);
+
+        if (this->diskImageCache)
+          this->diskImageCache->store(fullPath, c, h, w, decoded);
+      }
+
+      pixels = std::make_shared<const std::vector<unsigned char>>(std::move(decoded));
+
+      if (this->imageCache)
+        this->imageCache->insert(cacheKey, pixels);
+    }
+
+    ImageLoader::toNCHW(pixels->data(), c, h, w, data);
+  }
+
   //===================================================================================================================//
   //-- loadSample specializations --//
   //===================================================================================================================//
 
+  namespace
+  {
+    // Give a (possibly recycled) input the loader's shape, keeping its buffer when it already has the right size
+    void shapeInput(CNN::Input<float>& input, int c, int h, int w)
+    {
+      if (input.data.size() == static_cast<size_t>(c) * h * w)
+        return;
+
+      input = CNN::Input<float>(CNN::Shape3D{static_cast<ulong>(c), static_cast<ulong>(h), static_cast<ulong>(w)});
+    }
+  }
+
+  //===================================================================================================================//
+
   template <>
-  ANN::Sample<float> DataLoader<ANN::Sample<float>>::loadSample(ulong entryIndex, std::mt19937& rng,
-                                                                const Loader::AugmentationTransforms& transforms,
-                                                                float augmentationProbability) const
+  void DataLoader<ANN::Sample<float>>::loadSample(ulong entryIndex, ulong epoch,
+                                                  const Loader::AugmentationTransforms& transforms,
+                                                  float augmentationProbability, ANN::Sample<float>& sample) const
   {
     const AugmentedEntry& entry = this->entries[entryIndex];
 
-    ANN::Sample<float> sample;
-
-    if (this->fromMemory) {
-      sample = this->memorySamples[entry.sourceIndex]; // copy
+    if (this->source == SampleSource::MEMORY) {
+      sample = this->memorySamples[entry.sourceIndex]; // copy (into the existing buffers)
+    } else if (this->source == SampleSource::PACKED) {
+      sample.input.resize(this->packed->layout().inputSize);
+      sample.output.resize(this->packed->layout().outputSize);
+      this->packed->readInput(entry.sourceIndex, sample.input.data());
+      this->packed->readOutput(entry.sourceIndex, sample.output.data());
+    } else if (this->source == SampleSource::IDX) {
+      sample.input.resize(this->idx->inputSize());
+      sample.output.resize(this->idx->numClasses());
+      this->idx->readInput(entry.sourceIndex, sample.input.data());
+      this->idx->readOutput(entry.sourceIndex, sample.output.data());
     } else {
       const SampleManifest& m = this->manifest[entry.sourceIndex];
 
       if (m.inputIsImage) {
-        std::string fullPath = ImageLoader::resolvePath(m.inputPath, this->baseDir);
-        sample.input = ImageLoader::loadImage(fullPath, this->inputC, this->inputH, this->inputW);
+        sample.input.resize(static_cast<size_t>(this->inputC) * this->inputH * this->inputW);
+        this->loadManifestImage(m.inputPath, entry.sourceIndex, false, this->inputC, this->inputH, this->inputW,
+                                sample.input.data());
       } else {
         sample.input = m.inputData;
       }
 
       if (m.outputIsImage) {
-        std::string fullPath = ImageLoader::resolvePath(m.outputPath, this->baseDir);
-        sample.output = ImageLoader::loadImage(fullPath, this->outputC, this->outputH, this->outputW);
+        sample.output.resize(static_cast<size_t>(this->outputC) * this->outputH * this->outputW);
+        this->loadManifestImage(m.outputPath, entry.sourceIndex, true, this->outputC, this->outputH, this->outputW,
+                                sample.output.data());
       } else {
         sample.output = m.output;
       }
@@ -326,6 +625,7 @@ namespace NN_CLI
 
     // Apply augmentation if this is an augmented entry
     if (entry.augmented) {
+      AugmentationRNG rng(this->augmentationSeed, epoch, entryIndex);
       bool hasImageShape = (this->inputC > 0 && this->inputH > 0 && this->inputW > 0);
 
       if (hasImageShape) {
@@ -335,43 +635,46 @@ namespace NN_CLI
         ImageLoader::addGaussianNoise(sample.input, transforms.gaussianNoise, rng);
       }
     }
-
-    return sample;
   }
 
   //===================================================================================================================//
 
   template <>
-  CNN::Sample<float> DataLoader<CNN::Sample<float>>::loadSample(ulong entryIndex, std::mt19937& rng,
-                                                                const Loader::AugmentationTransforms& transforms,
-                                                                float augmentationProbability) const
+  void DataLoader<CNN::Sample<float>>::loadSample(ulong entryIndex, ulong epoch,
+                                                  const Loader::AugmentationTransforms& transforms,
+                                                  float augmentationProbability, CNN::Sample<float>& sample) const
   {
     const AugmentedEntry& entry = this->entries[entryIndex];
 
-    CNN::Sample<float> sample;
-
-    if (this->fromMemory) {
-      sample = this->memorySamples[entry.sourceIndex]; // copy
+    if (this->source == SampleSource::MEMORY) {
+      sample = this->memorySamples[entry.sourceIndex]; // copy (into the existing buffers)
+    } else if (this->source == SampleSource::PACKED) {
+      shapeInput(sample.input, this->inputC, this->inputH, this->inputW);
+      sample.output.resize(this->packed->layout().outputSize);
+      this->packed->readInput(entry.sourceIndex, sample.input.data.data());
+      this->packed->readOutput(entry.sourceIndex, sample.output.data());
+    } else if (this->source == SampleSource::IDX) {
+      shapeInput(sample.input, this->inputC, this->inputH, this->inputW);
+      sample.output.resize(this->idx->numClasses());
+      this->idx->readInput(entry.sourceIndex, sample.input.data.data());
+      this->idx->readOutput(entry.sourceIndex, sample.output.data());
     } else {
       const SampleManifest& m = this->manifest[entry.sourceIndex];
 
       if (m.inputIsImage) {
-        std::string fullPath = ImageLoader::resolvePath(m.inputPath, this->baseDir);
-        std::vector<float> flatInput = ImageLoader::loadImage(fullPath, this->inputC, this->inputH, this->inputW);
-        CNN::Shape3D shape{static_cast<ulong>(this->inputC), static_cast<ulong>(this->inputH),
-                           static_cast<ulong>(this->inputW)};
-        sample.input = CNN::Input<float>(shape);
-        sample.input.data = std::move(flatInput);
+        // Decoded straight into the sample's buffer
+        shapeInput(sample.input, this->inputC, this->inputH, this->inputW);
+        this->loadManifestImage(m.inputPath, entry.sourceIndex, false, this->inputC, this->inputH, this->inputW,
+                                sample.input.data.data());
       } else {
-        CNN::Shape3D shape{static_cast<ulong>(this->inputC), static_cast<ulong>(this->inputH),
-                           static_cast<ulong>(this->inputW)};
-        sample.input = CNN::Input<float>(shape);
+        shapeInput(sample.input, this->inputC, this->inputH, this->inputW);
         sample.input.data = m.inputData;
       }
 
       if (m.outputIsImage) {
-        std::string fullPath = ImageLoader::resolvePath(m.outputPath, this->baseDir);
-        sample.output = ImageLoader::loadImage(fullPath, this->outputC, this->outputH, this->outputW);
+        sample.output.resize(static_cast<size_t>(this->outputC) * this->outputH * this->outputW);
+        this->loadManifestImage(m.outputPath, entry.sourceIndex, true, this->outputC, this->outputH, this->outputW,
+                                sample.output.data());
       } else {
         sample.output = m.output;
       }
@@ -379,11 +682,10 @@ namespace NN_CLI
 
     // Apply augmentation if this is an augmented entry
     if (entry.augmented) {
+      AugmentationRNG rng(this->augmentationSeed, epoch, entryIndex);
       ImageLoader::applyRandomTransforms(sample.input.data, this->inputC, this->inputH, this->inputW, rng, transforms,
                                          augmentationProbability);
     }
-
-    return sample;
   }
 
   //===================================================================================================================//
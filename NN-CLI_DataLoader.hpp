@@ -1,17 +1,23 @@
 #ifndef NN_CLI_DATALOADER_HPP
 #define NN_CLI_DATALOADER_HPP
 
+#include "NN-CLI_DiskImageCache.hpp"
+#include "NN-CLI_IDXDataset.hpp"
+#include "NN-CLI_ImageCache.hpp"
 #include "NN-CLI_ImageLoader.hpp"
 #include "NN-CLI_Loader.hpp"
+#include "NN-CLI_PackedDataset.hpp"
 
 #include <ANN_Sample.hpp>
 #include <CNN_Sample.hpp>
 
+#include <QThread>
 #include <QThreadPool>
 
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <string>
 #include <vector>
@@ -31,11 +37,19 @@ namespace NN_CLI
       bool outputIsImage = false; // Whether output is an image path
   };
 
+  // Where the original (non-augmented) samples come from.
+  enum class SampleSource {
+    MANIFEST, // JSON manifest — paths/values, images decoded on demand
+    MEMORY, // Fully loaded samples
+    PACKED, // Memory-mapped packed dataset file (see PackedDataset)
+    IDX // IDX image/label files kept as raw bytes (see IDXDataset)
+  };
+
   // Entry in the expanded (augmented) sample list.
   // For original samples: sourceIndex == own index in the original list, augmented == false.
   // For augmented samples: sourceIndex == original sample index, augmented == true.
   struct AugmentedEntry {
-      ulong sourceIndex; // Index into the original sample list (manifest or memorySamples)
+      ulong sourceIndex; // Index into the original sample list (manifest, memorySamples or packed file)
       bool augmented; // Whether to apply random transforms when loading
   };
 
@@ -62,9 +76,49 @@ namespace NN_CLI
       void loadManifest(const std::string& samplesFilePath, const IOConfig& ioConfig, int inputC, int inputH,
                         int inputW, int outputC = 0, int outputH = 0, int outputW = 0);
 
-      // Load from pre-loaded samples (e.g. IDX format). Stores samples in memory.
+      // Load from pre-loaded samples. Stores samples in memory.
       void loadFromMemory(std::vector<SampleT>&& samples, int inputC, int inputH, int inputW);
 
+      // Memory-map a packed dataset file (written by exportPacked). No sample data is read up front.
+      // When an input shape is given it must match the one stored in the file.
+      void loadPacked(const std::string& packedFilePath, int inputC, int inputH, int inputW);
+
+      // Read an IDX3 data / IDX1 labels pair, keeping pixels as uint8 and labels as bytes.
+      // Samples are normalised and one-hot encoded when their batch is loaded.
+      // When an input shape is given its size must match the IDX item size.
+      void loadIDX(const std::string& dataPath, const std::string& labelsPath, int inputC, int inputH, int inputW);
+
+      // Write the original (non-augmented) samples of the current source into a packed dataset file.
+      // quantizeInputs stores inputs as uint8 (lossless for [0,1] image data decoded from 8-bit files).
+      // Samples are loaded in parallel on ioPool, in chunks, so memory stays bounded.
+      void exportPacked(const std::string& packedFilePath, bool quantizeInputs, ulong progressReports = 1000) const;
+
+      // Keep decoded manifest images in a shared cache, so later epochs (and augmented copies of the same source
+      // sample) skip decoding and resizing. Only the manifest source decodes images; nullptr disables caching.
+      void setImageCache(std::shared_ptr<ImageCache> imageCache)
+      {
+        this->imageCache = std::move(imageCache);
+      }
+
+      // Persist decoded manifest images in a directory shared across runs (checked after the in-memory cache).
+      void setDiskImageCache(std::shared_ptr<DiskImageCache> diskImageCache)
+      {
+        this->diskImageCache = std::move(diskImageCache);
+      }
+
+      // Number of threads decoding samples in loadBatch / exportPacked (0 = one per core, the default).
+      void setIOThreads(int numThreads)
+      {
+        this->ioPool->setMaxThreadCount((numThreads > 0) ? numThreads : QThread::idealThreadCount());
+      }
+
+      // Seed of the augmentation transforms. An augmented sample's transforms depend only on the seed, the epoch and
+      // the sample's entry index, so they are the same whatever the thread count or batch size.
+      void setAugmentationSeed(ulong seed)
+      {
+        this->augmentationSeed = seed;
+      }
+
       // Compute augmentation plan (expand entries without loading data).
       void planAugmentation(ulong augmentationFactor, bool balanceAugmentation);
 
@@ -84,28 +138,58 @@ namespace NN_CLI
       ProviderT makeSampleProvider(const Loader::AugmentationTransforms& transforms = {},
                                    float augmentationProbability = 0.5f) const;
 
+      // Hand a batch back once its samples are no longer needed. The next batch loaded reuses its sample buffers
+      // instead of allocating new ones (at most maxPooledBatches are kept; the rest are freed).
+      void recycle(std::vector<SampleT>&& batch) const;
+
     private:
       std::vector<SampleManifest> manifest; // Original samples — paths + labels (JSON path)
       std::vector<SampleT> memorySamples; // Original samples — fully loaded (memory path)
-      bool fromMemory = false; // Which source to use
+      std::shared_ptr<const PackedDataset> packed; // Original samples — memory-mapped file (packed path)
+      std::shared_ptr<const IDXDataset> idx; // Original samples — raw IDX bytes (IDX path)
+      SampleSource source = SampleSource::MANIFEST; // Which source to use
       std::vector<AugmentedEntry> entries; // Expanded list (original + augmented)
       std::string baseDir; // Base directory for resolving relative paths
       int inputC = 0, inputH = 0, inputW = 0;
       int outputC = 0, outputH = 0, outputW = 0;
       IOConfig ioConfig;
+      ulong augmentationSeed = 0;
+      std::shared_ptr<ImageCache> imageCache; // Decoded manifest images (optional)
+      std::shared_ptr<DiskImageCache> diskImageCache; // Decoded manifest images on disk (optional)
+
+      // Number of original samples in the active source.
+      ulong numSourceSamples() const;
+
+      // Output vector of an original sample (label), without loading its input.
+      std::vector<float> sourceOutput(ulong sourceIndex) const;
 
       // Dedicated thread pool for image loading — separate from the global pool
       // used by the training loop, so prefetch work doesn't compete with training.
       std::shared_ptr<QThreadPool> ioPool = std::make_shared<QThreadPool>();
 
-      // Load a batch of samples by their entry indices.
-      std::vector<SampleT> loadBatch(const std::vector<ulong>& entryIndices,
-                                     const Loader::AugmentationTransforms& transforms,
-                                     float augmentationProbability) const;
+      // Batches handed back through recycle(), waiting to be refilled by loadBatch
+      struct BatchPool {
+          std::mutex mutex;
+          std::vector<std::vector<SampleT>> batches;
+      };
 
-      // Retrieve a single sample by entry index, optionally applying augmentation.
-      SampleT loadSample(ulong entryIndex, std::mt19937& rng, const Loader::AugmentationTransforms& transforms,
-                         float augmentationProbability) const;
+      static constexpr ulong maxPooledBatches = 4;
+      std::shared_ptr<BatchPool> batchPool = std::make_shared<BatchPool>();
+
+      // Load a batch of samples by their entry indices, augmented with the transforms of this epoch.
+      std::vector<SampleT> loadBatch(const std::vector<ulong>& entryIndices,
+                                     const Loader::AugmentationTransforms& transforms, float augmentationProbability,
+                                     ulong epoch) const;
+
+      // Load a manifest image as NCHW floats into data (c * h * w floats), through the image caches when they are set.
+      // Input and output images of the same sample get distinct cache keys.
+      void loadManifestImage(const std::string& imagePath, ulong sourceIndex, bool isOutput, int c, int h, int w,
+                             float* data) const;
+
+      // Retrieve a single sample by entry index into sample, optionally applying augmentation.
+      // The sample's existing buffers are reused when their sizes already match.
+      void loadSample(ulong entryIndex, ulong epoch, const Loader::AugmentationTransforms& transforms,
+                      float augmentationProbability, SampleT& sample) const;
   };
 
 } // namespace NN_CLI
@@ -0,0 +1,249 @@
+#include "NN-CLI_DiskImageCache.hpp"
+#include "NN-CLI_ImageDecoder.hpp"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+  //-- On-disk entry --//
+  //===================================================================================================================//
+
+  namespace
+  {
+    constexpr char kMagic[8] = {'N', 'N', 'C', 'L', 'I', 'I', 'C', '\0'};
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+
+    // Followed by keySize bytes of key, then payloadSize bytes of HWC uint8 pixels
+    struct EntryHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        int32_t c, h, w;
+        uint32_t keySize;
+        int64_t sourceModified; // ms since epoch
+        int64_t sourceSize;
+        uint64_t payloadSize;
+        uint64_t checksum; // FNV-1a of the payload
+    };
+
+    uint64_t fnv1a(const unsigned char* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL)
+    {
+      for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+      }
+
+      return hash;
+    }
+
+    struct SourceInfo {
+        bool exists = false;
+        std::string key; // Absolute path + target shape + decoder backend
+        int64_t modified = 0;
+        int64_t size = 0;
+    };
+
+    SourceInfo sourceInfo(const std::string& imagePath, int c, int h, int w)
+    {
+      QFileInfo info(QString::fromStdString(imagePath));
+      SourceInfo source;
+      source.exists = info.exists();
+
+      if (!source.exists)
+        return source;
+
+      // Backends decode to different pixels (libjpeg scales in the DCT domain), so builds with different decoders
+      // must not share entries. An unreadable source is left to the decoder to report.
+      ImageDecoder::Backend backend;
+
+      try {
+        backend = ImageDecoder::select(imagePath, c);
+      } catch (const std::runtime_error&) {
+        source.exists = false;
+        return source;
+      }
+
+      source.key = info.absoluteFilePath().toStdString() + "|" + std::to_string(c) + "x" + std::to_string(h) + "x" +
+                   std::to_string(w) + "|" + ImageDecoder::backendName(backend);
+      source.modified = info.lastModified().toMSecsSinceEpoch();
+      source.size = info.size();
+      return source;
+    }
+
+    // Check an entry against the current source file and copy its pixels out. False if stale or corrupt.
+    bool readEntry(const char* data, size_t size, const SourceInfo& source, int c, int h, int w,
+                   std::vector<unsigned char>& pixels)
+    {
+      EntryHeader header;
+
+      if (size < sizeof(header))
+        return false;
+
+      std::memcpy(&header, data, sizeof(header));
+
+      size_t expectedPayload = static_cast<size_t>(c) * h * w;
+
+      if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+          header.byteOrder != kByteOrderMark)
+        return false;
+
+      if (header.c != c || header.h != h || header.w != w || header.payloadSize != expectedPayload)
+        return false;
+
+      if (header.sourceModified != source.modified || header.sourceSize != source.size)
+        return false;
+
+      if (header.keySize != source.key.size() || size != sizeof(header) + header.keySize + header.payloadSize)
+        return false;
+
+      // Entry names are hashes, so compare the full key to rule out collisions
+      const char* key = data + sizeof(header);
+
+      if (std::memcmp(key, source.key.data(), header.keySize) != 0)
+        return false;
+
+      const unsigned char* payload = reinterpret_cast<const unsigned char*>(key + header.keySize);
+
+      if (fnv1a(payload, header.payloadSize) != header.checksum)
+        return false;
+
+      pixels.assign(payload, payload + header.payloadSize);
+      return true;
+    }
+  }
+
+  //===================================================================================================================//
+
+  DiskImageCache::DiskImageCache(const std::string& dirPath)
+  {
+    QDir dir(QString::fromStdString(dirPath));
+
+    if (!dir.exists() && !QDir().mkpath(QString::fromStdString(dirPath))) {
+      throw std::runtime_error("Failed to create image cache directory: " + dirPath);
+    }
+
+    this->dirPath = QDir(QString::fromStdString(dirPath)).absolutePath().toStdString();
+  }
+
+  //===================================================================================================================//
+
+  std::string DiskImageCache::entryPath(const std::string& key) const
+  {
+    uint64_t hash = fnv1a(reinterpret_cast<const unsigned char*>(key.data()), key.size());
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.nnic", static_cast<unsigned long long>(hash));
+    return this->dirPath + "/" + name;
+  }
+
+  //===================================================================================================================//
+
+  bool DiskImageCache::load(const std::string& imagePath, int c, int h, int w, std::vector<unsigned char>& pixels)
+  {
+    SourceInfo source = sourceInfo(imagePath, c, h, w);
+
+    if (!source.exists) {
+      this->misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    QFile file(QString::fromStdString(this->entryPath(source.key)));
+
+    if (!file.open(QIODevice::ReadOnly)) {
+      this->misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    qint64 fileSize = file.size();
+    uchar* mapped = (fileSize > 0) ? file.map(0, fileSize) : nullptr;
+    bool valid;
+
+    if (mapped) {
+      valid = readEntry(reinterpret_cast<const char*>(mapped), static_cast<size_t>(fileSize), source, c, h, w, pixels);
+      file.unmap(mapped);
+    } else {
+      QByteArray fileData = file.readAll();
+      valid = readEntry(fileData.constData(), static_cast<size_t>(fileData.size()), source, c, h, w, pixels);
+    }
+
+    if (!valid) {
+      this->rebuilt.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    this->hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  //===================================================================================================================//
+
+  void DiskImageCache::store(const std::string& imagePath, int c, int h, int w,
+                             const std::vector<unsigned char>& pixels)
+  {
+    SourceInfo source = sourceInfo(imagePath, c, h, w);
+
+    if (!source.exists || pixels.size() != static_cast<size_t>(c) * h * w)
+      return;
+
+    EntryHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.c = c;
+    header.h = h;
+    header.w = w;
+    header.keySize = static_cast<uint32_t>(source.key.size());
+    header.sourceModified = source.modified;
+    header.sourceSize = source.size;
+    header.payloadSize = pixels.size();
+    header.checksum = fnv1a(pixels.data(), pixels.size());
+
+    // Unique temporary name: other threads or runs may be writing the same entry
+    std::string filePath = this->entryPath(source.key);
+    std::string tmpPath = filePath + "." + std::to_string(std::random_device{}()) + ".tmp";
+    QFile file(QString::fromStdString(tmpPath));
+
+    bool written = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+
+    if (written) {
+      written = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header) &&
+                file.write(source.key.data(), source.key.size()) == static_cast<qint64>(source.key.size()) &&
+                file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size()) ==
+                  static_cast<qint64>(pixels.size());
+      file.close();
+    }
+
+    if (!written || std::rename(tmpPath.c_str(), filePath.c_str()) != 0) {
+      QFile::remove(QString::fromStdString(tmpPath));
+      this->writeFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  //===================================================================================================================//
+
+  DiskImageCache::Stats DiskImageCache::takeStats()
+  {
+    Stats stats;
+    stats.hits = this->hits.exchange(0, std::memory_order_relaxed);
+    stats.misses = this->misses.exchange(0, std::memory_order_relaxed);
+    stats.rebuilt = this->rebuilt.exchange(0, std::memory_order_relaxed);
+    stats.writeFailures = this->writeFailures.exchange(0, std::memory_order_relaxed);
+    return stats;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
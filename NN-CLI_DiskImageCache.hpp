@@ -0,0 +1,72 @@
+#ifndef NN_CLI_DISKIMAGECACHE_HPP
+#define NN_CLI_DISKIMAGECACHE_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  using ulong = unsigned long;
+
+  /**
+ * DiskImageCache: decoded, resized images persisted in a directory so later runs skip decoding altogether.
+ *
+ * Each image gets one file, named by a hash of (absolute source path, target C/H/W, ImageDecoder backend; builds with
+ * and without libjpeg decode different pixels). The file holds a small header recording the full key, the source
+ * file's size and modification time, and a checksum of the pixels, followed by the interleaved HWC uint8 pixels (the
+ * same buffer ImageLoader::decodeImage returns).
+ *
+ * Reads memory-map the entry and validate it against the source file; a missing, stale (source changed) or corrupt
+ * entry is reported as a miss and the caller rebuilds it with store(). Entries are written to a temporary file and
+ * renamed into place, so concurrent runs sharing the directory never observe a partial entry.
+ */
+  class DiskImageCache
+  {
+    public:
+      struct Stats {
+          ulong hits = 0;
+          ulong misses = 0; // No entry yet
+          ulong rebuilt = 0; // Entry existed but was stale or corrupt
+          ulong writeFailures = 0;
+      };
+
+      // Creates the directory if needed. Throws if it cannot be created.
+      explicit DiskImageCache(const std::string& dirPath);
+
+      DiskImageCache(const DiskImageCache&) = delete;
+      DiskImageCache& operator=(const DiskImageCache&) = delete;
+
+      // Read the cached pixels of imagePath at the given target shape into pixels. Returns false on a miss.
+      bool load(const std::string& imagePath, int c, int h, int w, std::vector<unsigned char>& pixels);
+
+      // Persist pixels for imagePath. Failures are counted, not thrown: the cache is an optimisation only.
+      void store(const std::string& imagePath, int c, int h, int w, const std::vector<unsigned char>& pixels);
+
+      // Counters since the previous call (they are reset).
+      Stats takeStats();
+
+      const std::string& directory() const
+      {
+        return this->dirPath;
+      }
+
+    private:
+      std::string entryPath(const std::string& key) const;
+
+      std::string dirPath;
+
+      std::atomic<ulong> hits{0};
+      std::atomic<ulong> misses{0};
+      std::atomic<ulong> rebuilt{0};
+      std::atomic<ulong> writeFailures{0};
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_DISKIMAGECACHE_HPP
@@ -0,0 +1,66 @@
+#include "NN-CLI_IDXDataset.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  std::unique_ptr<IDXDataset> IDXDataset::open(const std::string& dataPath, const std::string& labelsPath)
+  {
+    std::unique_ptr<IDXDataset> dataset(new IDXDataset());
+    dataset->data = IDXFile::open(dataPath);
+    dataset->labels = IDXFile::open(labelsPath);
+
+    const IDXFile& labels = *dataset->labels;
+
+    if (!IDXFile::isIntegerType(labels.elementType()) || labels.itemSize() != 1) {
+      throw std::runtime_error("IDX labels file must hold one integer per item: " + labelsPath);
+    }
+
+    if (dataset->data->numItems() != labels.numItems()) {
+      throw std::runtime_error("IDX data and labels count mismatch");
+    }
+
+    // 8-bit images become [0, 1]; wider types are assumed to be in the range the network expects already
+    if (dataset->data->elementType() == IDXFile::ElementType::UBYTE)
+      dataset->inputScale = 1.0f / 255.0f;
+
+    // One-hot width follows the largest label present
+    double maxLabel = 0;
+
+    for (ulong i = 0; i < labels.numItems(); i++) {
+      double label = labels.item(i)[0];
+
+      if (label < 0) {
+        throw std::runtime_error("IDX labels must not be negative: " + labelsPath);
+      }
+
+      maxLabel = std::max(maxLabel, label);
+    }
+
+    dataset->classCount = static_cast<ulong>(maxLabel) + 1;
+
+    return dataset;
+  }
+
+  //===================================================================================================================//
+
+  void IDXDataset::readInput(ulong index, float* dst) const
+  {
+    this->data->readItem(index, dst, this->inputScale);
+  }
+
+  //===================================================================================================================//
+
+  void IDXDataset::readOutput(ulong index, float* dst) const
+  {
+    std::fill(dst, dst + this->classCount, 0.0f);
+    dst[static_cast<ulong>(this->labels->item(index)[0])] = 1.0f;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
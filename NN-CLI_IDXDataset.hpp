@@ -0,0 +1,61 @@
+#ifndef NN_CLI_IDXDATASET_HPP
+#define NN_CLI_IDXDATASET_HPP
+
+#include "NN-CLI_IDXFile.hpp"
+
+#include <memory>
+#include <string>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * IDXDataset: an IDX data file and its IDX labels file, used as samples without expanding them.
+ *
+ * Both files stay memory-mapped (see IDXFile), so a dataset costs no heap memory and opens instantly.
+ * Normalisation and one-hot expansion happen per sample on read, when a batch is assembled: unsigned byte data is
+ * scaled by 1/255, other element types are used as stored. Labels must be one integer per item.
+ */
+  class IDXDataset
+  {
+    public:
+      // Map both files. Throws on a missing file, bad magic, truncated data, non-integer labels or a count mismatch.
+      static std::unique_ptr<IDXDataset> open(const std::string& dataPath, const std::string& labelsPath);
+
+      ulong numSamples() const
+      {
+        return this->data->numItems();
+      }
+
+      // Values per sample (product of the data file's item dimensions).
+      ulong inputSize() const
+      {
+        return this->data->itemSize();
+      }
+
+      // Length of the one-hot output (largest label + 1).
+      ulong numClasses() const
+      {
+        return this->classCount;
+      }
+
+      // Copy sample `index` into dst (inputSize() floats / numClasses() one-hot floats).
+      void readInput(ulong index, float* dst) const;
+      void readOutput(ulong index, float* dst) const;
+
+    private:
+      IDXDataset() = default;
+
+      std::unique_ptr<IDXFile> data;
+      std::unique_ptr<IDXFile> labels;
+      float inputScale = 1.0f;
+      ulong classCount = 0;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_IDXDATASET_HPP
@@ -0,0 +1,217 @@
+#include "NN-CLI_IDXFile.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+  //-- Big-endian decoding --//
+  //===================================================================================================================//
+
+  namespace
+  {
+    uint32_t readBigEndianUInt32(const uchar* p)
+    {
+      return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+             (static_cast<uint32_t>(p[2]) << 8) | (static_cast<uint32_t>(p[3]));
+    }
+
+    int16_t decodeShort(const uchar* p)
+    {
+      return static_cast<int16_t>((static_cast<uint16_t>(p[0]) << 8) | p[1]);
+    }
+
+    int32_t decodeInt(const uchar* p)
+    {
+      return static_cast<int32_t>(readBigEndianUInt32(p));
+    }
+
+    float decodeFloat(const uchar* p)
+    {
+      uint32_t bits = readBigEndianUInt32(p);
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    double decodeDouble(const uchar* p)
+    {
+      uint64_t bits = (static_cast<uint64_t>(readBigEndianUInt32(p)) << 32) | readBigEndianUInt32(p + 4);
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    // One loop per element type, so the type switch stays outside the per-element work
+    template <ulong Bytes, typename Decode>
+    void decodeItem(const uchar* src, ulong count, float* dst, float scale, Decode decode)
+    {
+      for (ulong i = 0; i < count; i++)
+        dst[i] = static_cast<float>(decode(src + i * Bytes)) * scale;
+    }
+  }
+
+  //===================================================================================================================//
+
+  IDXFile::~IDXFile()
+  {
+    if (this->mapped)
+      this->file.unmap(this->mapped);
+  }
+
+  //===================================================================================================================//
+
+  std::unique_ptr<IDXFile> IDXFile::open(const std::string& filePath)
+  {
+    std::unique_ptr<IDXFile> idx(new IDXFile());
+    idx->filePath = filePath;
+    idx->file.setFileName(QString::fromStdString(filePath));
+
+    if (!idx->file.open(QIODevice::ReadOnly))
+      throw std::runtime_error("Failed to open IDX file: " + filePath);
+
+    qint64 fileSize = idx->file.size();
+
+    if (fileSize < 4)
+      throw std::runtime_error("IDX file is truncated: " + filePath);
+
+    idx->mapped = idx->file.map(0, fileSize);
+
+    if (!idx->mapped)
+      throw std::runtime_error("Failed to memory-map IDX file: " + filePath);
+
+    // Magic: two zero bytes, the element type, the number of dimensions
+    const uchar* magic = idx->mapped;
+    uint8_t typeCode = magic[2];
+    ulong numDims = magic[3];
+
+    if (magic[0] != 0 || magic[1] != 0 || numDims == 0)
+      throw std::runtime_error("Invalid IDX file magic number: " + filePath);
+
+    switch (static_cast<ElementType>(typeCode)) {
+    case ElementType::UBYTE:
+    case ElementType::BYTE:
+    case ElementType::SHORT:
+    case ElementType::INT:
+    case ElementType::FLOAT:
+    case ElementType::DOUBLE:
+      idx->type = static_cast<ElementType>(typeCode);
+      break;
+    default:
+      throw std::runtime_error("Unsupported IDX element type " + std::to_string(typeCode) + ": " + filePath);
+    }
+
+    ulong headerSize = 4 + 4 * numDims;
+
+    if (static_cast<ulong>(fileSize) < headerSize)
+      throw std::runtime_error("IDX file is truncated: " + filePath);
+
+    // Sizes are checked by division so corrupt dimensions cannot overflow the products
+    ulong payloadBytes = static_cast<ulong>(fileSize) - headerSize;
+    idx->dimensions.resize(numDims);
+    idx->elementsPerItem = 1;
+
+    for (ulong d = 0; d < numDims; d++) {
+      idx->dimensions[d] = readBigEndianUInt32(idx->mapped + 4 + 4 * d);
+
+      if (d == 0)
+        continue;
+
+      if (idx->dimensions[d] > 0 && idx->elementsPerItem > payloadBytes / idx->dimensions[d])
+        throw std::runtime_error("IDX file is truncated: " + filePath);
+
+      idx->elementsPerItem *= idx->dimensions[d];
+    }
+
+    idx->itemStride = idx->elementsPerItem * elementBytes(idx->type);
+    idx->payload = idx->mapped + headerSize;
+
+    if (idx->itemStride > 0 && idx->numItems() > payloadBytes / idx->itemStride)
+      throw std::runtime_error("IDX file is truncated: " + filePath);
+
+    return idx;
+  }
+
+  //===================================================================================================================//
+
+  void IDXFile::readItem(ulong index, float* dst, float scale) const
+  {
+    const uchar* src = this->payload + index * this->itemStride;
+    ulong count = this->elementsPerItem;
+
+    switch (this->type) {
+    case ElementType::UBYTE:
+      decodeItem<1>(src, count, dst, scale, [](const uchar* p) { return *p; });
+      break;
+    case ElementType::BYTE:
+      decodeItem<1>(src, count, dst, scale, [](const uchar* p) { return static_cast<int8_t>(*p); });
+      break;
+    case ElementType::SHORT:
+      decodeItem<2>(src, count, dst, scale, decodeShort);
+      break;
+    case ElementType::INT:
+      decodeItem<4>(src, count, dst, scale, decodeInt);
+      break;
+    case ElementType::FLOAT:
+      decodeItem<4>(src, count, dst, scale, decodeFloat);
+      break;
+    case ElementType::DOUBLE:
+      decodeItem<8>(src, count, dst, scale, decodeDouble);
+      break;
+    }
+  }
+
+  //===================================================================================================================//
+
+  ulong IDXFile::elementBytes(ElementType type)
+  {
+    switch (type) {
+    case ElementType::SHORT:
+      return 2;
+    case ElementType::INT:
+    case ElementType::FLOAT:
+      return 4;
+    case ElementType::DOUBLE:
+      return 8;
+    case ElementType::UBYTE:
+    case ElementType::BYTE:
+      break;
+    }
+
+    return 1;
+  }
+
+  //===================================================================================================================//
+
+  bool IDXFile::isIntegerType(ElementType type)
+  {
+    return type != ElementType::FLOAT && type != ElementType::DOUBLE;
+  }
+
+  //===================================================================================================================//
+
+  double IDXFile::decode(const uchar* p, ElementType type)
+  {
+    switch (type) {
+    case ElementType::BYTE:
+      return static_cast<int8_t>(*p);
+    case ElementType::SHORT:
+      return decodeShort(p);
+    case ElementType::INT:
+      return decodeInt(p);
+    case ElementType::FLOAT:
+      return decodeFloat(p);
+    case ElementType::DOUBLE:
+      return decodeDouble(p);
+    case ElementType::UBYTE:
+      break;
+    }
+
+    return *p;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,129 @@
+#ifndef NN_CLI_IDXFILE_HPP
+#define NN_CLI_IDXFILE_HPP
+
+#include <QFile>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  using ulong = unsigned long;
+
+  /**
+ * IDXFile: read-only, memory-mapped view of an IDX file (the MNIST container format).
+ *
+ * Layout: [0x00 0x00 type ndims][ndims big-endian uint32 dimensions][elements, big-endian, row-major]
+ * The first dimension counts items; the remaining ones make up one item. Every IDX element type is supported.
+ *
+ * Nothing is copied on open: items are views into the mapping, decoded element by element on access, so only the
+ * pages of the items actually read are loaded from disk.
+ */
+  class IDXFile
+  {
+    public:
+      enum class ElementType : uint8_t {
+        UBYTE = 0x08,
+        BYTE = 0x09,
+        SHORT = 0x0B,
+        INT = 0x0C,
+        FLOAT = 0x0D,
+        DOUBLE = 0x0E
+      };
+
+      // One item: itemSize() elements, strided by elementBytes() in the mapping.
+      class ItemView
+      {
+        public:
+          ItemView(const uchar* data, ulong size, ElementType type) : bytes(data), count(size), type(type)
+          {
+          }
+
+          ulong size() const
+          {
+            return this->count;
+          }
+
+          // Raw big-endian bytes of the item (zero-copy).
+          const uchar* data() const
+          {
+            return this->bytes;
+          }
+
+          double operator[](ulong i) const
+          {
+            return IDXFile::decode(this->bytes + i * IDXFile::elementBytes(this->type), this->type);
+          }
+
+        private:
+          const uchar* bytes;
+          ulong count;
+          ElementType type;
+      };
+
+      ~IDXFile();
+
+      IDXFile(const IDXFile&) = delete;
+      IDXFile& operator=(const IDXFile&) = delete;
+
+      // Map an IDX file. Throws if it cannot be opened, has an unknown type, or is shorter than its dimensions say.
+      static std::unique_ptr<IDXFile> open(const std::string& filePath);
+
+      ElementType elementType() const
+      {
+        return this->type;
+      }
+
+      const std::vector<ulong>& dims() const
+      {
+        return this->dimensions;
+      }
+
+      ulong numItems() const
+      {
+        return this->dimensions[0];
+      }
+
+      // Elements per item (product of all dimensions but the first; 1 for a one-dimensional file).
+      ulong itemSize() const
+      {
+        return this->elementsPerItem;
+      }
+
+      ItemView item(ulong index) const
+      {
+        return ItemView(this->payload + index * this->itemStride, this->elementsPerItem, this->type);
+      }
+
+      // Decode item `index` into dst (itemSize() floats), each value multiplied by scale.
+      void readItem(ulong index, float* dst, float scale = 1.0f) const;
+
+      static ulong elementBytes(ElementType type);
+      static bool isIntegerType(ElementType type);
+
+      // Value of one big-endian element.
+      static double decode(const uchar* p, ElementType type);
+
+    private:
+      IDXFile() = default;
+
+      std::string filePath;
+      QFile file;
+      uchar* mapped = nullptr;
+      const uchar* payload = nullptr; // First element of item 0
+      ElementType type = ElementType::UBYTE;
+      std::vector<ulong> dimensions;
+      ulong elementsPerItem = 0;
+      ulong itemStride = 0; // bytes per item
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_IDXFILE_HPP
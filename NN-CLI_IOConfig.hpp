@@ -3,6 +3,8 @@
 
 #include "NN-CLI_DataType.hpp"
 
+#include <string>
+
 #include <sys/types.h>
 
 namespace NN_CLI
@@ -20,6 +22,11 @@ namespace NN_CLI
       // Shape of output images (required when outputType == IMAGE)
       ulong outputC = 0, outputH = 0, outputW = 0;
 
+      // Encoding of output images written by predict: file format and the size/speed trade-off of each
+      std::string outputImageFormat = "png"; // "png", "jpg" or "bmp"
+      int pngCompressionLevel = 8; // Deflate effort (higher = smaller files, slower; values below 5 act as 5)
+      int jpegQuality = 90; // 1-100 (higher = better quality, larger files)
+
       bool hasInputShape() const
       {
         return inputC > 0 && inputH > 0 && inputW > 0;
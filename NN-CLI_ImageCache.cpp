@@ -0,0 +1,142 @@
+#include "NN-CLI_ImageCache.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  ImageCache::ImageCache(size_t budgetBytes, ulong numShards) : budgetBytes(budgetBytes)
+  {
+    numShards = std::max<ulong>(numShards, 1);
+    this->shardBudget = budgetBytes / numShards;
+
+    this->shards.reserve(numShards);
+    for (ulong i = 0; i < numShards; i++)
+      this->shards.push_back(std::make_unique<Shard>());
+  }
+
+  //===================================================================================================================//
+
+  ImageCache::Shard& ImageCache::shardFor(ulong key)
+  {
+    // Fibonacci hashing: keys with a common stride (DataLoader's are 2 * sample + isOutput) still spread over every
+    // shard, and consecutive keys land on different ones
+    ulong mixed = static_cast<ulong>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32);
+    return *this->shards[mixed % this->shards.size()];
+  }
+
+  //===================================================================================================================//
+
+  ImageCache::Pixels ImageCache::find(ulong key)
+  {
+    Shard& shard = this->shardFor(key);
+
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.index.find(key);
+
+      if (it != shard.index.end()) {
+        Slot& slot = shard.slots[it->second];
+        slot.referenced = true;
+        this->hits.fetch_add(1, std::memory_order_relaxed);
+        return slot.pixels;
+      }
+    }
+
+    this->misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  //===================================================================================================================//
+
+  void ImageCache::insert(ulong key, Pixels pixels)
+  {
+    if (!pixels)
+      return;
+
+    size_t size = pixels->size();
+
+    if (size > this->shardBudget)
+      return;
+
+    Shard& shard = this->shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Another thread may have decoded the same image concurrently
+    if (shard.index.count(key) > 0)
+      return;
+
+    while (shard.bytes + size > this->shardBudget)
+      evictOne(shard);
+
+    size_t slotIndex;
+
+    if (!shard.freeSlots.empty()) {
+      slotIndex = shard.freeSlots.back();
+      shard.freeSlots.pop_back();
+    } else {
+      slotIndex = shard.slots.size();
+      shard.slots.emplace_back();
+    }
+
+    // New entries start unreferenced: an image seen once is the first candidate to go
+    Slot& slot = shard.slots[slotIndex];
+    slot.key = key;
+    slot.pixels = std::move(pixels);
+    slot.referenced = false;
+
+    shard.index[key] = slotIndex;
+    shard.bytes += size;
+  }
+
+  //===================================================================================================================//
+
+  void ImageCache::evictOne(Shard& shard)
+  {
+    // Sweep the hand, giving referenced entries a second chance; terminates within two passes
+    while (true) {
+      if (shard.hand >= shard.slots.size())
+        shard.hand = 0;
+
+      Slot& slot = shard.slots[shard.hand];
+      size_t slotIndex = shard.hand++;
+
+      if (!slot.pixels)
+        continue;
+
+      if (slot.referenced) {
+        slot.referenced = false;
+        continue;
+      }
+
+      shard.bytes -= slot.pixels->size();
+      shard.index.erase(slot.key);
+      shard.freeSlots.push_back(slotIndex);
+      slot.pixels.reset();
+      return;
+    }
+  }
+
+  //===================================================================================================================//
+
+  ImageCache::Stats ImageCache::takeStats()
+  {
+    Stats stats;
+    stats.hits = this->hits.exchange(0, std::memory_order_relaxed);
+    stats.misses = this->misses.exchange(0, std::memory_order_relaxed);
+
+    for (const auto& shard : this->shards) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      stats.entries += shard->index.size();
+      stats.bytes += shard->bytes;
+    }
+
+    return stats;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,97 @@
+#ifndef NN_CLI_IMAGECACHE_HPP
+#define NN_CLI_IMAGECACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  using ulong = unsigned long;
+
+  /**
+ * ImageCache: decoded, resized images kept in memory across epochs, bounded by a byte budget.
+ *
+ * Entries are interleaved HWC uint8 (as decoded), 4x smaller than the NCHW float samples built from them.
+ * Keys are split over independently locked shards so the I/O threads rarely contend; each shard evicts with the
+ * CLOCK algorithm (an approximation of LRU that only needs a "referenced" bit per entry).
+ * Entries are shared pointers, so an evicted image stays valid for any thread still converting it.
+ */
+  class ImageCache
+  {
+    public:
+      using Pixels = std::shared_ptr<const std::vector<unsigned char>>;
+
+      struct Stats {
+          ulong hits = 0;
+          ulong misses = 0;
+          ulong entries = 0;
+          size_t bytes = 0;
+
+          double hitRate() const
+          {
+            ulong lookups = this->hits + this->misses;
+            return (lookups > 0) ? static_cast<double>(this->hits) / lookups : 0.0;
+          }
+      };
+
+      explicit ImageCache(size_t budgetBytes, ulong numShards = 16);
+
+      ImageCache(const ImageCache&) = delete;
+      ImageCache& operator=(const ImageCache&) = delete;
+
+      // Cached pixels for key, or nullptr (counted as a miss).
+      Pixels find(ulong key);
+
+      // Store pixels for key, evicting other entries of the same shard if needed.
+      // Images larger than a shard's share of the budget are not cached.
+      void insert(ulong key, Pixels pixels);
+
+      // Hit/miss counters since the previous call (they are reset), plus current occupancy.
+      Stats takeStats();
+
+      size_t budget() const
+      {
+        return this->budgetBytes;
+      }
+
+    private:
+      struct Slot {
+          ulong key = 0;
+          Pixels pixels; // nullptr = free slot
+          bool referenced = false;
+      };
+
+      struct Shard {
+          std::mutex mutex;
+          std::unordered_map<ulong, size_t> index; // key -> slot
+          std::vector<Slot> slots;
+          std::vector<size_t> freeSlots;
+          size_t hand = 0; // CLOCK hand
+          size_t bytes = 0;
+      };
+
+      Shard& shardFor(ulong key);
+
+      // Evict one entry from the shard (caller holds its lock and the shard is not empty).
+      static void evictOne(Shard& shard);
+
+      size_t budgetBytes;
+      size_t shardBudget;
+      std::vector<std::unique_ptr<Shard>> shards;
+
+      std::atomic<ulong> hits{0};
+      std::atomic<ulong> misses{0};
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_IMAGECACHE_HPP
@@ -0,0 +1,414 @@
+#include "NN-CLI_ImageDecoder.hpp"
+#include "NN-CLI_ScratchArena.hpp"
+
+// Declarations only: the implementation (with the ScratchArena allocation hooks) is compiled in ImageLoader.cpp
+#include <stb_image.h>
+
+#include <cstdio>
+
+#ifdef NN_CLI_WITH_LIBJPEG
+extern "C" {
+#include <jpeglib.h>
+}
+#endif
+
+#ifdef NN_CLI_WITH_LIBPNG
+#include <png.h>
+#endif
+
+#include <csetjmp>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  namespace
+  {
+#ifdef NN_CLI_WITH_LIBJPEG
+    constexpr bool hasLibjpeg = true;
+#else
+    constexpr bool hasLibjpeg = false;
+#endif
+
+#ifdef NN_CLI_WITH_LIBPNG
+    constexpr bool hasLibpng = true;
+#else
+    constexpr bool hasLibpng = false;
+#endif
+
+    constexpr unsigned char jpegSignature[] = {0xFF, 0xD8, 0xFF};
+    constexpr unsigned char pngSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    using File = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+    std::runtime_error decodeError(const std::string& imagePath, const std::string& reason)
+    {
+      return std::runtime_error("Failed to load image: " + imagePath + " (" + reason + ")");
+    }
+
+    File openImage(const std::string& imagePath)
+    {
+      File file(std::fopen(imagePath.c_str(), "rb"), std::fclose);
+
+      if (!file)
+        throw decodeError(imagePath, "can't fopen");
+
+      return file;
+    }
+
+    // Reads the signature and rewinds, so the backend starts from the first byte
+    ImageDecoder::Backend selectBackend(std::FILE* file, int targetC)
+    {
+      unsigned char signature[sizeof(pngSignature)] = {};
+      size_t size = std::fread(signature, 1, sizeof(signature), file);
+      std::rewind(file);
+
+      if (targetC < 1 || targetC > 4)
+        return ImageDecoder::Backend::STB;
+
+      if (hasLibjpeg && size >= sizeof(jpegSignature) &&
+          std::memcmp(signature, jpegSignature, sizeof(jpegSignature)) == 0)
+        return ImageDecoder::Backend::LIBJPEG;
+
+      if (hasLibpng && size >= sizeof(pngSignature) && std::memcmp(signature, pngSignature, sizeof(pngSignature)) == 0)
+        return ImageDecoder::Backend::LIBPNG;
+
+      return ImageDecoder::Backend::STB;
+    }
+
+    //-- stb (every format stb_image reads) --//
+
+    ImageDecoder::Image decodeStb(std::FILE* file, const std::string& imagePath, int targetC)
+    {
+      ImageDecoder::Image image;
+      int channels = 0;
+      image.pixels = stbi_load_from_file(file, &image.width, &image.height, &channels, targetC);
+
+      if (!image.pixels)
+        throw decodeError(imagePath, stbi_failure_reason());
+
+      return image;
+    }
+
+#ifdef NN_CLI_WITH_LIBJPEG
+
+    //-- libjpeg --//
+
+    struct JpegError {
+        jpeg_error_mgr manager; // First, so the jpeg_error_mgr* libjpeg hands back also points to this
+        std::jmp_buf jump;
+        char message[JMSG_LENGTH_MAX] = "";
+    };
+
+    void jpegErrorExit(j_common_ptr info)
+    {
+      JpegError* error = reinterpret_cast<JpegError*>(info->err);
+      error->manager.format_message(info, error->message);
+      std::longjmp(error->jump, 1);
+    }
+
+    // Warnings about recoverable data errors, which stb does not report either
+    void jpegIgnoreMessage(j_common_ptr) {}
+
+    // Widen a row of grey (from = 1) or RGB (from = 3) pixels to `to` channels in place, as stbi_load converts:
+    // grey is replicated and alpha is opaque
+    void expandRow(unsigned char* row, int width, int from, int to)
+    {
+      if (from == to)
+        return;
+
+      for (int x = width - 1; x >= 0; x--) {
+        const unsigned char* in = row + static_cast<size_t>(x) * from;
+        unsigned char* out = row + static_cast<size_t>(x) * to;
+        unsigned char r = in[0], g = in[from == 3 ? 1 : 0], b = in[from == 3 ? 2 : 0];
+        out[0] = r;
+
+        if (to >= 3) {
+          out[1] = g;
+          out[2] = b;
+        }
+
+        if (to % 2 == 0)
+          out[to - 1] = 255;
+      }
+    }
+
+    // Returns false, having allocated nothing, for CMYK/YCCK files (stb converts those, libjpeg cannot)
+    bool decodeJpeg(std::FILE* file, const std::string& imagePath, int targetC, int targetH, int targetW,
+                    ImageDecoder::Image& image)
+    {
+      jpeg_decompress_struct info;
+      JpegError error;
+      info.err = jpeg_std_error(&error.manager);
+      error.manager.error_exit = jpegErrorExit;
+      error.manager.output_message = jpegIgnoreMessage;
+      unsigned char* volatile pixels = nullptr;
+
+      if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&info);
+        ScratchArena::release(pixels);
+        throw decodeError(imagePath, error.message);
+      }
+
+      jpeg_create_decompress(&info);
+      jpeg_stdio_src(&info, file);
+      jpeg_read_header(&info, TRUE);
+
+      if (info.jpeg_color_space == JCS_CMYK || info.jpeg_color_space == JCS_YCCK) {
+        jpeg_destroy_decompress(&info);
+        return false;
+      }
+
+      info.out_color_space = (targetC <= 2 || info.jpeg_color_space == JCS_GRAYSCALE) ? JCS_GRAYSCALE : JCS_RGB;
+
+      // Decode at the smallest of 1/8, 1/4 and 1/2 scale that still covers the target, so resizing only shrinks
+      info.scale_num = 1;
+
+      for (unsigned int denom : {8u, 4u, 2u, 1u}) {
+        info.scale_denom = denom;
+        jpeg_calc_output_dimensions(&info);
+
+        if (info.output_width >= static_cast<JDIMENSION>(targetW) &&
+            info.output_height >= static_cast<JDIMENSION>(targetH))
+          break;
+      }
+
+      jpeg_start_decompress(&info);
+
+      int width = static_cast<int>(info.output_width);
+      int height = static_cast<int>(info.output_height);
+      size_t rowSize = static_cast<size_t>(width) * targetC;
+      pixels = static_cast<unsigned char*>(ScratchArena::allocate(rowSize * height));
+
+      if (!pixels) {
+        jpeg_destroy_decompress(&info);
+        throw std::bad_alloc();
+      }
+
+      while (info.output_scanline < info.output_height) {
+        JSAMPROW row = pixels + info.output_scanline * rowSize;
+        jpeg_read_scanlines(&info, &row, 1);
+        expandRow(row, width, info.output_components, targetC);
+      }
+
+      jpeg_finish_decompress(&info);
+      jpeg_destroy_decompress(&info);
+
+      image.pixels = pixels;
+      image.width = width;
+      image.height = height;
+      return true;
+    }
+
+#endif // NN_CLI_WITH_LIBJPEG
+
+#ifdef NN_CLI_WITH_LIBPNG
+
+    //-- libpng --//
+
+    struct PngError {
+        char message[256] = "";
+    };
+
+    void pngErrorExit(png_structp png, png_const_charp message)
+    {
+      PngError* error = static_cast<PngError*>(png_get_error_ptr(png));
+      std::snprintf(error->message, sizeof(error->message), "%s", message);
+      png_longjmp(png, 1);
+    }
+
+    void pngIgnoreWarning(png_structp, png_const_charp) {}
+
+    // libpng's own buffers (including zlib's window) come from the scratch arena too
+    png_voidp pngAllocate(png_structp, png_alloc_size_t size)
+    {
+      return ScratchArena::allocate(size);
+    }
+
+    void pngRelease(png_structp, png_voidp pointer)
+    {
+      ScratchArena::release(pointer);
+    }
+
+    void decodePng(std::FILE* file, const std::string& imagePath, int targetC, ImageDecoder::Image& image)
+    {
+      PngError error;
+      png_structp png = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, &error, pngErrorExit, pngIgnoreWarning,
+                                                 nullptr, pngAllocate, pngRelease);
+      png_infop info = png ? png_create_info_struct(png) : nullptr;
+
+      if (!info) {
+        png_destroy_read_struct(&png, nullptr, nullptr);
+        throw std::bad_alloc();
+      }
+
+      unsigned char* volatile pixels = nullptr;
+      png_bytep* volatile rows = nullptr;
+
+      if (setjmp(png_jmpbuf(png))) {
+        png_destroy_read_struct(&png, &info, nullptr);
+        ScratchArena::release(rows);
+        ScratchArena::release(pixels);
+        throw decodeError(imagePath, error.message);
+      }
+
+      png_init_io(png, file);
+      png_read_info(png, info);
+
+      int colorType = png_get_color_type(png, info);
+      bool grey = !(colorType & PNG_COLOR_MASK_COLOR);
+      bool alpha = (colorType & PNG_COLOR_MASK_ALPHA) || png_get_valid(png, info, PNG_INFO_tRNS);
+
+      // The conversions stbi_load makes: 16-bit samples keep their high byte, palettes and low bit depths expand to
+      // 8 bits, transparency becomes alpha, and colour turns grey with stb's (Rec. 601) luma weights
+      png_set_strip_16(png);
+      png_set_expand(png);
+
+      if (grey && targetC >= 3)
+        png_set_gray_to_rgb(png);
+      else if (!grey && targetC <= 2)
+        png_set_rgb_to_gray_fixed(png, 1, 29900, 58700);
+
+      if (alpha && targetC % 2 == 1)
+        png_set_strip_alpha(png);
+      else if (!alpha && targetC % 2 == 0)
+        png_set_add_alpha(png, 0xFF, PNG_FILLER_AFTER);
+
+      png_set_interlace_handling(png);
+      png_read_update_info(png, info);
+
+      png_uint_32 width = png_get_image_width(png, info);
+      png_uint_32 height = png_get_image_height(png, info);
+      size_t rowSize = static_cast<size_t>(width) * targetC;
+
+      if (png_get_rowbytes(png, info) != rowSize)
+        png_error(png, "unsupported pixel format");
+
+      pixels = static_cast<unsigned char*>(ScratchArena::allocate(rowSize * height));
+      rows = static_cast<png_bytep*>(ScratchArena::allocate(sizeof(png_bytep) * height));
+
+      if (!pixels || !rows)
+        png_error(png, "out of memory");
+
+      for (png_uint_32 y = 0; y < height; y++)
+        rows[y] = pixels + y * rowSize;
+
+      png_read_image(png, rows);
+      png_read_end(png, nullptr);
+      png_destroy_read_struct(&png, &info, nullptr);
+      ScratchArena::release(rows);
+
+      image.pixels = pixels;
+      image.width = static_cast<int>(width);
+      image.height = static_cast<int>(height);
+    }
+
+#endif // NN_CLI_WITH_LIBPNG
+  }
+
+  //===================================================================================================================//
+
+  bool ImageDecoder::available(Backend backend)
+  {
+    switch (backend) {
+      case Backend::LIBJPEG:
+        return hasLibjpeg;
+      case Backend::LIBPNG:
+        return hasLibpng;
+      default:
+        return true;
+    }
+  }
+
+  //===================================================================================================================//
+
+  std::string ImageDecoder::backendName(Backend backend)
+  {
+    switch (backend) {
+      case Backend::LIBJPEG:
+        return "libjpeg";
+      case Backend::LIBPNG:
+        return "libpng";
+      default:
+        return "stb";
+    }
+  }
+
+  //===================================================================================================================//
+
+  ImageDecoder::Backend ImageDecoder::select(const std::string& imagePath, int targetC)
+  {
+    File file = openImage(imagePath);
+    return selectBackend(file.get(), targetC);
+  }
+
+  //===================================================================================================================//
+
+  ImageDecoder::Image ImageDecoder::decode(const std::string& imagePath, int targetC, int targetH, int targetW)
+  {
+    File file = openImage(imagePath);
+    Backend backend = selectBackend(file.get(), targetC);
+    Image image;
+
+#ifdef NN_CLI_WITH_LIBJPEG
+    if (backend == Backend::LIBJPEG) {
+      if (decodeJpeg(file.get(), imagePath, targetC, targetH, targetW, image))
+        return image;
+
+      std::rewind(file.get());
+    }
+#endif
+
+#ifdef NN_CLI_WITH_LIBPNG
+    if (backend == Backend::LIBPNG) {
+      decodePng(file.get(), imagePath, targetC, image);
+      return image;
+    }
+#endif
+
+    (void)backend;
+    (void)targetH;
+    (void)targetW;
+    return decodeStb(file.get(), imagePath, targetC);
+  }
+
+  //===================================================================================================================//
+
+  ImageDecoder::Image ImageDecoder::decode(const std::string& imagePath, int targetC, int targetH, int targetW,
+                                           Backend backend)
+  {
+    if (!available(backend))
+      throw std::runtime_error("Image decoder " + backendName(backend) + " is not compiled in");
+
+    File file = openImage(imagePath);
+    Image image;
+
+#ifdef NN_CLI_WITH_LIBJPEG
+    if (backend == Backend::LIBJPEG) {
+      if (!decodeJpeg(file.get(), imagePath, targetC, targetH, targetW, image))
+        throw decodeError(imagePath, "libjpeg does not convert CMYK to RGB");
+
+      return image;
+    }
+#endif
+
+#ifdef NN_CLI_WITH_LIBPNG
+    if (backend == Backend::LIBPNG) {
+      decodePng(file.get(), imagePath, targetC, image);
+      return image;
+    }
+#endif
+
+    (void)targetH;
+    (void)targetW;
+    return decodeStb(file.get(), imagePath, targetC);
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
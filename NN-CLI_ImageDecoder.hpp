@@ -0,0 +1,49 @@
+#ifndef NN_CLI_IMAGEDECODER_HPP
+#define NN_CLI_IMAGEDECODER_HPP
+
+#include <string>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * ImageDecoder: decodes image files into interleaved 8-bit pixels for ImageLoader, with the best backend for each file.
+ *
+ * JPEGs are decoded with libjpeg (libjpeg-turbo) and PNGs with libpng when CMake found them (NN_CLI_WITH_LIBJPEG,
+ * NN_CLI_WITH_LIBPNG); everything else, and everything when they are missing, is decoded with stb. libjpeg scales
+ * down by 1/2, 1/4 or 1/8 while decoding (in the DCT domain) as far as the target size allows, so a large photo
+ * resized to a small input is never decoded at full resolution.
+ *
+ * The decoded pixels are allocated from the calling thread's ScratchArena and released with ScratchArena::release.
+ */
+  class ImageDecoder
+  {
+    public:
+      enum class Backend { STB, LIBJPEG, LIBPNG };
+
+      struct Image {
+          unsigned char* pixels = nullptr; // width * height * targetC bytes, interleaved
+          int width = 0;
+          int height = 0;
+      };
+
+      // Whether a backend was compiled in (stb always is)
+      static bool available(Backend backend);
+      static std::string backendName(Backend backend);
+
+      // Backend that decode() uses for a file, chosen from its first bytes
+      static Backend select(const std::string& imagePath, int targetC);
+
+      // Decode an image with targetC channels (1, 2, 3 or 4, as stbi_load). The result is at least targetW x targetH
+      // wherever the image itself is, and may be larger: the caller resizes it. Throws std::runtime_error on failure.
+      static Image decode(const std::string& imagePath, int targetC, int targetH, int targetW);
+      static Image decode(const std::string& imagePath, int targetC, int targetH, int targetW, Backend backend);
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_IMAGEDECODER_HPP
@@ -1,4 +1,14 @@
 #include "NN-CLI_ImageLoader.hpp"
+#include "NN-CLI_ImageDecoder.hpp"
+#include "NN-CLI_PixelKernels.hpp"
+#include "NN-CLI_ScratchArena.hpp"
+
+// stb's decode and resize buffers come from the calling thread's scratch arena
+#define STBI_MALLOC(size) NN_CLI::ScratchArena::allocate(size)
+#define STBI_REALLOC_SIZED(pointer, oldSize, newSize) NN_CLI::ScratchArena::reallocate(pointer, oldSize, newSize)
+#define STBI_FREE(pointer) NN_CLI::ScratchArena::release(pointer)
+#define STBIR_MALLOC(size, userData) ((void)(userData), NN_CLI::ScratchArena::allocate(size))
+#define STBIR_FREE(pointer, userData) ((void)(userData), NN_CLI::ScratchArena::release(pointer))
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -14,6 +24,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <numeric>
 #include <stdexcept>
 
@@ -24,20 +37,49 @@ namespace NN_CLI
 
   std::vector<float> ImageLoader::loadImage(const std::string& imagePath, int targetC, int targetH, int targetW)
   {
-    int origW = 0, origH = 0, origC = 0;
-    unsigned char* pixels = stbi_load(imagePath.c_str(), &origW, &origH, &origC, targetC);
+    std::vector<float> result(static_cast<size_t>(targetC) * targetH * targetW);
+    loadImage(imagePath, targetC, targetH, targetW, result.data());
+    return result;
+  }
 
-    if (!pixels) {
-      throw std::runtime_error("Failed to load image: " + imagePath + " (" + stbi_failure_reason() + ")");
-    }
+  //===================================================================================================================//
 
-    // Resize if the loaded image doesn't match target dimensions
-    std::vector<unsigned char> resizedBuf;
-    unsigned char* source = pixels;
+  void ImageLoader::loadImage(const std::string& imagePath, int targetC, int targetH, int targetW, float* data)
+  {
+    ScratchArena::Scope scratch;
+    size_t size = static_cast<size_t>(targetC) * targetH * targetW;
+    std::unique_ptr<unsigned char, void (*)(void*)> pixels(static_cast<unsigned char*>(ScratchArena::allocate(size)),
+                                                           ScratchArena::release);
 
-    if (origW != targetW || origH != targetH) {
-      resizedBuf.resize(static_cast<size_t>(targetW) * targetH * targetC);
+    if (!pixels)
+      throw std::bad_alloc();
+
+    decodeImage(imagePath, targetC, targetH, targetW, pixels.get());
+    toNCHW(pixels.get(), targetC, targetH, targetW, data);
+  }
+
+  //===================================================================================================================//
 
+  std::vector<unsigned char> ImageLoader::decodeImage(const std::string& imagePath, int targetC, int targetH,
+                                                      int targetW)
+  {
+    std::vector<unsigned char> result(static_cast<size_t>(targetW) * targetH * targetC);
+    decodeImage(imagePath, targetC, targetH, targetW, result.data());
+    return result;
+  }
+
+  //===================================================================================================================//
+
+  void ImageLoader::decodeImage(const std::string& imagePath, int targetC, int targetH, int targetW,
+                                unsigned char* pixels)
+  {
+    ScratchArena::Scope scratch;
+    ImageDecoder::Image image = ImageDecoder::decode(imagePath, targetC, targetH, targetW);
+    std::unique_ptr<unsigned char, void (*)(void*)> decoded(image.pixels, ScratchArena::release);
+    int origW = image.width, origH = image.height;
+
+    // Resize if the loaded image doesn't match target dimensions
+    if (origW != targetW || origH != targetH) {
       stbir_pixel_layout layout;
 
       if (targetC == 1)
@@ -49,44 +91,38 @@ namespace NN_CLI
       else
         layout = STBIR_1CHANNEL; // fallback
 
-      stbir_resize_uint8_linear(pixels, origW, origH, 0, resizedBuf.data(), targetW, targetH, 0, layout);
-      source = resizedBuf.data();
+      stbir_resize_uint8_linear(decoded.get(), origW, origH, 0, pixels, targetW, targetH, 0, layout);
+    } else {
+      std::memcpy(pixels, decoded.get(), static_cast<size_t>(targetW) * targetH * targetC);
     }
+  }
+
+  //===================================================================================================================//
 
-    // Convert to flat NCHW float vector, normalised to [0, 1]
+  std::vector<float> ImageLoader::toNCHW(const unsigned char* pixels, int targetC, int targetH, int targetW)
+  {
     std::vector<float> result(static_cast<size_t>(targetC) * targetH * targetW);
+    toNCHW(pixels, targetC, targetH, targetW, result.data());
+    return result;
+  }
 
-    for (int c = 0; c < targetC; ++c) {
-      for (int h = 0; h < targetH; ++h) {
-        for (int w = 0; w < targetW; ++w) {
-          // stb_image stores as interleaved HWC: pixel[h * W * C + w * C + c]
-          float val = static_cast<float>(source[h * targetW * targetC + w * targetC + c]) / 255.0f;
-          // NCHW layout: data[c * H * W + h * W + w]
-          result[c * targetH * targetW + h * targetW + w] = val;
-        }
-      }
-    }
+  //===================================================================================================================//
 
-    stbi_image_free(pixels);
-    return result;
+  void ImageLoader::toNCHW(const unsigned char* pixels, int targetC, int targetH, int targetW, float* data)
+  {
+    // stb_image stores interleaved HWC: pixels[(h * W + w) * C + c]; NCHW layout: data[c * H * W + h * W + w]
+    PixelKernels::hwcToNCHW(pixels, data, targetC, static_cast<size_t>(targetH) * targetW);
   }
 
   //===================================================================================================================//
 
-  void ImageLoader::saveImage(const std::string& imagePath, const std::vector<float>& data, int c, int h, int w)
+  void ImageLoader::saveImage(const std::string& imagePath, const std::vector<float>& data, int c, int h, int w,
+                              int jpegQuality)
   {
     // Convert from NCHW float [0,1] to interleaved HWC uint8 [0,255]
-    std::vector<unsigned char> pixels(static_cast<size_t>(c) * h * w);
-
-    for (int ch = 0; ch < c; ++ch) {
-      for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-          float val = data[ch * h * w + y * w + x];
-          val = std::max(0.0f, std::min(1.0f, val));
-          pixels[y * w * c + x * c + ch] = static_cast<unsigned char>(val * 255.0f + 0.5f);
-        }
-      }
-    }
+    size_t planeSize = static_cast<size_t>(h) * w;
+    std::vector<unsigned char> pixels(static_cast<size_t>(c) * planeSize);
+    PixelKernels::nchwToHWC(data.data(), pixels.data(), c, planeSize);
 
     // Determine format from extension
     std::string ext;
@@ -100,7 +136,7 @@ namespace NN_CLI
     int result = 0;
 
     if (ext == ".jpg" || ext == ".jpeg") {
-      result = stbi_write_jpg(imagePath.c_str(), w, h, c, pixels.data(), 90);
+      result = stbi_write_jpg(imagePath.c_str(), w, h, c, pixels.data(), jpegQuality);
     } else if (ext == ".bmp") {
       result = stbi_write_bmp(imagePath.c_str(), w, h, c, pixels.data());
     } else {
@@ -115,6 +151,13 @@ namespace NN_CLI
 
   //===================================================================================================================//
 
+  void ImageLoader::setPngCompressionLevel(int level)
+  {
+    stbi_write_png_compression_level = std::max(0, level);
+  }
+
+  //===================================================================================================================//
+
   std::string ImageLoader::resolvePath(const std::string& imagePath, const std::string& baseDirPath)
   {
     QFileInfo fileInfo(QString::fromStdString(imagePath));
@@ -131,6 +174,20 @@ namespace NN_CLI
   //-- Data augmentation transforms --//
   //===================================================================================================================//
 
+  namespace
+  {
+    // This thread's spare image buffer. A transform that cannot work in place writes into it and swaps it with the
+    // caller's buffer, so the two ping-pong and neither is reallocated once both fit the image.
+    std::vector<float>& spareBuffer(size_t size)
+    {
+      thread_local std::vector<float> spare;
+      spare.resize(size);
+      return spare;
+    }
+  }
+
+  //===================================================================================================================//
+
   void ImageLoader::horizontalFlip(std::vector<float>& data, int c, int h, int w)
   {
     for (int ch = 0; ch < c; ch++) {
@@ -145,7 +202,8 @@ namespace NN_CLI
 
   //===================================================================================================================//
 
-  void ImageLoader::randomRotation(std::vector<float>& data, int c, int h, int w, float maxDegrees, std::mt19937& rng)
+  void ImageLoader::randomRotation(std::vector<float>& data, int c, int h, int w, float maxDegrees,
+                                   AugmentationRNG& rng)
   {
     std::uniform_real_distribution<float> dist(-maxDegrees, maxDegrees);
     float angle = dist(rng) * static_cast<float>(M_PI) / 180.0f;
@@ -154,7 +212,7 @@ namespace NN_CLI
     float cx = static_cast<float>(w) / 2.0f;
     float cy = static_cast<float>(h) / 2.0f;
 
-    std::vector<float> result(data.size(), 0.0f);
+    std::vector<float>& result = spareBuffer(data.size());
 
     for (int ch = 0; ch < c; ch++) {
       int chOffset = ch * h * w;
@@ -184,13 +242,13 @@ namespace NN_CLI
       }
     }
 
-    data = std::move(result);
+    data.swap(result);
   }
 
   //===================================================================================================================//
 
   void ImageLoader::randomBrightness(std::vector<float>& data, int /*c*/, int /*h*/, int /*w*/, float maxDelta,
-                                     std::mt19937& rng)
+                                     AugmentationRNG& rng)
   {
     std::uniform_real_distribution<float> dist(-maxDelta, maxDelta);
     float delta = dist(rng);
@@ -202,7 +260,7 @@ namespace NN_CLI
   //===================================================================================================================//
 
   void ImageLoader::randomContrast(std::vector<float>& data, int c, int h, int w, float minFactor, float maxFactor,
-                                   std::mt19937& rng)
+                                   AugmentationRNG& rng)
   {
     std::uniform_real_distribution<float> dist(minFactor, maxFactor);
     float factor = dist(rng);
@@ -224,7 +282,7 @@ namespace NN_CLI
   //===================================================================================================================//
 
   void ImageLoader::randomTranslation(std::vector<float>& data, int c, int h, int w, float maxFraction,
-                                      std::mt19937& rng)
+                                      AugmentationRNG& rng)
   {
     int maxDx = static_cast<int>(maxFraction * w);
     int maxDy = static_cast<int>(maxFraction * h);
@@ -237,7 +295,9 @@ namespace NN_CLI
     int dx = distX(rng);
     int dy = distY(rng);
 
-    std::vector<float> result(data.size(), 0.0f);
+    std::vector<float>& result = spareBuffer(data.size());
+    std::fill(result.begin(), result.end(), 0.0f);
+
     for (int ch = 0; ch < c; ch++) {
       int chOffset = ch * h * w;
       for (int y = 0; y < h; y++) {
@@ -255,12 +315,12 @@ namespace NN_CLI
       }
     }
 
-    data = std::move(result);
+    data.swap(result);
   }
 
   //===================================================================================================================//
 
-  void ImageLoader::addGaussianNoise(std::vector<float>& data, float stddev, std::mt19937& rng)
+  void ImageLoader::addGaussianNoise(std::vector<float>& data, float stddev, AugmentationRNG& rng)
   {
     std::normal_distribution<float> dist(0.0f, stddev);
     for (auto& v : data) {
@@ -270,37 +330,177 @@ namespace NN_CLI
 
   //===================================================================================================================//
 
-  void ImageLoader::applyRandomTransforms(std::vector<float>& data, int c, int h, int w, std::mt19937& rng,
+  void ImageLoader::applyRandomTransforms(std::vector<float>& data, int c, int h, int w, AugmentationRNG& rng,
                                           const Loader::AugmentationTransforms& transforms, float probability)
   {
     std::bernoulli_distribution coin(probability);
 
-    // Horizontal flip
-    if (transforms.horizontalFlip && coin(rng))
-      horizontalFlip(data, c, h, w);
+    // Draw every parameter up front, in the order the individual transforms would draw them
+    bool flip = transforms.horizontalFlip && coin(rng);
+
+    float angle = 0.0f;
+    bool rotate = transforms.rotation > 0.0f && coin(rng);
 
-    // Random rotation (max degrees from config, 0 = disabled)
-    if (transforms.rotation > 0.0f && coin(rng))
-      randomRotation(data, c, h, w, transforms.rotation, rng);
+    if (rotate) {
+      std::uniform_real_distribution<float> dist(-transforms.rotation, transforms.rotation);
+      angle = dist(rng) * static_cast<float>(M_PI) / 180.0f;
+    }
+
+    int dx = 0, dy = 0;
+
+    if (transforms.translation > 0.0f && coin(rng)) {
+      int maxDx = static_cast<int>(transforms.translation * w);
+      int maxDy = static_cast<int>(transforms.translation * h);
+
+      if (maxDx != 0 || maxDy != 0) {
+        std::uniform_int_distribution<int> distX(-maxDx, maxDx);
+        std::uniform_int_distribution<int> distY(-maxDy, maxDy);
+        dx = distX(rng);
+        dy = distY(rng);
+      }
+    }
+
+    float delta = 0.0f;
+    bool brighten = transforms.brightness > 0.0f && coin(rng);
+
+    if (brighten) {
+      std::uniform_real_distribution<float> dist(-transforms.brightness, transforms.brightness);
+      delta = dist(rng);
+    }
+
+    float factor = 1.0f;
+    bool contrast = transforms.contrast > 0.0f && coin(rng);
+
+    if (contrast) {
+      std::uniform_real_distribution<float> dist(1.0f - transforms.contrast, 1.0f + transforms.contrast);
+      factor = dist(rng);
+    }
+
+    bool noise = transforms.gaussianNoise > 0.0f && coin(rng);
+    std::normal_distribution<float> noiseDist(0.0f, noise ? transforms.gaussianNoise : 1.0f);
+
+    bool warp = flip || rotate || dx != 0 || dy != 0;
+
+    if (!warp && !brighten && !contrast && !noise)
+      return;
+
+    // Contrast needs each channel's mean of the finished pixels, so it gets a second, in-place pass. Noise must be
+    // drawn channel by channel, as addGaussianNoise draws it, but the warp writes pixel by pixel: after a warp or
+    // contrast it goes in that second pass too. Otherwise brightness and noise are applied as each pixel is written.
+    bool noiseLast = noise && (warp || contrast);
+    bool secondPass = contrast || noiseLast;
+    int planeSize = h * w;
+
+    thread_local std::vector<float> channelSums;
+    channelSums.assign(c, 0.0f);
+
+    auto finish = [&](float value, int ch) {
+      if (brighten)
+        value = std::clamp(value + delta, 0.0f, 1.0f);
+
+      if (contrast)
+        channelSums[ch] += value;
+      else if (noise && !noiseLast)
+        value = std::clamp(value + noiseDist(rng), 0.0f, 1.0f);
+
+      return value;
+    };
+
+    if (!warp) {
+      for (int ch = 0; ch < c; ch++) {
+        float* plane = data.data() + static_cast<size_t>(ch) * planeSize;
+
+        for (int i = 0; i < planeSize; i++)
+          plane[i] = finish(plane[i], ch);
+      }
+    } else {
+      // Flip, rotation and translation as one inverse mapping: each output pixel's source position is computed once
+      // and sampled for every channel. Translation moves the rotated image, rotation turns the flipped one about the
+      // centre, and a flip is a reflection of the source x coordinate.
+      std::vector<float>& warped = spareBuffer(data.size());
+
+      const float* source = data.data();
+      float* target = warped.data();
+      float cosA = std::cos(angle);
+      float sinA = std::sin(angle);
+      float cx = static_cast<float>(w) / 2.0f;
+      float cy = static_cast<float>(h) / 2.0f;
+
+      for (int y = 0; y < h; y++) {
+        int v = y - dy;
+
+        for (int x = 0; x < w; x++) {
+          int u = x - dx;
+          int pixel = y * w + x;
+
+          // Translated in from outside the image
+          if (u < 0 || u >= w || v < 0 || v >= h) {
+            for (int ch = 0; ch < c; ch++)
+              target[ch * planeSize + pixel] = finish(0.0f, ch);
+
+            continue;
+          }
+
+          if (!rotate) {
+            int sourcePixel = v * w + (flip ? w - 1 - u : u);
 
-    // Random translation (max fraction from config, 0 = disabled)
-    if (transforms.translation > 0.0f && coin(rng))
-      randomTranslation(data, c, h, w, transforms.translation, rng);
+            for (int ch = 0; ch < c; ch++)
+              target[ch * planeSize + pixel] = finish(source[ch * planeSize + sourcePixel], ch);
+
+            continue;
+          }
+
+          float srcX = cosA * (u - cx) + sinA * (v - cy) + cx;
+          float srcY = -sinA * (u - cx) + cosA * (v - cy) + cy;
+
+          if (flip)
+            srcX = static_cast<float>(w - 1) - srcX;
+
+          // Bilinear taps; a tap outside the image contributes nothing
+          int x0 = static_cast<int>(std::floor(srcX));
+          int y0 = static_cast<int>(std::floor(srcY));
+          float fx = srcX - x0;
+          float fy = srcY - y0;
 
-    // Random brightness (max delta from config, 0 = disabled)
-    if (transforms.brightness > 0.0f && coin(rng))
-      randomBrightness(data, c, h, w, transforms.brightness, rng);
+          bool inX0 = x0 >= 0 && x0 < w, inX1 = x0 + 1 >= 0 && x0 + 1 < w;
+          bool inY0 = y0 >= 0 && y0 < h, inY1 = y0 + 1 >= 0 && y0 + 1 < h;
+          float w00 = (inX0 && inY0) ? (1 - fx) * (1 - fy) : 0.0f;
+          float w10 = (inX1 && inY0) ? fx * (1 - fy) : 0.0f;
+          float w01 = (inX0 && inY1) ? (1 - fx) * fy : 0.0f;
+          float w11 = (inX1 && inY1) ? fx * fy : 0.0f;
+          int o00 = (w00 != 0.0f) ? y0 * w + x0 : 0;
+          int o10 = (w10 != 0.0f) ? y0 * w + x0 + 1 : 0;
+          int o01 = (w01 != 0.0f) ? (y0 + 1) * w + x0 : 0;
+          int o11 = (w11 != 0.0f) ? (y0 + 1) * w + x0 + 1 : 0;
+
+          for (int ch = 0; ch < c; ch++) {
+            const float* plane = source + ch * planeSize;
+            float value = w00 * plane[o00] + w10 * plane[o10] + w01 * plane[o01] + w11 * plane[o11];
+            target[ch * planeSize + pixel] = finish(value, ch);
+          }
+        }
+      }
 
-    // Random contrast (delta from 1.0 from config, 0 = disabled)
-    if (transforms.contrast > 0.0f && coin(rng)) {
-      float minFactor = 1.0f - transforms.contrast;
-      float maxFactor = 1.0f + transforms.contrast;
-      randomContrast(data, c, h, w, minFactor, maxFactor, rng);
+      // The caller's buffer becomes this thread's scratch for the next sample
+      data.swap(warped);
     }
 
-    // Gaussian noise (stddev from config, 0 = disabled)
-    if (transforms.gaussianNoise > 0.0f && coin(rng))
-      addGaussianNoise(data, transforms.gaussianNoise, rng);
+    if (!secondPass)
+      return;
+
+    for (int ch = 0; ch < c; ch++) {
+      float* plane = data.data() + static_cast<size_t>(ch) * planeSize;
+      float mean = channelSums[ch] / static_cast<float>(planeSize);
+
+      for (int i = 0; i < planeSize; i++) {
+        float value = contrast ? std::clamp(mean + factor * (plane[i] - mean), 0.0f, 1.0f) : plane[i];
+
+        if (noiseLast)
+          value = std::clamp(value + noiseDist(rng), 0.0f, 1.0f);
+
+        plane[i] = value;
+      }
+    }
   }
 
   //===================================================================================================================//
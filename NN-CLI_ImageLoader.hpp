@@ -1,6 +1,7 @@
 #ifndef NN_CLI_IMAGELOADER_HPP
 #define NN_CLI_IMAGELOADER_HPP
 
+#include "NN-CLI_AugmentationRNG.hpp"
 #include "NN-CLI_Loader.hpp"
 
 #include <random>
@@ -29,9 +30,30 @@ namespace NN_CLI
       // targetH, targetW: desired spatial dimensions (resized if necessary)
       static std::vector<float> loadImage(const std::string& imagePath, int targetC, int targetH, int targetW);
 
+      // Same, into a caller-provided buffer of targetC * targetH * targetW floats. The decoded pixels and the
+      // decoder's working buffers come from the thread's ScratchArena (libjpeg still allocates its own).
+      static void loadImage(const std::string& imagePath, int targetC, int targetH, int targetW, float* data);
+
+      // The two halves of loadImage, for callers that keep decoded images around (see ImageCache):
+      // decodeImage returns interleaved HWC uint8 pixels at the target size (decoded by ImageDecoder, then resized),
+      // toNCHW converts such a buffer into the normalised NCHW float layout.
+      static std::vector<unsigned char> decodeImage(const std::string& imagePath, int targetC, int targetH,
+                                                    int targetW);
+      static std::vector<float> toNCHW(const unsigned char* pixels, int targetC, int targetH, int targetW);
+
+      // Same, into caller-provided buffers of targetC * targetH * targetW elements
+      static void decodeImage(const std::string& imagePath, int targetC, int targetH, int targetW,
+                              unsigned char* pixels);
+      static void toNCHW(const unsigned char* pixels, int targetC, int targetH, int targetW, float* data);
+
       // Save a flat NCHW float vector ([0,1]) as an image file.
-      // Format determined by extension: .png, .jpg/.jpeg, .bmp (default: PNG).
-      static void saveImage(const std::string& imagePath, const std::vector<float>& data, int c, int h, int w);
+      // Format determined by extension: .png, .jpg/.jpeg, .bmp (default: PNG). jpegQuality: 1-100.
+      static void saveImage(const std::string& imagePath, const std::vector<float>& data, int c, int h, int w,
+                            int jpegQuality = 90);
+
+      // Deflate effort for every PNG saved afterwards (default 8; higher = smaller and slower, below 5 acts as 5).
+      // Process-wide: set it before saving concurrently, not during.
+      static void setPngCompressionLevel(int level);
 
       // Resolve imagePath relative to baseDirPath (directory).
       // Returns imagePath unchanged if it is already absolute.
@@ -40,20 +62,24 @@ namespace NN_CLI
       //-- Data augmentation transforms (operate on NCHW [0,1] data in-place) --//
 
       // Apply a random combination of transforms to an NCHW buffer.
-      // rng: random engine for reproducibility.
-      static void applyRandomTransforms(std::vector<float>& data, int c, int h, int w, std::mt19937& rng,
+      // rng: the sample's augmentation generator; the same generator state gives the same transforms.
+      // Same result as the individual transforms below applied in turn, but fused: flip, rotation and translation
+      // are one inverse mapping, and brightness is applied as each pixel is written (contrast, which needs channel
+      // means, and noise after a warp take a second in-place pass). Reuses a per-thread buffer, so it does not
+      // allocate per sample.
+      static void applyRandomTransforms(std::vector<float>& data, int c, int h, int w, AugmentationRNG& rng,
                                         const Loader::AugmentationTransforms& transforms = {},
                                         float probability = 0.5f);
 
       // Individual transforms (all operate on NCHW [0,1] data)
       static void horizontalFlip(std::vector<float>& data, int c, int h, int w);
-      static void randomRotation(std::vector<float>& data, int c, int h, int w, float maxDegrees, std::mt19937& rng);
-      static void randomBrightness(std::vector<float>& data, int c, int h, int w, float maxDelta, std::mt19937& rng);
+      static void randomRotation(std::vector<float>& data, int c, int h, int w, float maxDegrees, AugmentationRNG& rng);
+      static void randomBrightness(std::vector<float>& data, int c, int h, int w, float maxDelta, AugmentationRNG& rng);
       static void randomContrast(std::vector<float>& data, int c, int h, int w, float minFactor, float maxFactor,
-                                 std::mt19937& rng);
+                                 AugmentationRNG& rng);
       static void randomTranslation(std::vector<float>& data, int c, int h, int w, float maxFraction,
-                                    std::mt19937& rng);
-      static void addGaussianNoise(std::vector<float>& data, float stddev, std::mt19937& rng);
+                                    AugmentationRNG& rng);
+      static void addGaussianNoise(std::vector<float>& data, float stddev, AugmentationRNG& rng);
   };
 
 } // namespace NN_CLI
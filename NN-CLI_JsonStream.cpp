@@ -0,0 +1,585 @@
+#include "NN-CLI_JsonStream.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+  //-- SAX handler --//
+  //===================================================================================================================//
+
+  namespace
+  {
+    using json = nlohmann::json;
+
+    // Character iterator that publishes how far the parser has read, so progress can be reported by bytes.
+    struct CountingIterator {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = char;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char*;
+        using reference = const char&;
+
+        const char* ptr;
+        const char** cursor;
+
+        reference operator*() const
+        {
+          return *this->ptr;
+        }
+
+        CountingIterator& operator++()
+        {
+          *this->cursor = ++this->ptr;
+          return *this;
+        }
+
+        bool operator==(const CountingIterator& other) const
+        {
+          return this->ptr == other.ptr;
+        }
+
+        bool operator!=(const CountingIterator& other) const
+        {
+          return this->ptr != other.ptr;
+        }
+    };
+
+    // Assembles a DOM from SAX events; subclasses decide which events are routed into it.
+    class DomBuilder : public json::json_sax_t
+    {
+      protected:
+        json root;
+        std::vector<json*> stack; // Open containers of the value under construction (outermost first)
+        std::string pendingKey;
+
+        bool building() const
+        {
+          return !this->stack.empty();
+        }
+
+        // Add a value to the innermost open container (or start a new root value) and return it.
+        template <typename V>
+        json* insert(V&& val)
+        {
+          if (this->stack.empty()) {
+            this->root = json(std::forward<V>(val));
+            return &this->root;
+          }
+
+          json* parent = this->stack.back();
+
+          if (parent->is_array()) {
+            parent->emplace_back(std::forward<V>(val));
+            return &parent->back();
+          }
+
+          json& slot = (*parent)[this->pendingKey];
+          slot = json(std::forward<V>(val));
+          return &slot;
+        }
+
+        void openContainer(json&& container)
+        {
+          this->stack.push_back(this->insert(std::move(container)));
+        }
+
+        // Close the innermost container; returns true when that completes the root value.
+        bool closeContainer()
+        {
+          this->stack.pop_back();
+          return this->stack.empty();
+        }
+    };
+
+    //=================================================================================================================//
+
+    // Builds a DOM only for elements of the selected top-level array, handing each one to a callback.
+    class ArrayElementHandler : public DomBuilder
+    {
+      public:
+        ArrayElementHandler(const std::string& arrayKey, const std::string& filePath,
+                            const JsonStream::ElementCallback& onElement)
+          : arrayKey(arrayKey), filePath(filePath), onElement(onElement)
+        {
+        }
+
+        bool null() override
+        {
+          return this->value(nullptr);
+        }
+
+        bool boolean(bool val) override
+        {
+          return this->value(val);
+        }
+
+        bool number_integer(number_integer_t val) override
+        {
+          return this->value(val);
+        }
+
+        bool number_unsigned(number_unsigned_t val) override
+        {
+          return this->value(val);
+        }
+
+        bool number_float(number_float_t val, const string_t&) override
+        {
+          return this->value(val);
+        }
+
+        bool string(string_t& val) override
+        {
+          return this->value(std::move(val));
+        }
+
+        bool binary(binary_t& val) override
+        {
+          return this->value(std::move(val));
+        }
+
+        bool start_object(std::size_t) override
+        {
+          if (this->building() || this->atElementLevel())
+            this->openContainer(json::object());
+
+          this->depth++;
+          return true;
+        }
+
+        bool key(string_t& val) override
+        {
+          if (this->building())
+            this->pendingKey = std::move(val);
+          else if (this->depth == 1)
+            this->topLevelKey = std::move(val);
+
+          return true;
+        }
+
+        bool end_object() override
+        {
+          this->depth--;
+
+          if (this->building() && this->closeContainer())
+            this->emit();
+
+          return true;
+        }
+
+        bool start_array(std::size_t) override
+        {
+          if (this->building() || this->atElementLevel()) {
+            this->openContainer(json::array());
+          } else if (this->depth == 1 && !this->found && this->topLevelKey == this->arrayKey) {
+            this->found = true;
+            this->elementDepth = this->depth + 1;
+          }
+
+          this->depth++;
+          return true;
+        }
+
+        bool end_array() override
+        {
+          this->depth--;
+
+          if (this->building()) {
+            if (this->closeContainer())
+              this->emit();
+          } else if (this->elementDepth != 0 && this->depth + 1 == this->elementDepth) {
+            this->elementDepth = 0; // Selected array closed; the rest of the document is only validated
+          }
+
+          return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+        {
+          throw std::runtime_error("Failed to parse JSON file " + this->filePath + ": " + ex.what());
+        }
+
+        bool foundArray() const
+        {
+          return this->found;
+        }
+
+        size_t elementCount() const
+        {
+          return this->count;
+        }
+
+      private:
+        const std::string& arrayKey;
+        const std::string& filePath;
+        const JsonStream::ElementCallback& onElement;
+
+        size_t depth = 0; // Number of currently open containers
+        size_t elementDepth = 0; // Depth of the selected array's elements while it is open, 0 otherwise
+        bool found = false;
+        size_t count = 0;
+        std::string topLevelKey;
+
+        bool atElementLevel() const
+        {
+          return this->elementDepth != 0 && this->depth == this->elementDepth;
+        }
+
+        template <typename V>
+        bool value(V&& val)
+        {
+          if (this->building()) {
+            this->insert(std::forward<V>(val));
+          } else if (this->atElementLevel()) {
+            this->root = json(std::forward<V>(val));
+            this->emit();
+          }
+
+          return true;
+        }
+
+        void emit()
+        {
+          this->count++;
+          this->onElement(this->root);
+          this->root = json();
+        }
+    };
+
+    //=================================================================================================================//
+
+    // Builds the whole document, except for container values of selected top-level keys, which are only
+    // located (by byte offset) and skipped.
+    class DeferringDocumentHandler : public DomBuilder
+    {
+      public:
+        DeferringDocumentHandler(const std::vector<std::string>& deferredKeys, const std::string& sourceName,
+                                 const char* data, const char* const& cursor)
+          : deferredKeys(deferredKeys), sourceName(sourceName), data(data), cursor(cursor)
+        {
+        }
+
+        bool null() override
+        {
+          return this->value(nullptr);
+        }
+
+        bool boolean(bool val) override
+        {
+          return this->value(val);
+        }
+
+        bool number_integer(number_integer_t val) override
+        {
+          return this->value(val);
+        }
+
+        bool number_unsigned(number_unsigned_t val) override
+        {
+          return this->value(val);
+        }
+
+        bool number_float(number_float_t val, const string_t&) override
+        {
+          return this->value(val);
+        }
+
+        bool string(string_t& val) override
+        {
+          return this->value(std::move(val));
+        }
+
+        bool binary(binary_t& val) override
+        {
+          return this->value(std::move(val));
+        }
+
+        bool start_object(std::size_t) override
+        {
+          return this->startContainer(json::object());
+        }
+
+        bool key(string_t& val) override
+        {
+          if (this->skipDepth == 0) {
+            // The parser has consumed exactly the key's closing quote here; the value follows the ':'
+            if (this->stack.size() == 1 &&
+                std::find(this->deferredKeys.begin(), this->deferredKeys.end(), val) != this->deferredKeys.end()) {
+              this->deferredKey = val;
+              this->deferredStart = static_cast<size_t>(this->cursor - this->data);
+            } else {
+              this->deferredKey.clear();
+            }
+
+            this->pendingKey = std::move(val);
+          }
+
+          return true;
+        }
+
+        bool end_object() override
+        {
+          return this->endContainer();
+        }
+
+        bool start_array(std::size_t) override
+        {
+          return this->startContainer(json::array());
+        }
+
+        bool end_array() override
+        {
+          return this->endContainer();
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+        {
+          throw std::runtime_error("Failed to parse JSON file " + this->sourceName + ": " + ex.what());
+        }
+
+        json takeDocument()
+        {
+          return std::move(this->root);
+        }
+
+        std::map<std::string, JsonStream::Range> takeDeferred()
+        {
+          return std::move(this->deferred);
+        }
+
+      private:
+        const std::vector<std::string>& deferredKeys;
+        const std::string& sourceName;
+        const char* data;
+        const char* const& cursor;
+
+        size_t skipDepth = 0; // Nesting inside a deferred value, 0 while building
+        std::string deferredKey; // Top-level key whose value comes next, if it is deferred
+        size_t deferredStart = 0;
+        std::map<std::string, JsonStream::Range> deferred;
+
+        template <typename V>
+        bool value(V&& val)
+        {
+          // Deferred scalars are cheap, so they are simply kept in the DOM
+          if (this->skipDepth == 0)
+            this->insert(std::forward<V>(val));
+
+          return true;
+        }
+
+        bool startContainer(json&& container)
+        {
+          if (this->skipDepth > 0 || (this->stack.size() == 1 && !this->deferredKey.empty())) {
+            this->skipDepth++;
+          } else {
+            this->openContainer(std::move(container));
+          }
+
+          return true;
+        }
+
+        bool endContainer()
+        {
+          if (this->skipDepth == 0) {
+            this->closeContainer();
+            return true;
+          }
+
+          if (--this->skipDepth == 0) {
+            // Value text starts after the ':' and any whitespace; the parser has just consumed its closing bracket
+            size_t begin = this->deferredStart;
+            size_t end = static_cast<size_t>(this->cursor - this->data);
+
+            while (begin < end && (std::isspace(static_cast<unsigned char>(this->data[begin])) ||
+                                   this->data[begin] == ':'))
+              begin++;
+
+            this->deferred[this->deferredKey] = {begin, end};
+            this->deferredKey.clear();
+          }
+
+          return true;
+        }
+    };
+  }
+
+  //===================================================================================================================//
+  //-- forEachArrayElement --//
+  //===================================================================================================================//
+
+  size_t JsonStream::forEachArrayElement(QFile& file, const std::string& arrayKey, const ElementCallback& onElement,
+                                         const ProgressCallback& onProgress)
+  {
+    std::string filePath = file.fileName().toStdString();
+    qint64 fileSize = file.size();
+
+    // Map the file so the parser reads straight from the page cache; fall back to reading it for
+    // devices that cannot be mapped (pipes, special files).
+    QByteArray fileData;
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    uchar* mapped = (fileSize > 0) ? file.map(0, fileSize) : nullptr;
+
+    if (mapped) {
+      begin = reinterpret_cast<const char*>(mapped);
+      end = begin + fileSize;
+    } else {
+      fileData = file.readAll();
+      begin = fileData.constData();
+      end = begin + fileData.size();
+    }
+
+    size_t bytesTotal = static_cast<size_t>(end - begin);
+    const char* cursor = begin;
+
+    size_t elements = 0;
+    ElementCallback elementCallback = onElement;
+
+    if (onProgress) {
+      elementCallback = [&](const nlohmann::json& element) {
+        onElement(element);
+        onProgress(++elements, static_cast<size_t>(cursor - begin), bytesTotal);
+      };
+    }
+
+    ArrayElementHandler handler(arrayKey, filePath, elementCallback);
+
+    try {
+      nlohmann::json::sax_parse(CountingIterator{begin, &cursor}, CountingIterator{end, &cursor}, &handler);
+    } catch (...) {
+      if (mapped)
+        file.unmap(mapped);
+      throw;
+    }
+
+    if (mapped)
+      file.unmap(mapped);
+
+    if (!handler.foundArray())
+      throw std::runtime_error("'" + arrayKey + "' must be an array in: " + filePath);
+
+    if (onProgress)
+      onProgress(handler.elementCount(), bytesTotal, bytesTotal);
+
+    return handler.elementCount();
+  }
+
+  //===================================================================================================================//
+  //-- forEachLine --//
+  //===================================================================================================================//
+
+  size_t JsonStream::forEachLine(QFile& file, const ElementCallback& onElement, const ProgressCallback& onProgress)
+  {
+    std::string filePath = file.fileName().toStdString();
+
+    // A pipe has no size up front; its progress is only reported once it closes
+    bool sequential = file.isSequential();
+    size_t bytesTotal = sequential ? 0 : static_cast<size_t>(file.size());
+    size_t bytesRead = 0;
+    size_t lineNumber = 0;
+    size_t elements = 0;
+
+    // readLine() blocks until a full line (or EOF) arrives and keeps the '\n', so only EOF yields an empty result
+    for (QByteArray line = file.readLine(); !line.isEmpty(); line = file.readLine()) {
+      bytesRead += static_cast<size_t>(line.size());
+      lineNumber++;
+
+      const char* begin = line.constData();
+      const char* end = begin + line.size();
+
+      while (begin < end && std::isspace(static_cast<unsigned char>(*begin)))
+        begin++;
+
+      while (end > begin && std::isspace(static_cast<unsigned char>(end[-1])))
+        end--;
+
+      if (begin == end)
+        continue;
+
+      nlohmann::json element;
+
+      try {
+        element = nlohmann::json::parse(begin, end);
+      } catch (const nlohmann::json::parse_error& e) {
+        throw std::runtime_error("Invalid JSON on line " + std::to_string(lineNumber) + " of " + filePath + ": " +
+                                 e.what());
+      }
+
+      onElement(element);
+      elements++;
+
+      if (onProgress && !sequential)
+        onProgress(elements, std::min(bytesRead, bytesTotal), bytesTotal);
+    }
+
+    if (onProgress)
+      onProgress(elements, bytesRead, sequential ? bytesRead : bytesTotal);
+
+    return elements;
+  }
+
+  //===================================================================================================================//
+  //-- forEachRecord --//
+  //===================================================================================================================//
+
+  size_t JsonStream::forEachRecord(QFile& file, const std::string& arrayKey, const ElementCallback& onElement,
+                                   const ProgressCallback& onProgress)
+  {
+    if (isJsonLinesPath(file.fileName().toStdString()))
+      return forEachLine(file, onElement, onProgress);
+
+    return forEachArrayElement(file, arrayKey, onElement, onProgress);
+  }
+
+  //===================================================================================================================//
+
+  bool JsonStream::isJsonLinesPath(const std::string& path)
+  {
+    static const std::string extension = ".jsonl";
+
+    if (path.size() < extension.size())
+      return false;
+
+    return std::equal(extension.begin(), extension.end(), path.end() - extension.size(), [](char a, char b) {
+      return a == std::tolower(static_cast<unsigned char>(b));
+    });
+  }
+
+  //===================================================================================================================//
+  //-- parseDeferring --//
+  //===================================================================================================================//
+
+  nlohmann::json JsonStream::parseDeferring(const char* data, size_t size, const std::string& sourceName,
+                                            const std::vector<std::string>& deferredKeys,
+                                            std::map<std::string, Range>& deferred)
+  {
+    const char* cursor = data;
+    DeferringDocumentHandler handler(deferredKeys, sourceName, data, cursor);
+
+    nlohmann::json::sax_parse(CountingIterator{data, &cursor}, CountingIterator{data + size, &cursor}, &handler);
+
+    deferred = handler.takeDeferred();
+    return handler.takeDocument();
+  }
+
+  //===================================================================================================================//
+
+  nlohmann::json JsonStream::parseRange(const char* data, const Range& range, const std::string& sourceName)
+  {
+    try {
+      return nlohmann::json::parse(data + range.begin, data + range.end);
+    } catch (const nlohmann::json::parse_error& ex) {
+      throw std::runtime_error("Failed to parse JSON file " + sourceName + ": " + ex.what());
+    }
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
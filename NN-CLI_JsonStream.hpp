@@ -0,0 +1,79 @@
+#ifndef NN_CLI_JSONSTREAM_HPP
+#define NN_CLI_JSONSTREAM_HPP
+
+#include <QFile>
+
+#include <json.hpp>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * JsonStream: streaming (SAX) access to one top-level array of a large JSON document.
+ *
+ * The file is memory-mapped and parsed with nlohmann's SAX interface. Only the array element currently being
+ * parsed is materialised as a DOM and handed to the callback, then discarded. Everything else in the document
+ * is validated but never stored, so peak memory is roughly whatever the caller keeps from each element.
+ *
+ * forEachLine() does the same for JSON Lines (.jsonl) files, one value per line. Lines are read as they arrive,
+ * so a file still being written (or a named pipe) is consumed while its producer runs.
+ *
+ * parseDeferring() does the reverse for config-like documents: it builds the full DOM but leaves selected bulky
+ * top-level values (e.g. model "parameters") as byte ranges, to be parsed later by whoever needs them.
+ */
+  class JsonStream
+  {
+    public:
+      // Called once per element of the selected array, in file order.
+      using ElementCallback = std::function<void(const nlohmann::json& element)>;
+
+      // Called after each element and once more when parsing completes (bytesRead == bytesTotal).
+      using ProgressCallback = std::function<void(size_t elements, size_t bytesRead, size_t bytesTotal)>;
+
+      // Stream the elements of the top-level array `arrayKey` (e.g. "samples") from an opened file.
+      // Throws if the document is malformed or `arrayKey` is missing or not an array.
+      // Returns the number of elements visited.
+      static size_t forEachArrayElement(QFile& file, const std::string& arrayKey, const ElementCallback& onElement,
+                                        const ProgressCallback& onProgress = nullptr);
+
+      // Stream the values of a JSON Lines file, one per non-blank line. Throws on the first invalid line.
+      // Progress is reported per line for regular files, and only on completion for pipes.
+      // Returns the number of values visited.
+      static size_t forEachLine(QFile& file, const ElementCallback& onElement,
+                                const ProgressCallback& onProgress = nullptr);
+
+      // forEachLine() for JSON Lines paths, forEachArrayElement() over `arrayKey` for anything else.
+      static size_t forEachRecord(QFile& file, const std::string& arrayKey, const ElementCallback& onElement,
+                                  const ProgressCallback& onProgress = nullptr);
+
+      // True if `path` names a JSON Lines file (".jsonl", any case).
+      static bool isJsonLinesPath(const std::string& path);
+
+      // Byte range [begin, end) of a JSON value within a buffer.
+      struct Range {
+          size_t begin = 0;
+          size_t end = 0;
+      };
+
+      // Parse a document held in memory. Object/array values of the top-level keys in `deferredKeys` are
+      // tokenised but not stored: they are absent from the returned DOM and their ranges are returned in `deferred`.
+      static nlohmann::json parseDeferring(const char* data, size_t size, const std::string& sourceName,
+                                           const std::vector<std::string>& deferredKeys,
+                                           std::map<std::string, Range>& deferred);
+
+      // Parse a single value previously located by parseDeferring().
+      static nlohmann::json parseRange(const char* data, const Range& range, const std::string& sourceName);
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_JSONSTREAM_HPP
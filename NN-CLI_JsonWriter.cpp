@@ -0,0 +1,146 @@
+#include "NN-CLI_JsonWriter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  namespace
+  {
+    // Longest shortest-form float, e.g. "-1.17549435e-38"
+    constexpr size_t kMaxFloatChars = 24;
+  }
+
+  //===================================================================================================================//
+
+  JsonWriter::JsonWriter(QFile& file, size_t bufferSize) : file(&file), buffer(std::max(bufferSize, kMaxFloatChars))
+  {
+    this->sink = [&file](const char* data, size_t size) {
+      if (file.write(data, static_cast<qint64>(size)) != static_cast<qint64>(size))
+        throw std::runtime_error("Failed to write file: " + file.fileName().toStdString());
+    };
+  }
+
+  //===================================================================================================================//
+
+  JsonWriter::JsonWriter(std::string& target, size_t bufferSize) : buffer(std::max(bufferSize, kMaxFloatChars))
+  {
+    this->sink = [&target](const char* data, size_t size) { target.append(data, size); };
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::raw(const char* text, size_t size)
+  {
+    // Large pieces bypass the buffer
+    if (size >= this->buffer.size()) {
+      this->drain();
+      this->sink(text, size);
+      return;
+    }
+
+    this->reserve(size);
+    std::memcpy(this->buffer.data() + this->used, text, size);
+    this->used += size;
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::raw(const std::string& text)
+  {
+    this->raw(text.data(), text.size());
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::number(float value)
+  {
+    if (!std::isfinite(value)) {
+      this->raw("null", 4);
+      return;
+    }
+
+    // "-0" would read back as the integer 0
+    if (value == 0.0f && std::signbit(value)) {
+      this->raw("-0.0", 4);
+      return;
+    }
+
+    this->reserve(kMaxFloatChars);
+    char* begin = this->buffer.data() + this->used;
+    std::to_chars_result result = std::to_chars(begin, begin + kMaxFloatChars, value);
+    this->used += static_cast<size_t>(result.ptr - begin);
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::array(const std::vector<float>& values)
+  {
+    this->put('[');
+
+    for (size_t i = 0; i < values.size(); i++) {
+      if (i > 0)
+        this->put(',');
+
+      this->number(values[i]);
+    }
+
+    this->put(']');
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::value(const nlohmann::ordered_json& json, int indent, int depth)
+  {
+    std::string text = json.dump(indent);
+
+    if (indent > 0 && depth > 0) {
+      std::string shift = "\n" + std::string(static_cast<size_t>(indent) * depth, ' ');
+
+      for (size_t pos = text.find('\n'); pos != std::string::npos; pos = text.find('\n', pos + shift.size()))
+        text.replace(pos, 1, shift);
+    }
+
+    this->raw(text);
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::flush()
+  {
+    this->drain();
+
+    if (this->file && !this->file->flush())
+      throw std::runtime_error("Failed to write file: " + this->file->fileName().toStdString());
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::reserve(size_t bytes)
+  {
+    if (this->buffer.size() - this->used < bytes)
+      this->drain();
+  }
+
+  //===================================================================================================================//
+
+  void JsonWriter::drain()
+  {
+    if (this->used == 0)
+      return;
+
+    // Reset first: if the sink throws, the buffered bytes are dropped rather than written twice
+    size_t size = this->used;
+    this->used = 0;
+    this->sink(this->buffer.data(), size);
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,93 @@
+#ifndef NN_CLI_JSONWRITER_HPP
+#define NN_CLI_JSONWRITER_HPP
+
+#include <QFile>
+
+#include <json.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * JsonWriter: writes JSON text straight into a file through a large buffer, without building a DOM.
+ *
+ * Meant for documents dominated by float arrays (predict outputs, model parameters). Each float is formatted with
+ * std::to_chars, the shortest text that parses back to the same float, and arrays are written compactly, so the
+ * cost per value is a few nanoseconds and the output is as small as it can be. Small structured parts (metadata)
+ * still go through nlohmann via value(). Non-finite floats are written as null, as nlohmann does.
+ *
+ * Nothing reaches the file until the buffer fills or flush() is called; call flush() before closing the file.
+ * Write failures throw std::runtime_error. A writer can also append to a string (e.g. a message being framed).
+ */
+  class JsonWriter
+  {
+    public:
+      // file: already open for writing. bufferSize: bytes collected before each write to the file.
+      explicit JsonWriter(QFile& file, size_t bufferSize = 4 << 20);
+
+      // Append to `target` instead of a file (flush() does not touch any file).
+      explicit JsonWriter(std::string& target, size_t bufferSize = 64 << 10);
+
+      // Text copied as is (punctuation, keys, whitespace).
+      void raw(const char* text, size_t size);
+      void raw(const std::string& text);
+
+      void number(float value);
+
+      // [v0,v1,...] on one line; nested vectors become nested arrays.
+      void array(const std::vector<float>& values);
+
+      template <typename T>
+      void array(const std::vector<std::vector<T>>& values)
+      {
+        this->put('[');
+
+        for (size_t i = 0; i < values.size(); i++) {
+          if (i > 0)
+            this->put(',');
+
+          this->array(values[i]);
+        }
+
+        this->put(']');
+      }
+
+      // A DOM value, as json.dump(indent). With indent >= 0, continuation lines are shifted right by
+      // depth * indent spaces, so the value can sit inside an enclosing object written by hand.
+      void value(const nlohmann::ordered_json& json, int indent = -1, int depth = 0);
+
+      // Write out the buffer and flush the file.
+      void flush();
+
+    private:
+      std::function<void(const char* data, size_t size)> sink;
+      QFile* file = nullptr;
+      std::vector<char> buffer;
+      size_t used = 0;
+
+      void put(char c)
+      {
+        if (this->used == this->buffer.size())
+          this->drain();
+
+        this->buffer[this->used++] = c;
+      }
+
+      // Make room for at least `bytes` more
+      void reserve(size_t bytes);
+
+      // Write the buffered bytes to the file
+      void drain();
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_JSONWRITER_HPP
@@ -1,11 +1,15 @@
 #include "NN-CLI_Loader.hpp"
 #include "NN-CLI_ImageLoader.hpp"
+#include "NN-CLI_JsonStream.hpp"
+#include "NN-CLI_ModelFile.hpp"
+#include "NN-CLI_ParallelImageLoader.hpp"
 #include "NN-CLI_ProgressBar.hpp"
 
 #include <QFile>
 #include <QFileInfo>
 #include <json.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace NN_CLI
@@ -15,16 +19,9 @@ namespace NN_CLI
   // Network type detection
   //===================================================================================================================//
 
-  NetworkType Loader::detectNetworkType(const std::string& configFilePath)
+  NetworkType Loader::detectNetworkType(const ConfigDocument& configDocument)
   {
-    QFile file(QString::fromStdString(configFilePath));
-
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open config file: " + configFilePath);
-    }
-
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+    const nlohmann::json& json = configDocument.json();
 
     // CNN configs have "inputShape" and/or "convolutionalLayersConfig"
     if (json.contains("inputShape") || json.contains("convolutionalLayersConfig")) {
@@ -38,17 +35,10 @@ namespace NN_CLI
   // I/O config loading
   //===================================================================================================================//
 
-  IOConfig Loader::loadIOConfig(const std::string& configFilePath, std::optional<std::string> inputTypeOverride,
+  IOConfig Loader::loadIOConfig(const ConfigDocument& configDocument, std::optional<std::string> inputTypeOverride,
                                 std::optional<std::string> outputTypeOverride)
   {
-    QFile file(QString::fromStdString(configFilePath));
-
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open config file: " + configFilePath);
-    }
-
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+    const nlohmann::json& json = configDocument.json();
 
     IOConfig ioConfig;
 
@@ -86,6 +76,36 @@ namespace NN_CLI
       ioConfig.outputW = s.at("w").get<ulong>();
     }
 
+    // Output image encoding
+    if (json.contains("outputImageFormat")) {
+      ioConfig.outputImageFormat = json.at("outputImageFormat").get<std::string>();
+      std::transform(ioConfig.outputImageFormat.begin(), ioConfig.outputImageFormat.end(),
+                     ioConfig.outputImageFormat.begin(), ::tolower);
+
+      if (ioConfig.outputImageFormat == "jpeg")
+        ioConfig.outputImageFormat = "jpg";
+
+      if (ioConfig.outputImageFormat != "png" && ioConfig.outputImageFormat != "jpg" &&
+          ioConfig.outputImageFormat != "bmp") {
+        throw std::runtime_error("outputImageFormat must be 'png', 'jpg' or 'bmp', got: " +
+                                 ioConfig.outputImageFormat);
+      }
+    }
+
+    if (json.contains("pngCompressionLevel")) {
+      ioConfig.pngCompressionLevel = json.at("pngCompressionLevel").get<int>();
+
+      if (ioConfig.pngCompressionLevel < 0)
+        throw std::runtime_error("pngCompressionLevel must not be negative");
+    }
+
+    if (json.contains("jpegQuality")) {
+      ioConfig.jpegQuality = json.at("jpegQuality").get<int>();
+
+      if (ioConfig.jpegQuality < 1 || ioConfig.jpegQuality > 100)
+        throw std::runtime_error("jpegQuality must be between 1 and 100");
+    }
+
     return ioConfig;
   }
 
@@ -93,17 +113,10 @@ namespace NN_CLI
   // ANN config loading (unchanged logic, renamed)
   //===================================================================================================================//
 
-  ANN::CoreConfig<float> Loader::loadANNConfig(const std::string& configFilePath, std::optional<ANN::ModeType> modeType,
+  ANN::CoreConfig<float> Loader::loadANNConfig(const ConfigDocument& configDocument, std::optional<ANN::ModeType> modeType,
                                                std::optional<ANN::DeviceType> deviceType)
   {
-    QFile file(QString::fromStdString(configFilePath));
-
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open config file: " + configFilePath);
-    }
-
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+    const nlohmann::json& json = configDocument.json();
 
     ANN::CoreConfig<float> coreConfig;
 
@@ -132,7 +145,7 @@ namespace NN_CLI
       coreConfig.deviceType = deviceType.value();
 
     if (!json.contains("layersConfig")) {
-      throw std::runtime_error("Config file missing 'layersConfig': " + configFilePath);
+      throw std::runtime_error("Config file missing 'layersConfig': " + configDocument.filePath());
     }
 
     for (const auto& layerJson : json.at("layersConfig")) {
@@ -168,17 +181,17 @@ namespace NN_CLI
         coreConfig.trainingConfig.dropoutRate = tc.at("dropoutRate").get<float>();
     }
 
-    if (json.contains("parameters")) {
-      const auto& p = json.at("parameters");
-      coreConfig.parameters.weights = p.at("weights").get<ANN::Tensor3D<float>>();
-      coreConfig.parameters.biases = p.at("biases").get<ANN::Tensor2D<float>>();
+    // Parameters (JSON arrays, or float32 blobs of a binary model)
+    if (configDocument.hasParameters()) {
+      ModelFile::loadANNParameters(configDocument, coreConfig);
     }
 
     bool isPredictOrTest =
       (coreConfig.modeType == ANN::ModeType::PREDICT || coreConfig.modeType == ANN::ModeType::TEST);
 
-    if (isPredictOrTest && !json.contains("parameters")) {
-      throw std::runtime_error("Config file missing 'parameters' required for predict/test modes: " + configFilePath);
+    if (isPredictOrTest && !configDocument.hasParameters()) {
+      throw std::runtime_error("Config file missing 'parameters' required for predict/test modes: " +
+                               configDocument.filePath());
     }
 
     return coreConfig;
@@ -188,18 +201,11 @@ namespace NN_CLI
   // CNN config loading
   //===================================================================================================================//
 
-  CNN::CoreConfig<float> Loader::loadCNNConfig(const std::string& configFilePath,
+  CNN::CoreConfig<float> Loader::loadCNNConfig(const ConfigDocument& configDocument,
                                                std::optional<std::string> modeOverride,
                                                std::optional<std::string> deviceOverride)
   {
-    QFile file(QString::fromStdString(configFilePath));
-
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open config file: " + configFilePath);
-    }
-
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+    const nlohmann::json& json = configDocument.json();
 
     CNN::CoreConfig<float> coreConfig;
 
@@ -229,7 +235,7 @@ namespace NN_CLI
 
     // Input shape (required for CNN)
     if (!json.contains("inputShape")) {
-      throw std::runtime_error("CNN config file missing 'inputShape': " + configFilePath);
+      throw std::runtime_error("CNN config file missing 'inputShape': " + configDocument.filePath());
     }
 
     const auto& shapeJson = json.at("inputShape");
@@ -314,322 +320,319 @@ namespace NN_CLI
         coreConfig.trainingConfig.dropoutRate = tc.at("dropoutRate").get<float>();
     }
 
-    // Parameters (for predict/test modes or resuming training)
-    if (json.contains("parameters")) {
-      const auto& paramsJson = json.at("parameters");
-
-      if (paramsJson.contains("convolutional")) {
-        for (const auto& convJson : paramsJson.at("convolutional")) {
-          CNN::ConvParameters<float> cp;
-          cp.numFilters = convJson.at("numFilters").get<ulong>();
-          cp.inputC = convJson.at("inputC").get<ulong>();
-          cp.filterH = convJson.at("filterH").get<ulong>();
-          cp.filterW = convJson.at("filterW").get<ulong>();
-          cp.filters = convJson.at("filters").get<std::vector<float>>();
-          cp.biases = convJson.at("biases").get<std::vector<float>>();
-          coreConfig.parameters.convParams.push_back(std::move(cp));
-        }
-      }
-
-      if (paramsJson.contains("dense")) {
-        const auto& denseJson = paramsJson.at("dense");
-        coreConfig.parameters.denseParams.weights = denseJson.at("weights").get<ANN::Tensor3D<float>>();
-        coreConfig.parameters.denseParams.biases = denseJson.at("biases").get<ANN::Tensor2D<float>>();
-      }
+    // Parameters (for predict/test modes or resuming training; JSON arrays or float32 blobs of a binary model)
+    if (configDocument.hasParameters()) {
+      ModelFile::loadCNNParameters(configDocument, coreConfig);
     }
 
     bool isPredictOrTest =
       (coreConfig.modeType == CNN::ModeType::PREDICT || coreConfig.modeType == CNN::ModeType::TEST);
 
-    if (isPredictOrTest && !json.contains("parameters")) {
+    if (isPredictOrTest && !configDocument.hasParameters()) {
       throw std::runtime_error("CNN config file missing 'parameters' required for predict/test modes: " +
-                               configFilePath);
+                               configDocument.filePath());
     }
 
     return coreConfig;
   }
 
   //===================================================================================================================//
-  // Sample and input loading
+  // Input loading
   //===================================================================================================================//
 
-  ANN::Samples<float> Loader::loadANNSamples(const std::string& samplesFilePath, const IOConfig& ioConfig,
-                                             ulong progressReports)
+  std::vector<ANN::Input<float>> Loader::loadANNInputs(const std::string& inputFilePath, const IOConfig& ioConfig,
+                                                       ulong progressReports, int ioThreads)
   {
-    QFile file(QString::fromStdString(samplesFilePath));
+    QFile file(QString::fromStdString(inputFilePath));
 
     if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open samples file: " + samplesFilePath);
+      throw std::runtime_error("Failed to open input file: " + inputFilePath);
     }
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
-
-    // Resolve base directory for relative image paths
-    std::string baseDir = QFileInfo(QString::fromStdString(samplesFilePath)).absolutePath().toStdString();
-
-    const auto& samplesArray = json.at("samples");
-    size_t totalSamples = samplesArray.size();
-
-    ANN::Samples<float> samples;
-    samples.reserve(totalSamples);
-    size_t idx = 0;
+    std::string baseDir = QFileInfo(QString::fromStdString(inputFilePath)).absolutePath().toStdString();
 
-    for (const auto& sampleJson : samplesArray) {
-      ANN::Sample<float> sample;
+    if (ioConfig.inputType == DataType::IMAGE && !ioConfig.hasInputShape()) {
+      throw std::runtime_error("inputType is 'image' but no inputShape provided in config.");
+    }
 
-      // Input
-      if (ioConfig.inputType == DataType::IMAGE) {
-        if (!ioConfig.hasInputShape()) {
-          throw std::runtime_error("inputType is 'image' but no inputShape provided in config.");
+    std::vector<ANN::Input<float>> inputs;
+    ParallelImageLoader imageLoader(ioThreads);
+
+    JsonStream::forEachRecord(
+      file, "inputs",
+      [&](const nlohmann::json& entry) {
+        if (ioConfig.inputType == DataType::IMAGE) {
+          imageLoader.add(ImageLoader::resolvePath(entry.get<std::string>(), baseDir),
+                          static_cast<int>(ioConfig.inputC), static_cast<int>(ioConfig.inputH),
+                          static_cast<int>(ioConfig.inputW));
+          inputs.emplace_back();
+        } else {
+          inputs.push_back(entry.get<std::vector<float>>());
         }
+      },
+      [&](size_t count, size_t bytesRead, size_t bytesTotal) {
+        ProgressBar::printStreamingProgress("Loading inputs:", count, bytesRead, bytesTotal, progressReports);
+      });
 
-        std::string imgPath = ImageLoader::resolvePath(sampleJson.at("input").get<std::string>(), baseDir);
-        sample.input = ImageLoader::loadImage(imgPath, static_cast<int>(ioConfig.inputC),
-                                              static_cast<int>(ioConfig.inputH), static_cast<int>(ioConfig.inputW));
-      } else {
-        sample.input = sampleJson.at("input").get<std::vector<float>>();
-      }
+    if (inputs.empty()) {
+      throw std::runtime_error("No inputs found in: " + inputFilePath);
+    }
 
-      // Output
-      if (ioConfig.outputType == DataType::IMAGE) {
-        if (!ioConfig.hasOutputShape()) {
-          throw std::runtime_error("outputType is 'image' but no outputShape provided in config.");
-        }
+    inputs.shrink_to_fit();
 
-        std::string imgPath = ImageLoader::resolvePath(sampleJson.at("output").get<std::string>(), baseDir);
-        sample.output = ImageLoader::loadImage(imgPath, static_cast<int>(ioConfig.outputC),
-                                               static_cast<int>(ioConfig.outputH), static_cast<int>(ioConfig.outputW));
-      } else {
-        sample.output = sampleJson.at("output").get<std::vector<float>>();
-      }
+    if (ioConfig.inputType == DataType::IMAGE) {
+      std::vector<std::vector<float>> images = imageLoader.loadAll("Decoding images:", progressReports);
 
-      samples.push_back(std::move(sample));
-      ProgressBar::printLoadingProgress("Loading samples:", ++idx, totalSamples, progressReports);
+      for (size_t i = 0; i < inputs.size(); i++)
+        inputs[i] = std::move(images[i]);
     }
 
-    return samples;
+    return inputs;
   }
 
   //===================================================================================================================//
 
-  CNN::Samples<float> Loader::loadCNNSamples(const std::string& samplesFilePath, const CNN::Shape3D& inputShape,
-                                             const IOConfig& ioConfig, ulong progressReports)
+  std::vector<CNN::Input<float>> Loader::loadCNNInputs(const std::string& inputFilePath, const CNN::Shape3D& inputShape,
+                                                       const IOConfig& ioConfig, ulong progressReports, int ioThreads)
   {
-    QFile file(QString::fromStdString(samplesFilePath));
+    QFile file(QString::fromStdString(inputFilePath));
 
     if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open samples file: " + samplesFilePath);
+      throw std::runtime_error("Failed to open input file: " + inputFilePath);
     }
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
-
-    std::string baseDir = QFileInfo(QString::fromStdString(samplesFilePath)).absolutePath().toStdString();
-
-    const nlohmann::json& samplesArray = json.at("samples");
-    size_t totalSamples = samplesArray.size();
-
-    CNN::Samples<float> samples;
-    samples.reserve(totalSamples);
-    size_t idx = 0;
-
-    for (const auto& sampleJson : samplesArray) {
-      CNN::Sample<float> sample;
+    std::string baseDir = QFileInfo(QString::fromStdString(inputFilePath)).absolutePath().toStdString();
+    std::vector<CNN::Input<float>> inputs;
+    ParallelImageLoader imageLoader(ioThreads);
+
+    JsonStream::forEachRecord(
+      file, "inputs",
+      [&](const nlohmann::json& entry) {
+        // Image entries stay empty until every path is read, then are decoded in place
+        if (ioConfig.inputType == DataType::IMAGE) {
+          imageLoader.add(ImageLoader::resolvePath(entry.get<std::string>(), baseDir), static_cast<int>(inputShape.c),
+                          static_cast<int>(inputShape.h), static_cast<int>(inputShape.w));
+          inputs.emplace_back();
+        } else {
+          CNN::Input<float> input(inputShape);
+          std::vector<float> flatInput = entry.get<std::vector<float>>();
 
-      // Input
-      if (ioConfig.inputType == DataType::IMAGE) {
-        std::string imgPath = ImageLoader::resolvePath(sampleJson.at("input").get<std::string>(), baseDir);
-        std::vector<float> flatInput = ImageLoader::loadImage(
-          imgPath, static_cast<int>(inputShape.c), static_cast<int>(inputShape.h), static_cast<int>(inputShape.w));
-        sample.input = CNN::Input<float>(inputShape);
-        sample.input.data = std::move(flatInput);
-      } else {
-        std::vector<float> flatInput = sampleJson.at("input").get<std::vector<float>>();
+          if (flatInput.size() != inputShape.size()) {
+            throw std::runtime_error("Input size (" + std::to_string(flatInput.size()) +
+                                     ") does not match expected input shape size (" +
+                                     std::to_string(inputShape.size()) + ")");
+          }
 
-        if (flatInput.size() != inputShape.size()) {
-          throw std::runtime_error("Sample input size (" + std::to_string(flatInput.size()) +
-                                   ") does not match expected input shape size (" + std::to_string(inputShape.size()) +
-                                   ")");
+          input.data = std::move(flatInput);
+          inputs.push_back(std::move(input));
         }
+      },
+      [&](size_t count, size_t bytesRead, size_t bytesTotal) {
+        ProgressBar::printStreamingProgress("Loading inputs:", count, bytesRead, bytesTotal, progressReports);
+      });
 
-        sample.input = CNN::Input<float>(inputShape);
-        sample.input.data = std::move(flatInput);
-      }
+    if (inputs.empty()) {
+      throw std::runtime_error("No inputs found in: " + inputFilePath);
+    }
 
-      // Output
-      if (ioConfig.outputType == DataType::IMAGE) {
-        if (!ioConfig.hasOutputShape()) {
-          throw std::runtime_error("outputType is 'image' but no outputShape provided in config.");
-        }
+    inputs.shrink_to_fit();
 
-        std::string imgPath = ImageLoader::resolvePath(sampleJson.at("output").get<std::string>(), baseDir);
-        sample.output = ImageLoader::loadImage(imgPath, static_cast<int>(ioConfig.outputC),
-                                               static_cast<int>(ioConfig.outputH), static_cast<int>(ioConfig.outputW));
-      } else {
-        sample.output = sampleJson.at("output").get<CNN::Output<float>>();
+    if (ioConfig.inputType == DataType::IMAGE) {
+      std::vector<float*> destinations(inputs.size());
+
+      for (size_t i = 0; i < inputs.size(); i++) {
+        inputs[i] = CNN::Input<float>(inputShape);
+        destinations[i] = inputs[i].data.data();
       }
 
-      samples.push_back(std::move(sample));
-      ProgressBar::printLoadingProgress("Loading samples:", ++idx, totalSamples, progressReports);
+      imageLoader.loadAll(destinations, "Decoding images:", progressReports);
     }
 
-    return samples;
+    return inputs;
   }
 
   //===================================================================================================================//
 
-  std::vector<ANN::Input<float>> Loader::loadANNInputs(const std::string& inputFilePath, const IOConfig& ioConfig,
-                                                       ulong progressReports)
+  ANN::Input<float> Loader::parseANNInput(const nlohmann::json& entry, const IOConfig& ioConfig,
+                                          const std::string& baseDir)
   {
-    QFile file(QString::fromStdString(inputFilePath));
+    if (ioConfig.inputType != DataType::IMAGE)
+      return entry.get<std::vector<float>>();
 
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open input file: " + inputFilePath);
+    if (!ioConfig.hasInputShape()) {
+      throw std::runtime_error("inputType is 'image' but no inputShape provided in config.");
     }
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
-
-    const auto& inputsArray = json.at("inputs");
+    return ImageLoader::loadImage(ImageLoader::resolvePath(entry.get<std::string>(), baseDir),
+                                  static_cast<int>(ioConfig.inputC), static_cast<int>(ioConfig.inputH),
+                                  static_cast<int>(ioConfig.inputW));
+  }
 
-    if (!inputsArray.is_array() || inputsArray.empty()) {
-      throw std::runtime_error("'inputs' must be a non-empty array in: " + inputFilePath);
-    }
+  //===================================================================================================================//
 
-    std::string baseDir = QFileInfo(QString::fromStdString(inputFilePath)).absolutePath().toStdString();
-    size_t totalInputs = inputsArray.size();
-    std::vector<ANN::Input<float>> inputs;
-    inputs.reserve(totalInputs);
-    size_t idx = 0;
+  CNN::Input<float> Loader::parseCNNInput(const nlohmann::json& entry, const CNN::Shape3D& inputShape,
+                                          const IOConfig& ioConfig, const std::string& baseDir)
+  {
+    CNN::Input<float> input(inputShape);
 
-    for (const auto& entry : inputsArray) {
-      if (ioConfig.inputType == DataType::IMAGE) {
-        if (!ioConfig.hasInputShape()) {
-          throw std::runtime_error("inputType is 'image' but no inputShape provided in config.");
-        }
+    if (ioConfig.inputType == DataType::IMAGE) {
+      input.data = ImageLoader::loadImage(ImageLoader::resolvePath(entry.get<std::string>(), baseDir),
+                                          static_cast<int>(inputShape.c), static_cast<int>(inputShape.h),
+                                          static_cast<int>(inputShape.w));
+      return input;
+    }
 
-        std::string imgPath = ImageLoader::resolvePath(entry.get<std::string>(), baseDir);
-        inputs.push_back(ImageLoader::loadImage(imgPath, static_cast<int>(ioConfig.inputC),
-                                                static_cast<int>(ioConfig.inputH), static_cast<int>(ioConfig.inputW)));
-      } else {
-        inputs.push_back(entry.get<std::vector<float>>());
-      }
+    input.data = entry.get<std::vector<float>>();
 
-      ProgressBar::printLoadingProgress("Loading inputs:", ++idx, totalInputs, progressReports);
+    if (input.data.size() != inputShape.size()) {
+      throw std::runtime_error("Input size (" + std::to_string(input.data.size()) +
+                               ") does not match expected input shape size (" + std::to_string(inputShape.size()) +
+                               ")");
     }
 
-    return inputs;
+    return input;
   }
 
+  //===================================================================================================================//
+  // progressReports loading
   //===================================================================================================================//
 
-  std::vector<CNN::Input<float>> Loader::loadCNNInputs(const std::string& inputFilePath, const CNN::Shape3D& inputShape,
-                                                       const IOConfig& ioConfig, ulong progressReports)
+  ulong Loader::loadProgressReports(const ConfigDocument& configDocument)
   {
-    QFile file(QString::fromStdString(inputFilePath));
+    const nlohmann::json& json = configDocument.json();
 
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open input file: " + inputFilePath);
+    if (json.contains("progressReports")) {
+      return json.at("progressReports").get<ulong>();
     }
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+    return 1000; // default
+  }
 
-    const auto& inputsArray = json.at("inputs");
+  //===================================================================================================================//
+  // saveModelInterval loading
+  //===================================================================================================================//
 
-    if (!inputsArray.is_array() || inputsArray.empty()) {
-      throw std::runtime_error("'inputs' must be a non-empty array in: " + inputFilePath);
+  ulong Loader::loadSaveModelInterval(const ConfigDocument& configDocument)
+  {
+    const nlohmann::json& json = configDocument.json();
+
+    if (json.contains("saveModelInterval")) {
+      return json.at("saveModelInterval").get<ulong>();
     }
 
-    std::string baseDir = QFileInfo(QString::fromStdString(inputFilePath)).absolutePath().toStdString();
-    size_t totalInputs = inputsArray.size();
-    std::vector<CNN::Input<float>> inputs;
-    inputs.reserve(totalInputs);
-    size_t idx = 0;
-
-    for (const auto& entry : inputsArray) {
-      std::vector<float> flatInput;
-
-      if (ioConfig.inputType == DataType::IMAGE) {
-        std::string imgPath = ImageLoader::resolvePath(entry.get<std::string>(), baseDir);
-        flatInput = ImageLoader::loadImage(imgPath, static_cast<int>(inputShape.c), static_cast<int>(inputShape.h),
-                                           static_cast<int>(inputShape.w));
-      } else {
-        flatInput = entry.get<std::vector<float>>();
-      }
+    return 10; // default: save every 10 epochs
+  }
 
-      if (flatInput.size() != inputShape.size()) {
-        throw std::runtime_error("Input size (" + std::to_string(flatInput.size()) +
-                                 ") does not match expected input shape size (" + std::to_string(inputShape.size()) +
-                                 ")");
-      }
+  //===================================================================================================================//
+  // imageCacheMB loading
+  //===================================================================================================================//
+
+  ulong Loader::loadImageCacheMB(const ConfigDocument& configDocument)
+  {
+    const nlohmann::json& json = configDocument.json();
 
-      CNN::Input<float> input(inputShape);
-      input.data = std::move(flatInput);
-      inputs.push_back(std::move(input));
-      ProgressBar::printLoadingProgress("Loading inputs:", ++idx, totalInputs, progressReports);
+    if (json.contains("imageCacheMB")) {
+      return json.at("imageCacheMB").get<ulong>();
     }
 
-    return inputs;
+    return 512; // default: 512 MB of decoded images
   }
 
   //===================================================================================================================//
-  // progressReports loading
+  // imageCacheDir loading
   //===================================================================================================================//
 
-  ulong Loader::loadProgressReports(const std::string& configFilePath)
+  std::string Loader::loadImageCacheDir(const ConfigDocument& configDocument)
   {
-    QFile file(QString::fromStdString(configFilePath));
+    const nlohmann::json& json = configDocument.json();
 
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open config file: " + configFilePath);
+    if (json.contains("imageCacheDir")) {
+      return json.at("imageCacheDir").get<std::string>();
     }
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+    return ""; // default: disabled
+  }
 
-    if (json.contains("progressReports")) {
-      return json.at("progressReports").get<ulong>();
+  //===================================================================================================================//
+  // ioThreads loading
+  //===================================================================================================================//
+
+  int Loader::loadIOThreads(const ConfigDocument& configDocument)
+  {
+    const nlohmann::json& json = configDocument.json();
+
+    if (json.contains("ioThreads")) {
+      return json.at("ioThreads").get<int>();
     }
 
-    return 1000; // default
+    return 0; // default: one per core
   }
 
   //===================================================================================================================//
-  // saveModelInterval loading
+  // testBatchSize loading
   //===================================================================================================================//
 
-  ulong Loader::loadSaveModelInterval(const std::string& configFilePath)
+  ulong Loader::loadTestBatchSize(const ConfigDocument& configDocument)
   {
-    QFile file(QString::fromStdString(configFilePath));
+    const nlohmann::json& json = configDocument.json();
 
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open config file: " + configFilePath);
-    }
+    if (json.contains("testBatchSize")) {
+      ulong testBatchSize = json.at("testBatchSize").get<ulong>();
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+      if (testBatchSize == 0) {
+        throw std::runtime_error("testBatchSize must be greater than 0.");
+      }
 
-    if (json.contains("saveModelInterval")) {
-      return json.at("saveModelInterval").get<ulong>();
+      return testBatchSize;
     }
 
-    return 10; // default: save every 10 epochs
+    return 1024; // default
   }
 
+  //===================================================================================================================//
+  // serveConfig loading
   //===================================================================================================================//
 
-  Loader::AugmentationConfig Loader::loadAugmentationConfig(const std::string& configFilePath)
+  Loader::ServeConfig Loader::loadServeConfig(const ConfigDocument& configDocument)
   {
-    QFile file(QString::fromStdString(configFilePath));
+    const nlohmann::json& json = configDocument.json();
 
-    if (!file.open(QIODevice::ReadOnly)) {
-      throw std::runtime_error("Failed to open config file: " + configFilePath);
-    }
+    ServeConfig config;
+
+    if (!json.contains("serveConfig"))
+      return config;
+
+    const auto& sc = json.at("serveConfig");
+
+    if (sc.contains("maxBatchSize"))
+      config.maxBatchSize = sc.at("maxBatchSize").get<ulong>();
+
+    if (sc.contains("maxWaitMs"))
+      config.maxWaitMs = sc.at("maxWaitMs").get<double>();
+
+    if (sc.contains("maxQueueSize"))
+      config.maxQueueSize = sc.at("maxQueueSize").get<ulong>();
+
+    if (sc.contains("admissionTimeoutMs"))
+      config.admissionTimeoutMs = sc.at("admissionTimeoutMs").get<double>();
+
+    if (config.maxBatchSize == 0)
+      throw std::runtime_error("serveConfig.maxBatchSize must be greater than 0.");
+
+    if (config.maxQueueSize < config.maxBatchSize)
+      throw std::runtime_error("serveConfig.maxQueueSize must be at least maxBatchSize.");
 
-    QByteArray fileData = file.readAll();
-    nlohmann::json json = nlohmann::json::parse(fileData.toStdString());
+    if (config.maxWaitMs < 0 || config.admissionTimeoutMs < 0)
+      throw std::runtime_error("serveConfig.maxWaitMs and admissionTimeoutMs must not be negative.");
+
+    return config;
+  }
+
+  //===================================================================================================================//
+
+  Loader::AugmentationConfig Loader::loadAugmentationConfig(const ConfigDocument& configDocument)
+  {
+    const nlohmann::json& json = configDocument.json();
 
     AugmentationConfig config;
 
@@ -648,6 +651,9 @@ namespace NN_CLI
       if (tc.contains("augmentationProbability"))
         config.augmentationProbability = tc.at("augmentationProbability").get<float>();
 
+      if (tc.contains("augmentationSeed"))
+        config.augmentationSeed = tc.at("augmentationSeed").get<ulong>();
+
       if (tc.contains("augmentationTransforms")) {
         const auto& at = tc.at("augmentationTransforms");
         auto& t = config.transforms;
@@ -1,6 +1,7 @@
 #ifndef NN_CLI_LOADER_HPP
 #define NN_CLI_LOADER_HPP
 
+#include "NN-CLI_ConfigDocument.hpp"
 #include "NN-CLI_NetworkType.hpp"
 #include "NN-CLI_DataType.hpp"
 #include "NN-CLI_IOConfig.hpp"
@@ -29,45 +30,68 @@ namespace NN_CLI
   {
     public:
       // Detect whether a config file defines an ANN or CNN network.
-      static NetworkType detectNetworkType(const std::string& configFilePath);
+      static NetworkType detectNetworkType(const ConfigDocument& configDocument);
 
-      // Load I/O configuration (inputType, outputType, shapes) with optional CLI overrides
-      static IOConfig loadIOConfig(const std::string& configFilePath,
+      // Load I/O configuration (inputType, outputType, shapes, output image encoding) with optional CLI overrides
+      static IOConfig loadIOConfig(const ConfigDocument& configDocument,
                                    std::optional<std::string> inputTypeOverride = std::nullopt,
                                    std::optional<std::string> outputTypeOverride = std::nullopt);
 
-      // Load ANN configuration with optional CLI overrides
-      static ANN::CoreConfig<float> loadANNConfig(const std::string& configFilePath,
+      // Load ANN configuration with optional CLI overrides (the only place model parameters are materialised)
+      static ANN::CoreConfig<float> loadANNConfig(const ConfigDocument& configDocument,
                                                   std::optional<ANN::ModeType> modeType = std::nullopt,
                                                   std::optional<ANN::DeviceType> deviceType = std::nullopt);
 
-      // Load CNN configuration with optional CLI overrides
-      static CNN::CoreConfig<float> loadCNNConfig(const std::string& configFilePath,
+      // Load CNN configuration with optional CLI overrides (the only place model parameters are materialised)
+      static CNN::CoreConfig<float> loadCNNConfig(const ConfigDocument& configDocument,
                                                   std::optional<std::string> modeOverride = std::nullopt,
                                                   std::optional<std::string> deviceOverride = std::nullopt);
 
-      // Load ANN samples from JSON (supports image paths when ioConfig.inputType/outputType is IMAGE)
-      static ANN::Samples<float> loadANNSamples(const std::string& samplesFilePath, const IOConfig& ioConfig,
-                                                ulong progressReports = 1000);
-
-      // Load CNN samples from JSON (supports image paths when ioConfig.inputType/outputType is IMAGE)
-      static CNN::Samples<float> loadCNNSamples(const std::string& samplesFilePath, const CNN::Shape3D& inputShape,
-                                                const IOConfig& ioConfig, ulong progressReports = 1000);
-
-      // Load ANN inputs from JSON (batch: "inputs" array; supports image paths when ioConfig.inputType is IMAGE)
+      // Load ANN inputs from JSON ("inputs" array) or JSON Lines (one per line); entries are image paths when
+      // ioConfig.inputType is IMAGE
       static std::vector<ANN::Input<float>> loadANNInputs(const std::string& inputFilePath, const IOConfig& ioConfig,
-                                                          ulong progressReports = 1000);
+                                                          ulong progressReports = 1000, int ioThreads = 0);
 
-      // Load CNN inputs from JSON (batch: "inputs" array; supports image paths when ioConfig.inputType is IMAGE)
+      // Load CNN inputs from JSON ("inputs" array) or JSON Lines (one per line); entries are image paths when
+      // ioConfig.inputType is IMAGE
       static std::vector<CNN::Input<float>> loadCNNInputs(const std::string& inputFilePath,
                                                           const CNN::Shape3D& inputShape, const IOConfig& ioConfig,
-                                                          ulong progressReports = 1000);
+                                                          ulong progressReports = 1000, int ioThreads = 0);
+
+      // Convert one element of an "inputs" array (a vector, or an image path relative to baseDir) into an input.
+      // Used by streaming predict, which handles inputs one at a time.
+      static ANN::Input<float> parseANNInput(const nlohmann::json& entry, const IOConfig& ioConfig,
+                                             const std::string& baseDir);
+      static CNN::Input<float> parseCNNInput(const nlohmann::json& entry, const CNN::Shape3D& inputShape,
+                                             const IOConfig& ioConfig, const std::string& baseDir);
 
       // Load progressReports from config root (returns 1000 if not present)
-      static ulong loadProgressReports(const std::string& configFilePath);
+      static ulong loadProgressReports(const ConfigDocument& configDocument);
 
       // Load saveModelInterval from config root (returns 10 if not present; 0 = disabled)
-      static ulong loadSaveModelInterval(const std::string& configFilePath);
+      static ulong loadSaveModelInterval(const ConfigDocument& configDocument);
+
+      // Load imageCacheMB from config root (returns 512 if not present; 0 = no decoded-image cache)
+      static ulong loadImageCacheMB(const ConfigDocument& configDocument);
+
+      // Load imageCacheDir from config root (returns "" if not present = no persistent cache)
+      static std::string loadImageCacheDir(const ConfigDocument& configDocument);
+
+      // Load ioThreads from config root (returns 0 if not present = one image-decoding thread per core)
+      static int loadIOThreads(const ConfigDocument& configDocument);
+
+      // Load testBatchSize from config root (returns 1024 if not present; samples evaluated per batch in test mode)
+      static ulong loadTestBatchSize(const ConfigDocument& configDocument);
+
+      // Load serveConfig from config root: micro-batching of serve mode requests (see PredictScheduler)
+      struct ServeConfig {
+          ulong maxBatchSize = 32; // Inputs predicted together at most
+          double maxWaitMs = 2.0; // Longest an input waits for its batch to fill while another worker is busy
+          ulong maxQueueSize = 1024; // Inputs waiting at most; requests beyond it wait for room
+          double admissionTimeoutMs = 100.0; // Longest a request waits for room before it is rejected
+      };
+
+      static ServeConfig loadServeConfig(const ConfigDocument& configDocument);
 
       // Load data augmentation config from trainingConfig (NN-CLI handles augmentation, not ANN/CNN)
       struct AugmentationTransforms {
@@ -84,10 +108,11 @@ namespace NN_CLI
           bool balanceAugmentation = false; // true = augment minority classes up to max class count
           bool autoClassWeights = false; // true = auto-compute inverse-frequency class weights
           float augmentationProbability = 0.5f; // Probability of applying each enabled transform (default 50%)
+          std::optional<ulong> augmentationSeed; // Fixed seed for reproducible transforms (unset = new seed per run)
           AugmentationTransforms transforms; // Which transforms to apply and their intensities
       };
 
-      static AugmentationConfig loadAugmentationConfig(const std::string& configFilePath);
+      static AugmentationConfig loadAugmentationConfig(const ConfigDocument& configDocument);
   };
 
 } // namespace NN_CLI
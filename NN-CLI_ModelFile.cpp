@@ -0,0 +1,807 @@
+#include "NN-CLI_ModelFile.hpp"
+#include "NN-CLI_JsonWriter.hpp"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+  //-- Binary container --//
+  //===================================================================================================================//
+
+  namespace
+  {
+    constexpr char kMagic[8] = {'N', 'N', 'C', 'L', 'I', 'M', 'B', '\0'};
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+    constexpr size_t kPreambleSize = 64;
+    constexpr size_t kAlignment = 64;
+
+    struct Preamble {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t headerOffset;
+        uint64_t headerSize;
+        uint64_t blobOffset;
+        uint64_t fileSize;
+    };
+
+    static_assert(sizeof(Preamble) <= kPreambleSize, "Model file preamble must fit in its reserved block");
+
+    size_t alignUp(size_t value)
+    {
+      return (value + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    // Same root keys the Loader reads back, so a saved model carries the settings it was trained with.
+    void writeSettings(nlohmann::ordered_json& json, const ModelFile::Settings& settings)
+    {
+      json["progressReports"] = settings.progressReports;
+      json["saveModelInterval"] = settings.saveModelInterval;
+      json["ioThreads"] = settings.ioThreads;
+      json["testBatchSize"] = settings.testBatchSize;
+
+      nlohmann::ordered_json serveJson;
+      serveJson["maxBatchSize"] = settings.serveConfig.maxBatchSize;
+      serveJson["maxWaitMs"] = settings.serveConfig.maxWaitMs;
+      serveJson["maxQueueSize"] = settings.serveConfig.maxQueueSize;
+      serveJson["admissionTimeoutMs"] = settings.serveConfig.admissionTimeoutMs;
+      json["serveConfig"] = serveJson;
+    }
+
+    // Collects parameter tensors as float32 blobs and records where each one goes in the blob region.
+    class BlobWriter
+    {
+      public:
+        nlohmann::ordered_json addVector(const std::vector<float>& values)
+        {
+          nlohmann::ordered_json desc;
+          desc["offset"] = this->addBlob({{values.data(), values.size()}});
+          desc["count"] = values.size();
+          return desc;
+        }
+
+        // Rows are stored back to back; "shape" lists the length of each row.
+        nlohmann::ordered_json addTensor2D(const ANN::Tensor2D<float>& tensor)
+        {
+          std::vector<std::pair<const float*, size_t>> spans;
+          nlohmann::ordered_json shape = nlohmann::ordered_json::array();
+
+          for (const auto& row : tensor) {
+            spans.emplace_back(row.data(), row.size());
+            shape.push_back(row.size());
+          }
+
+          nlohmann::ordered_json desc;
+          desc["offset"] = this->addBlob(std::move(spans));
+          desc["shape"] = shape;
+          return desc;
+        }
+
+        // One row-major matrix per layer; "shape" lists [rows, cols] for each layer.
+        nlohmann::ordered_json addTensor3D(const ANN::Tensor3D<float>& tensor)
+        {
+          std::vector<std::pair<const float*, size_t>> spans;
+          nlohmann::ordered_json shape = nlohmann::ordered_json::array();
+
+          for (const auto& matrix : tensor) {
+            size_t cols = matrix.empty() ? 0 : matrix.front().size();
+
+            for (const auto& row : matrix) {
+              if (row.size() != cols)
+                throw std::runtime_error("Cannot store a ragged weight matrix in a binary model file");
+
+              spans.emplace_back(row.data(), row.size());
+            }
+
+            shape.push_back({matrix.size(), cols});
+          }
+
+          nlohmann::ordered_json desc;
+          desc["offset"] = this->addBlob(std::move(spans));
+          desc["shape"] = shape;
+          return desc;
+        }
+
+        size_t size() const
+        {
+          return this->end;
+        }
+
+        void write(QFile& file, const std::string& filePath) const
+        {
+          size_t position = 0;
+
+          for (const Blob& blob : this->blobs) {
+            writePadding(file, blob.offset - position, filePath);
+            position = blob.offset;
+
+            for (const auto& span : blob.spans) {
+              qint64 bytes = static_cast<qint64>(span.second * sizeof(float));
+
+              if (bytes > 0 && file.write(reinterpret_cast<const char*>(span.first), bytes) != bytes)
+                throw std::runtime_error("Failed to write model file: " + filePath);
+
+              position += static_cast<size_t>(bytes);
+            }
+          }
+
+          writePadding(file, this->size() - position, filePath);
+        }
+
+        static void writePadding(QFile& file, size_t bytes, const std::string& filePath)
+        {
+          static const char zeros[kAlignment] = {};
+
+          while (bytes > 0) {
+            size_t chunk = std::min(bytes, kAlignment);
+
+            if (file.write(zeros, static_cast<qint64>(chunk)) != static_cast<qint64>(chunk))
+              throw std::runtime_error("Failed to write model file: " + filePath);
+
+            bytes -= chunk;
+          }
+        }
+
+      private:
+        struct Blob {
+            std::vector<std::pair<const float*, size_t>> spans;
+            size_t offset;
+        };
+
+        std::vector<Blob> blobs;
+        size_t end = 0;
+
+        size_t addBlob(std::vector<std::pair<const float*, size_t>> spans)
+        {
+          size_t offset = alignUp(this->end);
+          size_t count = 0;
+
+          for (const auto& span : spans)
+            count += span.second;
+
+          this->blobs.push_back({std::move(spans), offset});
+          this->end = alignUp(offset + count * sizeof(float));
+          return offset;
+        }
+    };
+
+    // Reads tensors described by a BlobWriter layout out of the mapped blob region.
+    class BlobReader
+    {
+      public:
+        explicit BlobReader(const ConfigDocument& configDocument) : configDocument(configDocument)
+        {
+        }
+
+        std::vector<float> vector(const nlohmann::json& desc) const
+        {
+          size_t count = desc.at("count").get<size_t>();
+          std::vector<float> values(count);
+          this->copy(desc.at("offset").get<size_t>(), values.data(), count);
+          return values;
+        }
+
+        ANN::Tensor2D<float> tensor2D(const nlohmann::json& desc) const
+        {
+          size_t offset = desc.at("offset").get<size_t>();
+          ANN::Tensor2D<float> tensor;
+
+          for (const auto& rowSize : desc.at("shape")) {
+            std::vector<float> row(rowSize.get<size_t>());
+            this->copy(offset, row.data(), row.size());
+            offset += row.size() * sizeof(float);
+            tensor.push_back(std::move(row));
+          }
+
+          return tensor;
+        }
+
+        ANN::Tensor3D<float> tensor3D(const nlohmann::json& desc) const
+        {
+          size_t offset = desc.at("offset").get<size_t>();
+          ANN::Tensor3D<float> tensor;
+
+          for (const auto& dims : desc.at("shape")) {
+            size_t rows = dims.at(0).get<size_t>();
+            size_t cols = dims.at(1).get<size_t>();
+            ANN::Tensor2D<float> matrix(rows, std::vector<float>(cols));
+
+            for (auto& row : matrix) {
+              this->copy(offset, row.data(), cols);
+              offset += cols * sizeof(float);
+            }
+
+            tensor.push_back(std::move(matrix));
+          }
+
+          return tensor;
+        }
+
+      private:
+        const ConfigDocument& configDocument;
+
+        void copy(size_t offset, float* dst, size_t count) const
+        {
+          size_t bytes = count * sizeof(float);
+
+          if (offset > this->configDocument.blobDataSize() || bytes > this->configDocument.blobDataSize() - offset)
+            throw std::runtime_error("Model file is truncated (parameter data out of range): " +
+                                     this->configDocument.filePath());
+
+          if (bytes > 0)
+            std::memcpy(dst, this->configDocument.blobData() + offset, bytes);
+        }
+    };
+
+    // Models are written next to their destination and renamed into place, so a reader (or a crash mid-write)
+    // never sees a partially written file.
+    void commitModelFile(QFile& file, const std::string& filePath)
+    {
+      std::string tmpPath = file.fileName().toStdString();
+
+      if (!file.flush()) {
+        file.close();
+        QFile::remove(file.fileName());
+        throw std::runtime_error("Failed to write model file: " + filePath);
+      }
+
+      file.close();
+
+      if (std::rename(tmpPath.c_str(), filePath.c_str()) != 0) {
+        QFile::remove(QString::fromStdString(tmpPath));
+        throw std::runtime_error("Failed to move model file into place: " + filePath);
+      }
+    }
+
+    void openTemporaryModelFile(QFile& file, const std::string& filePath)
+    {
+      file.setFileName(QString::fromStdString(filePath + ".tmp"));
+
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error("Failed to open file for writing: " + filePath);
+      }
+    }
+
+    void writeBinaryModel(const nlohmann::ordered_json& header, const BlobWriter& blobs, const std::string& filePath)
+    {
+      std::string headerStr = header.dump();
+
+      Preamble preamble = {};
+      std::memcpy(preamble.magic, kMagic, sizeof(kMagic));
+      preamble.version = kVersion;
+      preamble.byteOrder = kByteOrderMark;
+      preamble.headerOffset = kPreambleSize;
+      preamble.headerSize = headerStr.size();
+      preamble.blobOffset = alignUp(kPreambleSize + headerStr.size());
+      preamble.fileSize = preamble.blobOffset + blobs.size();
+
+      QFile file;
+      openTemporaryModelFile(file, filePath);
+
+      try {
+        char preambleBlock[kPreambleSize] = {};
+        std::memcpy(preambleBlock, &preamble, sizeof(preamble));
+
+        if (file.write(preambleBlock, kPreambleSize) != static_cast<qint64>(kPreambleSize) ||
+            file.write(headerStr.data(), static_cast<qint64>(headerStr.size())) !=
+              static_cast<qint64>(headerStr.size()))
+          throw std::runtime_error("Failed to write model file: " + filePath);
+
+        BlobWriter::writePadding(file, preamble.blobOffset - kPreambleSize - headerStr.size(), filePath);
+        blobs.write(file, filePath);
+      } catch (...) {
+        file.close();
+        QFile::remove(file.fileName());
+        throw;
+      }
+
+      commitModelFile(file, filePath);
+    }
+
+    // The header goes through nlohmann (it is small); the parameters are written after it by writeParameters,
+    // straight from the tensors, as the value of "parameters".
+    void writeJsonModel(const nlohmann::ordered_json& header, const std::function<void(JsonWriter&)>& writeParameters,
+                        const std::string& filePath)
+    {
+      QFile file;
+      openTemporaryModelFile(file, filePath);
+
+      try {
+        JsonWriter writer(file);
+        std::string headerStr = header.dump(4);
+
+        // Reopen the header object: drop its closing "\n}" (or the "}" of an empty object)
+        headerStr.resize(headerStr.size() - (header.empty() ? 1 : 2));
+        writer.raw(headerStr);
+        writer.raw(header.empty() ? "\n    \"parameters\": " : ",\n    \"parameters\": ");
+        writeParameters(writer);
+        writer.raw("\n}\n");
+        writer.flush();
+      } catch (...) {
+        file.close();
+        QFile::remove(file.fileName());
+        throw;
+      }
+
+      commitModelFile(file, filePath);
+    }
+  }
+
+  //===================================================================================================================//
+  //-- Format selection --//
+  //===================================================================================================================//
+
+  ModelFile::Format ModelFile::formatForPath(const std::string& filePath)
+  {
+    QString suffix = QFileInfo(QString::fromStdString(filePath)).suffix().toLower();
+    return (suffix == "nnb") ? Format::BINARY : Format::JSON;
+  }
+
+  //===================================================================================================================//
+
+  std::string ModelFile::extension(Format format)
+  {
+    return (format == Format::BINARY) ? ".nnb" : ".json";
+  }
+
+  //===================================================================================================================//
+  //-- Saving --//
+  //===================================================================================================================//
+
+  ModelFile::ANNSnapshot ModelFile::snapshotANN(const ANN::Core<float>& core, const IOConfig& ioConfig,
+                                                const Settings& settings)
+  {
+    return {annHeader(core, ioConfig, settings), core.getParameters()};
+  }
+
+  //===================================================================================================================//
+
+  ModelFile::CNNSnapshot ModelFile::snapshotCNN(const CNN::Core<float>& core, const IOConfig& ioConfig,
+                                                const Settings& settings)
+  {
+    return {cnnHeader(core, ioConfig, settings), core.getParameters()};
+  }
+
+  //===================================================================================================================//
+
+  void ModelFile::saveANNModel(const ANN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
+                               const Settings& settings)
+  {
+    saveANNModel(snapshotANN(core, ioConfig, settings), filePath);
+  }
+
+  //===================================================================================================================//
+
+  void ModelFile::saveCNNModel(const CNN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
+                               const Settings& settings)
+  {
+    saveCNNModel(snapshotCNN(core, ioConfig, settings), filePath);
+  }
+
+  //===================================================================================================================//
+
+  void ModelFile::saveANNModel(const ANNSnapshot& snapshot, const std::string& filePath)
+  {
+    nlohmann::ordered_json json = snapshot.header;
+    const auto& parameters = snapshot.parameters;
+
+    if (formatForPath(filePath) == Format::BINARY) {
+      BlobWriter blobs;
+      nlohmann::ordered_json paramsJson;
+      paramsJson["weights"] = blobs.addTensor3D(parameters.weights);
+      paramsJson["biases"] = blobs.addTensor2D(parameters.biases);
+      json["parameters"] = paramsJson;
+
+      writeBinaryModel(json, blobs, filePath);
+      return;
+    }
+
+    // Parameters: one tensor per line
+    writeJsonModel(
+      json,
+      [&](JsonWriter& writer) {
+        writer.raw("{\n        \"weights\": ");
+        writer.array(parameters.weights);
+        writer.raw(",\n        \"biases\": ");
+        writer.array(parameters.biases);
+        writer.raw("\n    }");
+      },
+      filePath);
+  }
+
+  //===================================================================================================================//
+
+  void ModelFile::saveCNNModel(const CNNSnapshot& snapshot, const std::string& filePath)
+  {
+    nlohmann::ordered_json json = snapshot.header;
+    const auto& parameters = snapshot.parameters;
+    const auto& denseParams = parameters.denseParams;
+
+    if (formatForPath(filePath) == Format::BINARY) {
+      BlobWriter blobs;
+      nlohmann::ordered_json paramsJson;
+
+      // Conv parameters
+      nlohmann::ordered_json convArr = nlohmann::ordered_json::array();
+      for (const auto& cp : parameters.convParams) {
+        nlohmann::ordered_json cpJson;
+        cpJson["numFilters"] = cp.numFilters;
+        cpJson["inputC"] = cp.inputC;
+        cpJson["filterH"] = cp.filterH;
+        cpJson["filterW"] = cp.filterW;
+        cpJson["filters"] = blobs.addVector(cp.filters);
+        cpJson["biases"] = blobs.addVector(cp.biases);
+        convArr.push_back(cpJson);
+      }
+
+      paramsJson["convolutional"] = convArr;
+
+      // Dense parameters
+      nlohmann::ordered_json denseParamsJson;
+      denseParamsJson["weights"] = blobs.addTensor3D(denseParams.weights);
+      denseParamsJson["biases"] = blobs.addTensor2D(denseParams.biases);
+      paramsJson["dense"] = denseParamsJson;
+
+      json["parameters"] = paramsJson;
+
+      writeBinaryModel(json, blobs, filePath);
+      return;
+    }
+
+    // Parameters: one conv layer per line, one dense tensor per line
+    writeJsonModel(
+      json,
+      [&](JsonWriter& writer) {
+        writer.raw("{\n        \"convolutional\": [");
+
+        for (size_t i = 0; i < parameters.convParams.size(); i++) {
+          const auto& cp = parameters.convParams[i];
+          nlohmann::ordered_json cpJson;
+          cpJson["numFilters"] = cp.numFilters;
+          cpJson["inputC"] = cp.inputC;
+          cpJson["filterH"] = cp.filterH;
+          cpJson["filterW"] = cp.filterW;
+
+          // The dimensions object, reopened to append the arrays
+          std::string cpStr = cpJson.dump();
+          cpStr.pop_back();
+
+          writer.raw(i > 0 ? ",\n            " : "\n            ");
+          writer.raw(cpStr);
+          writer.raw(",\"filters\":");
+          writer.array(cp.filters);
+          writer.raw(",\"biases\":");
+          writer.array(cp.biases);
+          writer.raw("}");
+        }
+
+        writer.raw(parameters.convParams.empty() ? "],\n" : "\n        ],\n");
+        writer.raw("        \"dense\": {\n            \"weights\": ");
+        writer.array(denseParams.weights);
+        writer.raw(",\n            \"biases\": ");
+        writer.array(denseParams.biases);
+        writer.raw("\n        }\n    }");
+      },
+      filePath);
+  }
+
+  //===================================================================================================================//
+  //-- Loading --//
+  //===================================================================================================================//
+
+  void ModelFile::loadANNParameters(const ConfigDocument& configDocument, ANN::CoreConfig<float>& coreConfig)
+  {
+    nlohmann::json p = configDocument.parameters();
+
+    if (configDocument.isBinaryModel()) {
+      BlobReader blobs(configDocument);
+      coreConfig.parameters.weights = blobs.tensor3D(p.at("weights"));
+      coreConfig.parameters.biases = blobs.tensor2D(p.at("biases"));
+      return;
+    }
+
+    coreConfig.parameters.weights = p.at("weights").get<ANN::Tensor3D<float>>();
+    coreConfig.parameters.biases = p.at("biases").get<ANN::Tensor2D<float>>();
+  }
+
+  //===================================================================================================================//
+
+  void ModelFile::loadCNNParameters(const ConfigDocument& configDocument, CNN::CoreConfig<float>& coreConfig)
+  {
+    nlohmann::json paramsJson = configDocument.parameters();
+    bool binary = configDocument.isBinaryModel();
+    BlobReader blobs(configDocument);
+
+    if (paramsJson.contains("convolutional")) {
+      for (const auto& convJson : paramsJson.at("convolutional")) {
+        CNN::ConvParameters<float> cp;
+        cp.numFilters = convJson.at("numFilters").get<ulong>();
+        cp.inputC = convJson.at("inputC").get<ulong>();
+        cp.filterH = convJson.at("filterH").get<ulong>();
+        cp.filterW = convJson.at("filterW").get<ulong>();
+        cp.filters = binary ? blobs.vector(convJson.at("filters")) : convJson.at("filters").get<std::vector<float>>();
+        cp.biases = binary ? blobs.vector(convJson.at("biases")) : convJson.at("biases").get<std::vector<float>>();
+        coreConfig.parameters.convParams.push_back(std::move(cp));
+      }
+    }
+
+    if (paramsJson.contains("dense")) {
+      const auto& denseJson = paramsJson.at("dense");
+      auto& denseParams = coreConfig.parameters.denseParams;
+      denseParams.weights = binary ? blobs.tensor3D(denseJson.at("weights"))
+                                   : denseJson.at("weights").get<ANN::Tensor3D<float>>();
+      denseParams.biases =
+        binary ? blobs.tensor2D(denseJson.at("biases")) : denseJson.at("biases").get<ANN::Tensor2D<float>>();
+    }
+  }
+
+  //===================================================================================================================//
+  //-- Binary container access --//
+  //===================================================================================================================//
+
+  bool ModelFile::isBinaryModel(const char* data, size_t size)
+  {
+    return size >= sizeof(kMagic) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+  }
+
+  //===================================================================================================================//
+
+  nlohmann::json ModelFile::readBinaryHeader(const char* data, size_t size, const std::string& filePath,
+                                             size_t& blobOffset)
+  {
+    if (size < kPreambleSize)
+      throw std::runtime_error("Model file is truncated: " + filePath);
+
+    Preamble preamble;
+    std::memcpy(&preamble, data, sizeof(preamble));
+
+    if (preamble.byteOrder != kByteOrderMark)
+      throw std::runtime_error("Model file was written on a machine with a different byte order: " + filePath);
+
+    if (preamble.version != kVersion)
+      throw std::runtime_error("Unsupported model file version " + std::to_string(preamble.version) + ": " +
+                               filePath);
+
+    // Checked without adding offsets, so corrupt fields cannot wrap around
+    if (preamble.fileSize != size || preamble.headerOffset > size ||
+        preamble.headerSize > size - preamble.headerOffset || preamble.blobOffset > size)
+      throw std::runtime_error("Model file size does not match its header (truncated?): " + filePath);
+
+    blobOffset = preamble.blobOffset;
+
+    const char* header = data + preamble.headerOffset;
+
+    try {
+      return nlohmann::json::parse(header, header + preamble.headerSize);
+    } catch (const nlohmann::json::parse_error& ex) {
+      throw std::runtime_error("Failed to parse model file header " + filePath + ": " + ex.what());
+    }
+  }
+
+  //===================================================================================================================//
+  //-- Header (everything except parameters) --//
+  //===================================================================================================================//
+
+  nlohmann::ordered_json ModelFile::annHeader(const ANN::Core<float>& core, const IOConfig& ioConfig,
+                                              const Settings& settings)
+  {
+    nlohmann::ordered_json json;
+
+    json["mode"] = ANN::Mode::typeToName(core.getModeType());
+    json["device"] = ANN::Device::typeToName(core.getDeviceType());
+    json["numThreads"] = core.getNumThreads();
+    json["numGPUs"] = core.getNumGPUs();
+
+    // NN-CLI settings
+    writeSettings(json, settings);
+
+    // I/O types (NN-CLI concept, persisted so predict/test can reload them)
+    json["inputType"] = dataTypeToString(ioConfig.inputType);
+    json["outputType"] = dataTypeToString(ioConfig.outputType);
+
+    if (ioConfig.hasInputShape()) {
+      nlohmann::ordered_json isJson;
+      isJson["c"] = ioConfig.inputC;
+      isJson["h"] = ioConfig.inputH;
+      isJson["w"] = ioConfig.inputW;
+      json["inputShape"] = isJson;
+    }
+
+    if (ioConfig.hasOutputShape()) {
+      nlohmann::ordered_json osJson;
+      osJson["c"] = ioConfig.outputC;
+      osJson["h"] = ioConfig.outputH;
+      osJson["w"] = ioConfig.outputW;
+      json["outputShape"] = osJson;
+      json["outputImageFormat"] = ioConfig.outputImageFormat;
+      json["pngCompressionLevel"] = ioConfig.pngCompressionLevel;
+      json["jpegQuality"] = ioConfig.jpegQuality;
+    }
+
+    // Layers config
+    nlohmann::ordered_json layersArr = nlohmann::ordered_json::array();
+    for (const auto& layer : core.getLayersConfig()) {
+      nlohmann::ordered_json layerJson;
+      layerJson["numNeurons"] = layer.numNeurons;
+      layerJson["actvFunc"] = ANN::ActvFunc::typeToName(layer.actvFuncType);
+      layersArr.push_back(layerJson);
+    }
+
+    json["layersConfig"] = layersArr;
+
+    // Cost function config
+    nlohmann::ordered_json cfcJson;
+    cfcJson["type"] = ANN::CostFunction::typeToName(core.getCostFunctionConfig().type);
+
+    if (!core.getCostFunctionConfig().weights.empty()) {
+      cfcJson["weights"] = core.getCostFunctionConfig().weights;
+    }
+
+    json["costFunctionConfig"] = cfcJson;
+
+    // Training config
+    nlohmann::ordered_json tcJson;
+    tcJson["numEpochs"] = core.getTrainingConfig().numEpochs;
+    tcJson["learningRate"] = core.getTrainingConfig().learningRate;
+    tcJson["batchSize"] = core.getTrainingConfig().batchSize;
+    tcJson["shuffleSamples"] = core.getTrainingConfig().shuffleSamples;
+
+    if (core.getTrainingConfig().dropoutRate > 0.0f)
+      tcJson["dropoutRate"] = core.getTrainingConfig().dropoutRate;
+    json["trainingConfig"] = tcJson;
+
+    // Training metadata
+    const auto& md = core.getTrainingMetadata();
+    nlohmann::ordered_json mdJson;
+    mdJson["startTime"] = md.startTime;
+    mdJson["endTime"] = md.endTime;
+    mdJson["durationSeconds"] = md.durationSeconds;
+    mdJson["durationFormatted"] = md.durationFormatted;
+    mdJson["numSamples"] = md.numSamples;
+    mdJson["finalLoss"] = md.finalLoss;
+    json["trainingMetadata"] = mdJson;
+
+    return json;
+  }
+
+  //===================================================================================================================//
+
+  nlohmann::ordered_json ModelFile::cnnHeader(const CNN::Core<float>& core, const IOConfig& ioConfig,
+                                              const Settings& settings)
+  {
+    nlohmann::ordered_json json;
+
+    json["mode"] = CNN::Mode::typeToName(core.getModeType());
+    json["device"] = CNN::Device::typeToName(core.getDeviceType());
+    json["numThreads"] = core.getNumThreads();
+    json["numGPUs"] = core.getNumGPUs();
+
+    // NN-CLI settings
+    writeSettings(json, settings);
+
+    // I/O types (NN-CLI concept, persisted so predict/test can reload them)
+    json["inputType"] = dataTypeToString(ioConfig.inputType);
+    json["outputType"] = dataTypeToString(ioConfig.outputType);
+
+    // Input shape (CNN network shape, always present)
+    const auto& shape = core.getInputShape();
+    nlohmann::ordered_json shapeJson;
+    shapeJson["c"] = shape.c;
+    shapeJson["h"] = shape.h;
+    shapeJson["w"] = shape.w;
+    json["inputShape"] = shapeJson;
+
+    // Output shape (for image output reconstruction)
+    if (ioConfig.hasOutputShape()) {
+      nlohmann::ordered_json osJson;
+      osJson["c"] = ioConfig.outputC;
+      osJson["h"] = ioConfig.outputH;
+      osJson["w"] = ioConfig.outputW;
+      json["outputShape"] = osJson;
+      json["outputImageFormat"] = ioConfig.outputImageFormat;
+      json["pngCompressionLevel"] = ioConfig.pngCompressionLevel;
+      json["jpegQuality"] = ioConfig.jpegQuality;
+    }
+
+    // CNN layers config
+    nlohmann::ordered_json cnnLayersArr = nlohmann::ordered_json::array();
+    for (const auto& layer : core.getLayersConfig().cnnLayers) {
+      nlohmann::ordered_json layerJson;
+      switch (layer.type) {
+      case CNN::LayerType::CONV: {
+        const auto& conv = std::get<CNN::ConvLayerConfig>(layer.config);
+        layerJson["type"] = "conv";
+        layerJson["numFilters"] = conv.numFilters;
+        layerJson["filterH"] = conv.filterH;
+        layerJson["filterW"] = conv.filterW;
+        layerJson["strideY"] = conv.strideY;
+        layerJson["strideX"] = conv.strideX;
+        layerJson["slidingStrategy"] = CNN::SlidingStrategy::typeToName(conv.slidingStrategy);
+        break;
+      }
+
+      case CNN::LayerType::RELU:
+        layerJson["type"] = "relu";
+        break;
+      case CNN::LayerType::POOL: {
+        const auto& pool = std::get<CNN::PoolLayerConfig>(layer.config);
+        layerJson["type"] = "pool";
+        layerJson["poolType"] = CNN::PoolType::typeToName(pool.poolType);
+        layerJson["poolH"] = pool.poolH;
+        layerJson["poolW"] = pool.poolW;
+        layerJson["strideY"] = pool.strideY;
+        layerJson["strideX"] = pool.strideX;
+        break;
+      }
+
+      case CNN::LayerType::FLATTEN:
+        layerJson["type"] = "flatten";
+        break;
+      }
+
+      cnnLayersArr.push_back(layerJson);
+    }
+
+    json["convolutionalLayersConfig"] = cnnLayersArr;
+
+    // Dense layers config
+    nlohmann::ordered_json denseLayersArr = nlohmann::ordered_json::array();
+    for (const auto& layer : core.getLayersConfig().denseLayers) {
+      nlohmann::ordered_json layerJson;
+      layerJson["numNeurons"] = layer.numNeurons;
+      layerJson["actvFunc"] = ANN::ActvFunc::typeToName(layer.actvFuncType);
+      denseLayersArr.push_back(layerJson);
+    }
+
+    json["denseLayersConfig"] = denseLayersArr;
+
+    // Cost function config
+    nlohmann::ordered_json cfcJson;
+    cfcJson["type"] = CNN::CostFunction::typeToName(core.getCostFunctionConfig().type);
+
+    if (!core.getCostFunctionConfig().weights.empty()) {
+      cfcJson["weights"] = core.getCostFunctionConfig().weights;
+    }
+
+    json["costFunctionConfig"] = cfcJson;
+
+    // Training config
+    nlohmann::ordered_json tcJson;
+    tcJson["numEpochs"] = core.getTrainingConfig().numEpochs;
+    tcJson["learningRate"] = core.getTrainingConfig().learningRate;
+    tcJson["batchSize"] = core.getTrainingConfig().batchSize;
+    tcJson["shuffleSamples"] = core.getTrainingConfig().shuffleSamples;
+
+    if (core.getTrainingConfig().dropoutRate > 0.0f)
+      tcJson["dropoutRate"] = core.getTrainingConfig().dropoutRate;
+    json["trainingConfig"] = tcJson;
+
+    // Training metadata
+    const auto& md = core.getTrainingMetadata();
+    nlohmann::ordered_json mdJson;
+    mdJson["startTime"] = md.startTime;
+    mdJson["endTime"] = md.endTime;
+    mdJson["durationSeconds"] = md.durationSeconds;
+    mdJson["durationFormatted"] = md.durationFormatted;
+    mdJson["numSamples"] = md.numSamples;
+    mdJson["finalLoss"] = md.finalLoss;
+    json["trainingMetadata"] = mdJson;
+
+    return json;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,96 @@
+#ifndef NN_CLI_MODELFILE_HPP
+#define NN_CLI_MODELFILE_HPP
+
+#include "NN-CLI_ConfigDocument.hpp"
+#include "NN-CLI_IOConfig.hpp"
+#include "NN-CLI_Loader.hpp"
+
+#include <ANN_Core.hpp>
+#include <CNN_Core.hpp>
+
+#include <json.hpp>
+
+#include <string>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * ModelFile: saving trained models and reading their parameters back, in either container format.
+ *
+ * JSON (.json, default): the config plus a "parameters" object holding every weight as text.
+ *
+ * Binary (.nnb), all integers in host byte order:
+ *   [preamble, 64 bytes][JSON header][padding][float32 blobs, each 64-byte aligned]
+ * The JSON header is the same document as the JSON format, except that "parameters" describes where each tensor
+ * lives ({"offset": bytes into the blob region, "count"/"shape": ...}) instead of holding the values. The file is
+ * memory-mapped by ConfigDocument, so loading copies the weights straight out of the page cache.
+ */
+  class ModelFile
+  {
+    public:
+      enum class Format { JSON, BINARY };
+
+      // Format selected by an output path: ".nnb" is binary, anything else JSON.
+      static Format formatForPath(const std::string& filePath);
+
+      // File extension (with dot) used for generated model/checkpoint names.
+      static std::string extension(Format format);
+
+      // NN-CLI settings (config root keys) saved with the model, so predict, test and serve runs of it use them
+      struct Settings {
+          ulong progressReports = 1000;
+          ulong saveModelInterval = 10;
+          int ioThreads = 0;
+          ulong testBatchSize = 1024;
+          Loader::ServeConfig serveConfig;
+      };
+
+      // Everything needed to write a model, detached from the live core. Taking one only copies the parameters,
+      // so it is cheap enough for the training thread; serialisation can then happen elsewhere.
+      struct ANNSnapshot {
+          nlohmann::ordered_json header; // Config and metadata (everything except "parameters")
+          decltype(ANN::CoreConfig<float>::parameters) parameters;
+      };
+
+      struct CNNSnapshot {
+          nlohmann::ordered_json header;
+          decltype(CNN::CoreConfig<float>::parameters) parameters;
+      };
+
+      static ANNSnapshot snapshotANN(const ANN::Core<float>& core, const IOConfig& ioConfig, const Settings& settings);
+      static CNNSnapshot snapshotCNN(const CNN::Core<float>& core, const IOConfig& ioConfig, const Settings& settings);
+
+      //-- Saving (written to "<filePath>.tmp", then renamed over filePath) --//
+      static void saveANNModel(const ANN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
+                               const Settings& settings);
+      static void saveCNNModel(const CNN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
+                               const Settings& settings);
+      static void saveANNModel(const ANNSnapshot& snapshot, const std::string& filePath);
+      static void saveCNNModel(const CNNSnapshot& snapshot, const std::string& filePath);
+
+      //-- Loading (called only when configDocument.hasParameters()) --//
+      static void loadANNParameters(const ConfigDocument& configDocument, ANN::CoreConfig<float>& coreConfig);
+      static void loadCNNParameters(const ConfigDocument& configDocument, CNN::CoreConfig<float>& coreConfig);
+
+      //-- Binary container access (used by ConfigDocument) --//
+      static bool isBinaryModel(const char* data, size_t size);
+
+      // Validate the preamble and return the JSON header; blobOffset receives the start of the blob region.
+      static nlohmann::json readBinaryHeader(const char* data, size_t size, const std::string& filePath,
+                                             size_t& blobOffset);
+
+    private:
+      static nlohmann::ordered_json annHeader(const ANN::Core<float>& core, const IOConfig& ioConfig,
+                                              const Settings& settings);
+      static nlohmann::ordered_json cnnHeader(const CNN::Core<float>& core, const IOConfig& ioConfig,
+                                              const Settings& settings);
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_MODELFILE_HPP
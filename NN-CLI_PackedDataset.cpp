@@ -0,0 +1,279 @@
+#include "NN-CLI_PackedDataset.hpp"
+#include "NN-CLI_PixelKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+  //-- On-disk header --//
+  //===================================================================================================================//
+
+  namespace
+  {
+    constexpr char kMagic[8] = {'N', 'N', 'C', 'L', 'I', 'P', 'K', '\0'};
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+    constexpr ulong kHeaderSize = 128;
+    constexpr ulong kAlignment = 64;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t inputType;
+        uint32_t reserved;
+        uint64_t numSamples;
+        uint64_t inputSize;
+        uint64_t outputSize;
+        int32_t inputC, inputH, inputW;
+        int32_t outputC, outputH, outputW;
+        uint64_t inputOffset;
+        uint64_t outputOffset;
+        uint64_t fileSize;
+    };
+
+    static_assert(sizeof(FileHeader) <= kHeaderSize, "PackedDataset header must fit in its reserved block");
+
+    ulong alignUp(ulong value)
+    {
+      return (value + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    ulong elementSize(PackedDataset::ElementType type)
+    {
+      return (type == PackedDataset::ElementType::UINT8) ? 1 : sizeof(float);
+    }
+  }
+
+  //===================================================================================================================//
+
+  PackedDataset::~PackedDataset()
+  {
+    this->finish();
+  }
+
+  //===================================================================================================================//
+
+  bool PackedDataset::isPackedFile(const std::string& filePath)
+  {
+    QFile file(QString::fromStdString(filePath));
+
+    if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+    char magic[sizeof(kMagic)] = {};
+
+    if (file.read(magic, sizeof(magic)) != static_cast<qint64>(sizeof(magic)))
+      return false;
+
+    return std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  }
+
+  //===================================================================================================================//
+
+  std::unique_ptr<PackedDataset> PackedDataset::open(const std::string& filePath)
+  {
+    std::unique_ptr<PackedDataset> dataset(new PackedDataset());
+    dataset->filePath = filePath;
+    dataset->file.setFileName(QString::fromStdString(filePath));
+
+    if (!dataset->file.open(QIODevice::ReadOnly))
+      throw std::runtime_error("Failed to open packed dataset: " + filePath);
+
+    qint64 fileSize = dataset->file.size();
+
+    if (fileSize < static_cast<qint64>(kHeaderSize))
+      throw std::runtime_error("Packed dataset is truncated: " + filePath);
+
+    dataset->mapped = dataset->file.map(0, fileSize);
+
+    if (!dataset->mapped)
+      throw std::runtime_error("Failed to memory-map packed dataset: " + filePath);
+
+    FileHeader header;
+    std::memcpy(&header, dataset->mapped, sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+      throw std::runtime_error("Not a packed dataset file: " + filePath);
+
+    if (header.byteOrder != kByteOrderMark)
+      throw std::runtime_error("Packed dataset was written on a machine with a different byte order: " + filePath);
+
+    if (header.version != kVersion)
+      throw std::runtime_error("Unsupported packed dataset version " + std::to_string(header.version) + ": " +
+                               filePath);
+
+    if (header.fileSize != static_cast<uint64_t>(fileSize))
+      throw std::runtime_error("Packed dataset size does not match its header (truncated?): " + filePath);
+
+    // The regions must lie inside the file; sizes are checked by division so corrupt fields cannot overflow
+    ulong size = static_cast<ulong>(fileSize);
+    bool valid = header.inputType <= static_cast<uint32_t>(ElementType::UINT8);
+
+    if (valid && (header.inputC != 0 || header.inputH != 0 || header.inputW != 0)) {
+      valid = header.inputC > 0 && header.inputH > 0 && header.inputW > 0;
+      ulong planeSize = static_cast<ulong>(header.inputC) * static_cast<ulong>(header.inputH);
+      valid = valid && header.inputSize % planeSize == 0 &&
+              header.inputSize / planeSize == static_cast<ulong>(header.inputW);
+    }
+
+    ulong inputElementSize = elementSize(static_cast<ElementType>(header.inputType));
+    valid = valid && header.inputSize <= size / inputElementSize && header.outputSize <= size / sizeof(float);
+    valid = valid && header.inputOffset >= kHeaderSize && header.inputOffset <= header.outputOffset &&
+            header.outputOffset <= size;
+
+    if (valid) {
+      ulong inputStride = header.inputSize * inputElementSize;
+      ulong outputStride = header.outputSize * sizeof(float);
+
+      if (inputStride > 0 && header.numSamples > (header.outputOffset - header.inputOffset) / inputStride)
+        valid = false;
+
+      if (outputStride > 0 && header.numSamples > (size - header.outputOffset) / outputStride)
+        valid = false;
+    }
+
+    if (!valid)
+      throw std::runtime_error("Packed dataset is truncated: " + filePath);
+
+    Layout& layout = dataset->fileLayout;
+    layout.numSamples = header.numSamples;
+    layout.inputSize = header.inputSize;
+    layout.outputSize = header.outputSize;
+    layout.inputType = static_cast<ElementType>(header.inputType);
+    layout.inputC = header.inputC;
+    layout.inputH = header.inputH;
+    layout.inputW = header.inputW;
+    layout.outputC = header.outputC;
+    layout.outputH = header.outputH;
+    layout.outputW = header.outputW;
+
+    dataset->inputOffset = header.inputOffset;
+    dataset->outputOffset = header.outputOffset;
+    dataset->inputStride = layout.inputSize * elementSize(layout.inputType);
+    dataset->outputStride = layout.outputSize * sizeof(float);
+
+    return dataset;
+  }
+
+  //===================================================================================================================//
+
+  std::unique_ptr<PackedDataset> PackedDataset::create(const std::string& filePath, const Layout& layout)
+  {
+    std::unique_ptr<PackedDataset> dataset(new PackedDataset());
+    dataset->filePath = filePath;
+    dataset->fileLayout = layout;
+    dataset->writable = true;
+    dataset->inputStride = layout.inputSize * elementSize(layout.inputType);
+    dataset->outputStride = layout.outputSize * sizeof(float);
+    dataset->inputOffset = kHeaderSize;
+    dataset->outputOffset = alignUp(dataset->inputOffset + layout.numSamples * dataset->inputStride);
+    ulong fileSize = alignUp(dataset->outputOffset + layout.numSamples * dataset->outputStride);
+
+    dataset->file.setFileName(QString::fromStdString(filePath));
+
+    if (!dataset->file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+      throw std::runtime_error("Failed to open file for writing: " + filePath);
+
+    if (!dataset->file.resize(static_cast<qint64>(fileSize)))
+      throw std::runtime_error("Failed to allocate " + std::to_string(fileSize) + " bytes for: " + filePath);
+
+    dataset->mapped = dataset->file.map(0, static_cast<qint64>(fileSize));
+
+    if (!dataset->mapped)
+      throw std::runtime_error("Failed to memory-map file for writing: " + filePath);
+
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.inputType = static_cast<uint32_t>(layout.inputType);
+    header.numSamples = layout.numSamples;
+    header.inputSize = layout.inputSize;
+    header.outputSize = layout.outputSize;
+    header.inputC = layout.inputC;
+    header.inputH = layout.inputH;
+    header.inputW = layout.inputW;
+    header.outputC = layout.outputC;
+    header.outputH = layout.outputH;
+    header.outputW = layout.outputW;
+    header.inputOffset = dataset->inputOffset;
+    header.outputOffset = dataset->outputOffset;
+    header.fileSize = fileSize;
+    std::memcpy(dataset->mapped, &header, sizeof(header));
+
+    return dataset;
+  }
+
+  //===================================================================================================================//
+
+  void PackedDataset::readInput(ulong index, float* dst) const
+  {
+    const uchar* src = this->mapped + this->inputOffset + index * this->inputStride;
+    ulong n = this->fileLayout.inputSize;
+
+    if (this->fileLayout.inputType == ElementType::UINT8) {
+      PixelKernels::hwcToNCHW(src, dst, 1, n);
+    } else {
+      std::memcpy(dst, src, this->inputStride);
+    }
+  }
+
+  //===================================================================================================================//
+
+  void PackedDataset::readOutput(ulong index, float* dst) const
+  {
+    std::memcpy(dst, this->mapped + this->outputOffset + index * this->outputStride, this->outputStride);
+  }
+
+  //===================================================================================================================//
+
+  void PackedDataset::writeInput(ulong index, const float* src)
+  {
+    if (!this->writable)
+      throw std::runtime_error("Packed dataset is read-only: " + this->filePath);
+
+    uchar* dst = this->mapped + this->inputOffset + index * this->inputStride;
+    ulong n = this->fileLayout.inputSize;
+
+    if (this->fileLayout.inputType == ElementType::UINT8) {
+      PixelKernels::nchwToHWC(src, dst, 1, n);
+    } else {
+      std::memcpy(dst, src, this->inputStride);
+    }
+  }
+
+  //===================================================================================================================//
+
+  void PackedDataset::writeOutput(ulong index, const float* src)
+  {
+    if (!this->writable)
+      throw std::runtime_error("Packed dataset is read-only: " + this->filePath);
+
+    std::memcpy(this->mapped + this->outputOffset + index * this->outputStride, src, this->outputStride);
+  }
+
+  //===================================================================================================================//
+
+  void PackedDataset::finish()
+  {
+    if (this->mapped) {
+      this->file.unmap(this->mapped);
+      this->mapped = nullptr;
+    }
+
+    if (this->file.isOpen()) {
+      if (this->writable)
+        this->file.flush();
+      this->file.close();
+    }
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
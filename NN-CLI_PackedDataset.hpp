@@ -0,0 +1,95 @@
+#ifndef NN_CLI_PACKEDDATASET_HPP
+#define NN_CLI_PACKEDDATASET_HPP
+
+#include <QFile>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  using ulong = unsigned long;
+
+  /**
+ * PackedDataset: a whole dataset stored as one memory-mapped binary file (written by --mode convert).
+ *
+ * Layout (host byte order):
+ *   [header, 128 bytes][input tensor region, 64-byte aligned][output/label region, 64-byte aligned]
+ *
+ * Every sample occupies a fixed stride in each region, so sample i is located with a single multiply.
+ * Inputs are stored as float32, or as uint8 for image data (scaled by 1/255 on read).
+ * Outputs are always float32. Only the pages of the samples actually visited are read from disk.
+ */
+  class PackedDataset
+  {
+    public:
+      enum class ElementType : uint32_t { FLOAT32 = 0, UINT8 = 1 };
+
+      // Shape of the stored samples (C/H/W are 0 for plain vectors).
+      struct Layout {
+          ulong numSamples = 0;
+          ulong inputSize = 0;
+          ulong outputSize = 0;
+          ElementType inputType = ElementType::FLOAT32;
+          int inputC = 0, inputH = 0, inputW = 0;
+          int outputC = 0, outputH = 0, outputW = 0;
+      };
+
+      ~PackedDataset();
+
+      PackedDataset(const PackedDataset&) = delete;
+      PackedDataset& operator=(const PackedDataset&) = delete;
+
+      // Whether the file starts with the packed dataset magic (cheap: reads only the first bytes).
+      static bool isPackedFile(const std::string& filePath);
+
+      // Map an existing packed file read-only.
+      static std::unique_ptr<PackedDataset> open(const std::string& filePath);
+
+      // Create (or truncate) a packed file sized for the given layout and map it writable.
+      static std::unique_ptr<PackedDataset> create(const std::string& filePath, const Layout& layout);
+
+      const Layout& layout() const
+      {
+        return this->fileLayout;
+      }
+
+      ulong numSamples() const
+      {
+        return this->fileLayout.numSamples;
+      }
+
+      // Copy sample `index` into dst (inputSize / outputSize floats).
+      void readInput(ulong index, float* dst) const;
+      void readOutput(ulong index, float* dst) const;
+
+      // Store sample `index` (writable files only). Safe to call concurrently for different indices.
+      void writeInput(ulong index, const float* src);
+      void writeOutput(ulong index, const float* src);
+
+      // Flush and unmap a writable file. Called by the destructor if not called explicitly.
+      void finish();
+
+    private:
+      PackedDataset() = default;
+
+      std::string filePath;
+      QFile file;
+      uchar* mapped = nullptr;
+      bool writable = false;
+      Layout fileLayout;
+      ulong inputOffset = 0;
+      ulong outputOffset = 0;
+      ulong inputStride = 0; // bytes per sample in the input region
+      ulong outputStride = 0; // bytes per sample in the output region
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_PACKEDDATASET_HPP
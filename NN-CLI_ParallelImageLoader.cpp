@@ -0,0 +1,69 @@
+#include "NN-CLI_ParallelImageLoader.hpp"
+#include "NN-CLI_ImageLoader.hpp"
+#include "NN-CLI_ParallelTasks.hpp"
+
+#include <QThread>
+
+#include <stdexcept>
+#include <string>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  ParallelImageLoader::ParallelImageLoader(int numThreads)
+  {
+    this->pool.setMaxThreadCount((numThreads > 0) ? numThreads : QThread::idealThreadCount());
+  }
+
+  //===================================================================================================================//
+
+  void ParallelImageLoader::add(const std::string& imagePath, int c, int h, int w)
+  {
+    this->requests.push_back({imagePath, c, h, w});
+  }
+
+  //===================================================================================================================//
+
+  std::vector<std::vector<float>> ParallelImageLoader::loadAll(const std::string& label, ulong progressReports)
+  {
+    std::vector<std::vector<float>> images(this->requests.size());
+    std::vector<float*> destinations(images.size());
+
+    for (size_t i = 0; i < images.size(); i++) {
+      const Request& request = this->requests[i];
+      images[i].resize(static_cast<size_t>(request.c) * request.h * request.w);
+      destinations[i] = images[i].data();
+    }
+
+    this->loadAll(destinations, label, progressReports);
+    return images;
+  }
+
+  //===================================================================================================================//
+
+  void ParallelImageLoader::loadAll(const std::vector<float*>& destinations, const std::string& label,
+                                    ulong progressReports)
+  {
+    std::vector<Request> pending = std::move(this->requests);
+    this->requests.clear();
+
+    size_t total = pending.size();
+
+    if (destinations.size() != total)
+      throw std::runtime_error("ParallelImageLoader: " + std::to_string(destinations.size()) +
+                               " destinations for " + std::to_string(total) + " images");
+
+    ParallelTasks::run(
+      this->pool, total,
+      [&](size_t i) {
+        const Request& request = pending[i];
+        ImageLoader::loadImage(request.imagePath, request.c, request.h, request.w, destinations[i]);
+      },
+      label, progressReports);
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
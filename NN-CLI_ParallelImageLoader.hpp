@@ -0,0 +1,59 @@
+#ifndef NN_CLI_PARALLELIMAGELOADER_HPP
+#define NN_CLI_PARALLELIMAGELOADER_HPP
+
+#include <QThreadPool>
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * ParallelImageLoader: decodes a list of images on a pool of worker threads, returning them in request order.
+ *
+ * Used where a whole file of image paths is loaded up front (test and predict): the JSON is streamed first and every
+ * image path queued with add(), then loadAll() decodes them concurrently. Workers pull the next request from a shared
+ * counter, so slow images do not hold up a fixed share of the work, and each result is written to its own slot.
+ */
+  class ParallelImageLoader
+  {
+    public:
+      // numThreads: decode workers (0 = one per core).
+      explicit ParallelImageLoader(int numThreads = 0);
+
+      // Queue an image; its NCHW floats end up at the same position in the result of loadAll().
+      void add(const std::string& imagePath, int c, int h, int w);
+
+      size_t size() const
+      {
+        return this->requests.size();
+      }
+
+      // Decode every queued image (see ImageLoader::loadImage) and clear the queue.
+      // Progress is printed as images complete, under a lock so the count never goes backwards.
+      // If any image fails, the remaining ones are skipped and the first error is rethrown.
+      std::vector<std::vector<float>> loadAll(const std::string& label, ulong progressReports = 1000);
+
+      // Same, decoding the i-th queued image straight into destinations[i] (c * h * w floats, allocated by the caller)
+      void loadAll(const std::vector<float*>& destinations, const std::string& label, ulong progressReports = 1000);
+
+    private:
+      struct Request {
+          std::string imagePath;
+          int c, h, w;
+      };
+
+      std::vector<Request> requests;
+      QThreadPool pool;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_PARALLELIMAGELOADER_HPP
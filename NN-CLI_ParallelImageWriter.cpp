@@ -0,0 +1,42 @@
+#include "NN-CLI_ParallelImageWriter.hpp"
+#include "NN-CLI_ImageLoader.hpp"
+#include "NN-CLI_ParallelTasks.hpp"
+
+#include <QThread>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  ParallelImageWriter::ParallelImageWriter(int numThreads, int jpegQuality) : jpegQuality(jpegQuality)
+  {
+    this->pool.setMaxThreadCount((numThreads > 0) ? numThreads : QThread::idealThreadCount());
+  }
+
+  //===================================================================================================================//
+
+  void ParallelImageWriter::add(const std::string& imagePath, const std::vector<float>& data, int c, int h, int w)
+  {
+    this->requests.push_back({imagePath, &data, c, h, w});
+  }
+
+  //===================================================================================================================//
+
+  void ParallelImageWriter::saveAll(const std::string& label, ulong progressReports)
+  {
+    std::vector<Request> pending = std::move(this->requests);
+    this->requests.clear();
+
+    ParallelTasks::run(
+      this->pool, pending.size(),
+      [&](size_t i) {
+        const Request& request = pending[i];
+        ImageLoader::saveImage(request.imagePath, *request.data, request.c, request.h, request.w, this->jpegQuality);
+      },
+      label, progressReports);
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,57 @@
+#ifndef NN_CLI_PARALLELIMAGEWRITER_HPP
+#define NN_CLI_PARALLELIMAGEWRITER_HPP
+
+#include <QThreadPool>
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * ParallelImageWriter: encodes and saves a list of images on a pool of worker threads.
+ *
+ * The write-side counterpart of ParallelImageLoader, used for predict's image outputs: every image is queued with
+ * add(), then saveAll() converts and compresses them concurrently. PNG deflate dominates the cost, so the encoding
+ * settings (ImageLoader::setPngCompressionLevel, jpegQuality) are the other lever on throughput.
+ */
+  class ParallelImageWriter
+  {
+    public:
+      // numThreads: encode workers (0 = one per core). jpegQuality: 1-100, for .jpg/.jpeg paths.
+      explicit ParallelImageWriter(int numThreads = 0, int jpegQuality = 90);
+
+      // Queue an image. `data` (NCHW floats in [0,1]) is not copied and must stay alive until saveAll() returns.
+      void add(const std::string& imagePath, const std::vector<float>& data, int c, int h, int w);
+
+      size_t size() const
+      {
+        return this->requests.size();
+      }
+
+      // Save every queued image (see ImageLoader::saveImage) and clear the queue.
+      // If any image fails, the remaining ones are skipped and the first error is rethrown.
+      void saveAll(const std::string& label, ulong progressReports = 1000);
+
+    private:
+      struct Request {
+          std::string imagePath;
+          const std::vector<float>* data;
+          int c, h, w;
+      };
+
+      std::vector<Request> requests;
+      int jpegQuality;
+      QThreadPool pool;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_PARALLELIMAGEWRITER_HPP
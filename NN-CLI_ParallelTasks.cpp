@@ -0,0 +1,69 @@
+#include "NN-CLI_ParallelTasks.hpp"
+#include "NN-CLI_ProgressBar.hpp"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  void ParallelTasks::run(QThreadPool& pool, size_t total, const std::function<void(size_t index)>& task,
+                          const std::string& label, ulong progressReports)
+  {
+    if (total == 0)
+      return;
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr firstError;
+
+    std::mutex progressMutex;
+    size_t completed = 0;
+
+    int numThreads = static_cast<int>(std::min<size_t>(total, pool.maxThreadCount()));
+
+    QVector<QFuture<void>> futures;
+    futures.reserve(numThreads);
+
+    for (int t = 0; t < numThreads; t++) {
+      futures.append(QtConcurrent::run(&pool, [&]() {
+        while (!failed.load(std::memory_order_relaxed)) {
+          size_t i = next.fetch_add(1, std::memory_order_relaxed);
+
+          if (i >= total)
+            return;
+
+          try {
+            task(i);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+
+            if (!firstError)
+              firstError = std::current_exception();
+
+            failed.store(true, std::memory_order_relaxed);
+            return;
+          }
+
+          std::lock_guard<std::mutex> lock(progressMutex);
+          ProgressBar::printLoadingProgress(label, ++completed, total, progressReports);
+        }
+      }));
+    }
+
+    for (auto& f : futures)
+      f.waitForFinished();
+
+    if (firstError)
+      std::rethrow_exception(firstError);
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,36 @@
+#ifndef NN_CLI_PARALLELTASKS_HPP
+#define NN_CLI_PARALLELTASKS_HPP
+
+#include <QThreadPool>
+
+#include <functional>
+#include <string>
+
+#include <sys/types.h>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * ParallelTasks: runs a numbered list of independent tasks on a pool of worker threads (the loop shared by
+ * ParallelImageLoader and ParallelImageWriter).
+ *
+ * Workers pull the next index from a shared counter, so slow tasks do not hold up a fixed share of the work.
+ */
+  class ParallelTasks
+  {
+    public:
+      // Call task(i) for every i in [0, total) and wait for all of them.
+      // Progress is printed as tasks complete, under a lock so the count never goes backwards.
+      // If any task throws, the remaining ones are skipped and the first error is rethrown.
+      static void run(QThreadPool& pool, size_t total, const std::function<void(size_t index)>& task,
+                      const std::string& label, ulong progressReports);
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_PARALLELTASKS_HPP
@@ -0,0 +1,514 @@
+#include "NN-CLI_PixelKernels.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define NN_CLI_PIXELKERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  namespace
+  {
+    //-- Scalar (also converts what the vector kernels leave over, from pixel `first` on) --//
+
+    void hwcToNCHWScalar(const unsigned char* pixels, float* data, int c, size_t planeSize, size_t first)
+    {
+      for (size_t p = first; p < planeSize; p++)
+        for (int ch = 0; ch < c; ch++)
+          data[ch * planeSize + p] = static_cast<float>(pixels[p * c + ch]) / 255.0f;
+    }
+
+    void nchwToHWCScalar(const float* data, unsigned char* pixels, int c, size_t planeSize, size_t first)
+    {
+      for (size_t p = first; p < planeSize; p++) {
+        for (int ch = 0; ch < c; ch++) {
+          float val = std::max(0.0f, std::min(1.0f, data[ch * planeSize + p]));
+          pixels[p * c + ch] = static_cast<unsigned char>(val * 255.0f + 0.5f);
+        }
+      }
+    }
+
+#ifdef NN_CLI_PIXELKERNELS_X86
+
+#define NN_CLI_TARGET_SSE2 __attribute__((target("sse2")))
+#define NN_CLI_TARGET_AVX2 __attribute__((target("avx2")))
+#define NN_CLI_TARGET_AVX512 __attribute__((target("avx512f")))
+
+    // Which lane of which source vector each lane of c destination vectors of `lanes` floats comes from, when
+    // (de)interleaving c channels: lane l of destination d is lane index[d][l] of source vector source[d][l]
+    struct LanePlan {
+        int index[4][16];
+        int source[4][16];
+    };
+
+    // Destination: c planar vectors (one per channel). Source: c vectors of interleaved pixels.
+    LanePlan deinterleavePlan(int c, int lanes)
+    {
+      LanePlan plan = {};
+
+      for (int ch = 0; ch < c; ch++) {
+        for (int l = 0; l < lanes; l++) {
+          int element = l * c + ch;
+          plan.source[ch][l] = element / lanes;
+          plan.index[ch][l] = element % lanes;
+        }
+      }
+
+      return plan;
+    }
+
+    // Destination: c vectors of interleaved pixels. Source: c planar vectors (one per channel).
+    LanePlan interleavePlan(int c, int lanes)
+    {
+      LanePlan plan = {};
+
+      for (int d = 0; d < c; d++) {
+        for (int l = 0; l < lanes; l++) {
+          int element = d * lanes + l;
+          plan.source[d][l] = element % c;
+          plan.index[d][l] = element / c;
+        }
+      }
+
+      return plan;
+    }
+
+    //-- SSE2: 16 pixels per iteration, shuffled 4 at a time --//
+
+    // 16 bytes -> 4 vectors of [0, 1] floats
+    NN_CLI_TARGET_SSE2 inline void loadSSE2(const unsigned char* src, __m128* out)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128 scale = _mm_set1_ps(255.0f);
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      __m128i low = _mm_unpacklo_epi8(bytes, zero);
+      __m128i high = _mm_unpackhi_epi8(bytes, zero);
+      out[0] = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale);
+      out[1] = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale);
+      out[2] = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale);
+      out[3] = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale);
+    }
+
+    // 4 vectors of floats -> 16 bytes, clamped to [0, 1] and rounded like the scalar loop
+    NN_CLI_TARGET_SSE2 inline void storeSSE2(const __m128* in, unsigned char* dst)
+    {
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 one = _mm_set1_ps(1.0f);
+      const __m128 scale = _mm_set1_ps(255.0f);
+      const __m128 half = _mm_set1_ps(0.5f);
+      __m128i values[4];
+
+      // min(x, 1) then max(x, 0) maps NaN to 1, like std::max(0, std::min(1, x))
+      for (int k = 0; k < 4; k++)
+        values[k] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_max_ps(_mm_min_ps(in[k], one), zero), scale), half));
+
+      __m128i words = _mm_packs_epi32(values[0], values[1]);
+      __m128i moreWords = _mm_packs_epi32(values[2], values[3]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(words, moreWords));
+    }
+
+    // r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3 -> r0-3 | g0-3 | b0-3
+    NN_CLI_TARGET_SSE2 inline void deinterleave3SSE2(const __m128* in, __m128* out)
+    {
+      __m128 a = in[0], b = in[1], c = in[2];
+      out[0] = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+      __m128 gLow = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)); // g0 . g1 .
+      __m128 gHigh = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)); // g2 . g3 .
+      out[1] = _mm_shuffle_ps(gLow, gHigh, _MM_SHUFFLE(2, 0, 2, 0));
+      out[2] = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+    }
+
+    // r0-3 | g0-3 | b0-3 -> r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3
+    NN_CLI_TARGET_SSE2 inline void interleave3SSE2(const __m128* in, __m128* out)
+    {
+      __m128 r = in[0], g = in[1], b = in[2];
+      __m128 b0r1 = _mm_shuffle_ps(b, r, _MM_SHUFFLE(0, 1, 0, 0)); // b0 . r1 .
+      __m128 b2r3 = _mm_shuffle_ps(b, r, _MM_SHUFFLE(0, 3, 0, 2)); // b2 . r3 .
+      out[0] = _mm_shuffle_ps(_mm_unpacklo_ps(r, g), b0r1, _MM_SHUFFLE(2, 0, 1, 0));
+      out[1] = _mm_shuffle_ps(_mm_unpacklo_ps(g, b), _mm_unpackhi_ps(r, g), _MM_SHUFFLE(1, 0, 3, 2));
+      out[2] = _mm_shuffle_ps(b2r3, _mm_unpackhi_ps(g, b), _MM_SHUFFLE(3, 2, 2, 0));
+    }
+
+    // 4 pixels of 4 channels <-> 4 channels of 4 pixels (its own inverse)
+    NN_CLI_TARGET_SSE2 inline void transpose4SSE2(const __m128* in, __m128* out)
+    {
+      __m128 r0 = in[0], r1 = in[1], r2 = in[2], r3 = in[3];
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      out[0] = r0;
+      out[1] = r1;
+      out[2] = r2;
+      out[3] = r3;
+    }
+
+    template <int C>
+    NN_CLI_TARGET_SSE2 size_t hwcToNCHWSSE2(const unsigned char* pixels, float* data, size_t planeSize)
+    {
+      size_t p = 0;
+
+      for (; p + 16 <= planeSize; p += 16) {
+        // C 16-byte loads give 4C vectors of interleaved floats, 4 pixels in every C of them
+        __m128 interleaved[4 * C];
+
+        for (int k = 0; k < C; k++)
+          loadSSE2(pixels + p * C + 16 * k, interleaved + 4 * k);
+
+        for (int g = 0; g < 4; g++) {
+          __m128 planar[C];
+
+          if constexpr (C == 1)
+            planar[0] = interleaved[g];
+          else if constexpr (C == 3)
+            deinterleave3SSE2(interleaved + 3 * g, planar);
+          else
+            transpose4SSE2(interleaved + 4 * g, planar);
+
+          for (int ch = 0; ch < C; ch++)
+            _mm_storeu_ps(data + ch * planeSize + p + 4 * g, planar[ch]);
+        }
+      }
+
+      return p;
+    }
+
+    template <int C>
+    NN_CLI_TARGET_SSE2 size_t nchwToHWCSSE2(const float* data, unsigned char* pixels, size_t planeSize)
+    {
+      size_t p = 0;
+
+      for (; p + 16 <= planeSize; p += 16) {
+        __m128 interleaved[4 * C];
+
+        for (int g = 0; g < 4; g++) {
+          __m128 planar[C];
+
+          for (int ch = 0; ch < C; ch++)
+            planar[ch] = _mm_loadu_ps(data + ch * planeSize + p + 4 * g);
+
+          if constexpr (C == 1)
+            interleaved[g] = planar[0];
+          else if constexpr (C == 3)
+            interleave3SSE2(planar, interleaved + 3 * g);
+          else
+            transpose4SSE2(planar, interleaved + 4 * g);
+        }
+
+        for (int k = 0; k < C; k++)
+          storeSSE2(interleaved + 4 * k, pixels + p * C + 16 * k);
+      }
+
+      return p;
+    }
+
+    //-- AVX2: 8 pixels per iteration, lanes permuted and blended across vectors as the plan says --//
+
+    NN_CLI_TARGET_AVX2 inline __m256 loadAVX2(const unsigned char* src)
+    {
+      __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+      return _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), _mm256_set1_ps(255.0f));
+    }
+
+    NN_CLI_TARGET_AVX2 inline void storeAVX2(__m256 in, unsigned char* dst)
+    {
+      __m256 clamped = _mm256_max_ps(_mm256_min_ps(in, _mm256_set1_ps(1.0f)), _mm256_setzero_ps());
+      __m256i values =
+        _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clamped, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+      __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(words, words));
+    }
+
+    // Vector d of the destination, gathered from the C source vectors
+    template <int C>
+    NN_CLI_TARGET_AVX2 inline __m256 permuteAVX2(const __m256* source, const __m256i* index,
+                                                 const __m256 (*fromSource)[C], int d)
+    {
+      __m256 result = _mm256_permutevar8x32_ps(source[0], index[d]);
+
+      for (int s = 1; s < C; s++)
+        result = _mm256_blendv_ps(result, _mm256_permutevar8x32_ps(source[s], index[d]), fromSource[d][s]);
+
+      return result;
+    }
+
+    template <int C>
+    NN_CLI_TARGET_AVX2 void setUpAVX2(const LanePlan& plan, __m256i* index, __m256 (*fromSource)[C])
+    {
+      for (int d = 0; d < C; d++) {
+        index[d] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(plan.index[d]));
+        __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(plan.source[d]));
+
+        for (int s = 0; s < C; s++)
+          fromSource[d][s] = _mm256_castsi256_ps(_mm256_cmpeq_epi32(source, _mm256_set1_epi32(s)));
+      }
+    }
+
+    template <int C>
+    NN_CLI_TARGET_AVX2 size_t hwcToNCHWAVX2(const unsigned char* pixels, float* data, size_t planeSize)
+    {
+      __m256i index[C];
+      __m256 fromSource[C][C];
+      setUpAVX2<C>(deinterleavePlan(C, 8), index, fromSource);
+      size_t p = 0;
+
+      for (; p + 8 <= planeSize; p += 8) {
+        __m256 interleaved[C];
+
+        for (int k = 0; k < C; k++)
+          interleaved[k] = loadAVX2(pixels + p * C + 8 * k);
+
+        for (int ch = 0; ch < C; ch++)
+          _mm256_storeu_ps(data + ch * planeSize + p,
+                           C == 1 ? interleaved[0] : permuteAVX2<C>(interleaved, index, fromSource, ch));
+      }
+
+      return p;
+    }
+
+    template <int C>
+    NN_CLI_TARGET_AVX2 size_t nchwToHWCAVX2(const float* data, unsigned char* pixels, size_t planeSize)
+    {
+      __m256i index[C];
+      __m256 fromSource[C][C];
+      setUpAVX2<C>(interleavePlan(C, 8), index, fromSource);
+      size_t p = 0;
+
+      for (; p + 8 <= planeSize; p += 8) {
+        __m256 planar[C];
+
+        for (int ch = 0; ch < C; ch++)
+          planar[ch] = _mm256_loadu_ps(data + ch * planeSize + p);
+
+        for (int k = 0; k < C; k++)
+          storeAVX2(C == 1 ? planar[0] : permuteAVX2<C>(planar, index, fromSource, k), pixels + p * C + 8 * k);
+      }
+
+      return p;
+    }
+
+    //-- AVX-512: 16 pixels per iteration, same plan with masked permutes --//
+
+    NN_CLI_TARGET_AVX512 inline __m512 loadAVX512(const unsigned char* src)
+    {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      return _mm512_div_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes)), _mm512_set1_ps(255.0f));
+    }
+
+    NN_CLI_TARGET_AVX512 inline void storeAVX512(__m512 in, unsigned char* dst)
+    {
+      __m512 clamped = _mm512_max_ps(_mm512_min_ps(in, _mm512_set1_ps(1.0f)), _mm512_setzero_ps());
+      // Explicit rounding keeps the compiler from fusing these into an FMA (AVX-512 implies FMA), which would round
+      // differently from the scalar loop
+      const int rounding = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+      __m512 scaled = _mm512_mul_round_ps(clamped, _mm512_set1_ps(255.0f), rounding);
+      __m512i values = _mm512_cvttps_epi32(_mm512_add_round_ps(scaled, _mm512_set1_ps(0.5f), rounding));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm512_cvtusepi32_epi8(values));
+    }
+
+    template <int C>
+    NN_CLI_TARGET_AVX512 inline __m512 permuteAVX512(const __m512* source, const __m512i* index,
+                                                     const __mmask16 (*fromSource)[C], int d)
+    {
+      __m512 result = _mm512_permutexvar_ps(index[d], source[0]);
+
+      for (int s = 1; s < C; s++)
+        result = _mm512_mask_permutexvar_ps(result, fromSource[d][s], index[d], source[s]);
+
+      return result;
+    }
+
+    template <int C>
+    NN_CLI_TARGET_AVX512 void setUpAVX512(const LanePlan& plan, __m512i* index, __mmask16 (*fromSource)[C])
+    {
+      for (int d = 0; d < C; d++) {
+        index[d] = _mm512_loadu_si512(plan.index[d]);
+        __m512i source = _mm512_loadu_si512(plan.source[d]);
+
+        for (int s = 0; s < C; s++)
+          fromSource[d][s] = _mm512_cmpeq_epi32_mask(source, _mm512_set1_epi32(s));
+      }
+    }
+
+    template <int C>
+    NN_CLI_TARGET_AVX512 size_t hwcToNCHWAVX512(const unsigned char* pixels, float* data, size_t planeSize)
+    {
+      __m512i index[C];
+      __mmask16 fromSource[C][C];
+      setUpAVX512<C>(deinterleavePlan(C, 16), index, fromSource);
+      size_t p = 0;
+
+      for (; p + 16 <= planeSize; p += 16) {
+        __m512 interleaved[C];
+
+        for (int k = 0; k < C; k++)
+          interleaved[k] = loadAVX512(pixels + p * C + 16 * k);
+
+        for (int ch = 0; ch < C; ch++)
+          _mm512_storeu_ps(data + ch * planeSize + p,
+                           C == 1 ? interleaved[0] : permuteAVX512<C>(interleaved, index, fromSource, ch));
+      }
+
+      return p;
+    }
+
+    template <int C>
+    NN_CLI_TARGET_AVX512 size_t nchwToHWCAVX512(const float* data, unsigned char* pixels, size_t planeSize)
+    {
+      __m512i index[C];
+      __mmask16 fromSource[C][C];
+      setUpAVX512<C>(interleavePlan(C, 16), index, fromSource);
+      size_t p = 0;
+
+      for (; p + 16 <= planeSize; p += 16) {
+        __m512 planar[C];
+
+        for (int ch = 0; ch < C; ch++)
+          planar[ch] = _mm512_loadu_ps(data + ch * planeSize + p);
+
+        for (int k = 0; k < C; k++)
+          storeAVX512(C == 1 ? planar[0] : permuteAVX512<C>(planar, index, fromSource, k), pixels + p * C + 16 * k);
+      }
+
+      return p;
+    }
+
+    //-- Dispatch --//
+
+    // Pixels converted by the vector kernel (the scalar loop does the rest)
+    template <int C>
+    size_t hwcToNCHWVector(const unsigned char* pixels, float* data, size_t planeSize, PixelKernels::ISA isa)
+    {
+      switch (isa) {
+        case PixelKernels::ISA::AVX512:
+          return hwcToNCHWAVX512<C>(pixels, data, planeSize);
+        case PixelKernels::ISA::AVX2:
+          return hwcToNCHWAVX2<C>(pixels, data, planeSize);
+        case PixelKernels::ISA::SSE2:
+          return hwcToNCHWSSE2<C>(pixels, data, planeSize);
+        default:
+          return 0;
+      }
+    }
+
+    template <int C>
+    size_t nchwToHWCVector(const float* data, unsigned char* pixels, size_t planeSize, PixelKernels::ISA isa)
+    {
+      switch (isa) {
+        case PixelKernels::ISA::AVX512:
+          return nchwToHWCAVX512<C>(data, pixels, planeSize);
+        case PixelKernels::ISA::AVX2:
+          return nchwToHWCAVX2<C>(data, pixels, planeSize);
+        case PixelKernels::ISA::SSE2:
+          return nchwToHWCSSE2<C>(data, pixels, planeSize);
+        default:
+          return 0;
+      }
+    }
+
+#endif // NN_CLI_PIXELKERNELS_X86
+
+    void checkSupported(PixelKernels::ISA isa)
+    {
+      if (isa > PixelKernels::detectISA())
+        throw std::runtime_error("Instruction set " + PixelKernels::isaName(isa) + " is not supported by this CPU");
+    }
+  }
+
+  //===================================================================================================================//
+
+  PixelKernels::ISA PixelKernels::detectISA()
+  {
+#ifdef NN_CLI_PIXELKERNELS_X86
+    static const ISA isa = []() {
+      __builtin_cpu_init();
+
+      if (__builtin_cpu_supports("avx512f"))
+        return ISA::AVX512;
+
+      if (__builtin_cpu_supports("avx2"))
+        return ISA::AVX2;
+
+      return ISA::SSE2; // Part of x86-64 itself
+    }();
+
+    return isa;
+#else
+    return ISA::SCALAR;
+#endif
+  }
+
+  //===================================================================================================================//
+
+  std::string PixelKernels::isaName(ISA isa)
+  {
+    switch (isa) {
+      case ISA::SSE2:
+        return "sse2";
+      case ISA::AVX2:
+        return "avx2";
+      case ISA::AVX512:
+        return "avx512";
+      default:
+        return "scalar";
+    }
+  }
+
+  //===================================================================================================================//
+
+  void PixelKernels::hwcToNCHW(const unsigned char* pixels, float* data, int c, size_t planeSize)
+  {
+    hwcToNCHW(pixels, data, c, planeSize, detectISA());
+  }
+
+  //===================================================================================================================//
+
+  void PixelKernels::hwcToNCHW(const unsigned char* pixels, float* data, int c, size_t planeSize, ISA isa)
+  {
+    checkSupported(isa);
+    size_t done = 0;
+
+#ifdef NN_CLI_PIXELKERNELS_X86
+    if (c == 1)
+      done = hwcToNCHWVector<1>(pixels, data, planeSize, isa);
+    else if (c == 3)
+      done = hwcToNCHWVector<3>(pixels, data, planeSize, isa);
+    else if (c == 4)
+      done = hwcToNCHWVector<4>(pixels, data, planeSize, isa);
+#endif
+
+    hwcToNCHWScalar(pixels, data, c, planeSize, done);
+  }
+
+  //===================================================================================================================//
+
+  void PixelKernels::nchwToHWC(const float* data, unsigned char* pixels, int c, size_t planeSize)
+  {
+    nchwToHWC(data, pixels, c, planeSize, detectISA());
+  }
+
+  //===================================================================================================================//
+
+  void PixelKernels::nchwToHWC(const float* data, unsigned char* pixels, int c, size_t planeSize, ISA isa)
+  {
+    checkSupported(isa);
+    size_t done = 0;
+
+#ifdef NN_CLI_PIXELKERNELS_X86
+    if (c == 1)
+      done = nchwToHWCVector<1>(data, pixels, planeSize, isa);
+    else if (c == 3)
+      done = nchwToHWCVector<3>(data, pixels, planeSize, isa);
+    else if (c == 4)
+      done = nchwToHWCVector<4>(data, pixels, planeSize, isa);
+#endif
+
+    nchwToHWCScalar(data, pixels, c, planeSize, done);
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,42 @@
+#ifndef NN_CLI_PIXELKERNELS_HPP
+#define NN_CLI_PIXELKERNELS_HPP
+
+#include <cstddef>
+#include <string>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * PixelKernels: conversions between interleaved HWC uint8 pixels (as stb decodes and encodes them) and planar NCHW
+ * float data normalised to [0, 1].
+ *
+ * 1-, 3- and 4-channel images are converted with SSE2, AVX2 or AVX-512 kernels, whichever is the best this CPU
+ * supports (detected once, at run time). Other channel counts, other CPUs and the pixels left over after the last
+ * full vector use the scalar loop. Every instruction set produces exactly the same values as the scalar loop.
+ */
+  class PixelKernels
+  {
+    public:
+      enum class ISA { SCALAR, SSE2, AVX2, AVX512 };
+
+      // Best instruction set supported by both this build and this CPU
+      static ISA detectISA();
+      static std::string isaName(ISA isa);
+
+      // data[ch * planeSize + p] = pixels[p * c + ch] / 255
+      static void hwcToNCHW(const unsigned char* pixels, float* data, int c, size_t planeSize);
+      static void hwcToNCHW(const unsigned char* pixels, float* data, int c, size_t planeSize, ISA isa);
+
+      // pixels[p * c + ch] = clamp(data[ch * planeSize + p], 0, 1) * 255, rounded (NaN saves as 255)
+      static void nchwToHWC(const float* data, unsigned char* pixels, int c, size_t planeSize);
+      static void nchwToHWC(const float* data, unsigned char* pixels, int c, size_t planeSize, ISA isa);
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_PIXELKERNELS_HPP
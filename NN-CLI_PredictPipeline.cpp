@@ -0,0 +1,184 @@
+#include "NN-CLI_PredictPipeline.hpp"
+#include "NN-CLI_BoundedQueue.hpp"
+#include "NN-CLI_JsonStream.hpp"
+#include "NN-CLI_ProgressBar.hpp"
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  namespace
+  {
+    struct PendingInput {
+        ulong index = 0;
+        nlohmann::json entry;
+    };
+
+    struct FinishedOutput {
+        ulong index = 0;
+        std::vector<float> output;
+    };
+
+    // Thrown out of the JSON stream callback to stop reading once another stage has failed
+    struct Cancelled {
+    };
+  }
+
+  //===================================================================================================================//
+
+  PredictPipeline::PredictPipeline(int numWorkers, ulong window)
+    : numWorkers(std::max(1, numWorkers)), window(std::max<ulong>(1, window))
+  {
+  }
+
+  //===================================================================================================================//
+
+  ulong PredictPipeline::run(QFile& file, const std::string& arrayKey, const PredictFunction& predict,
+                             const WriteFunction& write, ulong progressReports)
+  {
+    return this->run(file, arrayKey, predict, FinishFunction(), write, progressReports);
+  }
+
+  //===================================================================================================================//
+
+  ulong PredictPipeline::run(QFile& file, const std::string& arrayKey, const PredictFunction& predict,
+                             const FinishFunction& finish, const WriteFunction& write, ulong progressReports)
+  {
+    BoundedQueue<PendingInput> inputs(this->window);
+    BoundedQueue<FinishedOutput> outputs(this->window);
+
+    // In-flight accounting: the reader takes a slot per input, the writer returns it once the output is written
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    ulong inFlight = 0;
+    bool failed = false;
+    std::exception_ptr firstError;
+
+    auto fail = [&](std::exception_ptr error) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!firstError)
+          firstError = error;
+
+        failed = true;
+      }
+
+      slotFreed.notify_all();
+      inputs.close();
+      outputs.close();
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(this->numWorkers + 1);
+
+    //-- Workers --//
+    std::atomic<int> workersLeft{this->numWorkers};
+    QVector<QFuture<void>> futures;
+
+    for (int w = 0; w < this->numWorkers; w++) {
+      futures.append(QtConcurrent::run(&pool, [&, w]() {
+        try {
+          PendingInput pending;
+
+          while (inputs.pop(pending)) {
+            std::vector<float> output = predict(w, pending.entry);
+
+            if (finish)
+              finish(pending.index, output);
+
+            if (!outputs.push({pending.index, std::move(output)}))
+              break;
+          }
+        } catch (...) {
+          fail(std::current_exception());
+        }
+
+        // The last worker out ends the writer's stream
+        if (workersLeft.fetch_sub(1) == 1)
+          outputs.close();
+      }));
+    }
+
+    //-- Writer --//
+    futures.append(QtConcurrent::run(&pool, [&]() {
+      try {
+        std::map<ulong, std::vector<float>> reorder; // Outputs that overtook an earlier, slower input
+        ulong nextIndex = 0;
+        FinishedOutput finished;
+
+        while (outputs.pop(finished)) {
+          reorder.emplace(finished.index, std::move(finished.output));
+
+          for (auto it = reorder.begin(); it != reorder.end() && it->first == nextIndex; it = reorder.erase(it)) {
+            write(nextIndex++, it->second);
+
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              inFlight--;
+            }
+
+            slotFreed.notify_one();
+          }
+        }
+      } catch (...) {
+        fail(std::current_exception());
+      }
+    }));
+
+    //-- Reader --//
+    ulong numInputs = 0;
+
+    try {
+      JsonStream::forEachRecord(
+        file, arrayKey,
+        [&](const nlohmann::json& entry) {
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotFreed.wait(lock, [&]() { return failed || inFlight < this->window; });
+
+            if (failed)
+              throw Cancelled();
+
+            inFlight++;
+          }
+
+          if (!inputs.push({numInputs, entry}))
+            throw Cancelled();
+
+          numInputs++;
+        },
+        [&](size_t count, size_t bytesRead, size_t bytesTotal) {
+          ProgressBar::printStreamingProgress("Streaming inputs:", count, bytesRead, bytesTotal, progressReports);
+        });
+    } catch (const Cancelled&) {
+      // Another stage failed; its error is rethrown below
+    } catch (...) {
+      fail(std::current_exception());
+    }
+
+    inputs.close();
+
+    for (auto& f : futures)
+      f.waitForFinished();
+
+    if (firstError)
+      std::rethrow_exception(firstError);
+
+    return numInputs;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
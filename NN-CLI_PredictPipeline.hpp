@@ -0,0 +1,64 @@
+#ifndef NN_CLI_PREDICTPIPELINE_HPP
+#define NN_CLI_PREDICTPIPELINE_HPP
+
+#include <QFile>
+
+#include <json.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * PredictPipeline: streaming predict in three concurrent stages, for input files of any size.
+ *
+ *   reader (calling thread)  streams the inputs array element by element, or a JSON Lines file line by line
+ *   workers (numWorkers)     turn each element into an output: decode the image or vector, predict, then run the
+ *                            optional finish callback (work that needs no order, such as encoding an output image)
+ *   writer (one thread)      receives outputs, restores input order and hands them to the write callback
+ *
+ * The stages are connected by BoundedQueues, and the reader may only run `window` inputs ahead of the writer, so
+ * memory stays constant however many inputs there are, and the first result is written as soon as it is ready.
+ * If any stage throws, the others are stopped and the first error is rethrown from run().
+ */
+  class PredictPipeline
+  {
+    public:
+      // Runs on worker `worker` (0 .. numWorkers - 1); may be called concurrently for different workers.
+      using PredictFunction = std::function<std::vector<float>(int worker, const nlohmann::json& entry)>;
+
+      // Runs on the worker that predicted the input, in any order; may be called concurrently.
+      using FinishFunction = std::function<void(ulong index, const std::vector<float>& output)>;
+
+      // Runs on the writer thread, once per input, in input order.
+      using WriteFunction = std::function<void(ulong index, const std::vector<float>& output)>;
+
+      // window: maximum number of inputs between being read and being written.
+      PredictPipeline(int numWorkers, ulong window);
+
+      // Stream every element of the top-level array `arrayKey` (every line, for a .jsonl file) through the stages.
+      // Returns the number of inputs.
+      ulong run(QFile& file, const std::string& arrayKey, const PredictFunction& predict, const WriteFunction& write,
+                ulong progressReports = 1000);
+
+      // Same, calling finish for each output on its worker before the output goes to the writer.
+      ulong run(QFile& file, const std::string& arrayKey, const PredictFunction& predict, const FinishFunction& finish,
+                const WriteFunction& write, ulong progressReports = 1000);
+
+    private:
+      int numWorkers;
+      ulong window;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_PREDICTPIPELINE_HPP
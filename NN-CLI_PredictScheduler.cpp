@@ -0,0 +1,196 @@
+#include "NN-CLI_PredictScheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  template <typename InputT, typename OutputT>
+  PredictScheduler<InputT, OutputT>::PredictScheduler(int numWorkers, ulong maxBatchSize,
+                                                      std::chrono::microseconds maxWait, ulong maxQueueSize,
+                                                      std::chrono::microseconds admissionTimeout,
+                                                      BatchFunction predictBatch)
+    : maxBatchSize(std::max<ulong>(1, maxBatchSize)),
+      maxWait(std::max(std::chrono::microseconds(0), maxWait)),
+      maxQueueSize(std::max<ulong>(1, maxQueueSize)),
+      admissionTimeout(std::max(std::chrono::microseconds(0), admissionTimeout)),
+      predictBatch(std::move(predictBatch))
+  {
+    for (int w = 0; w < std::max(1, numWorkers); w++)
+      this->workers.emplace_back([this, w]() { this->work(w); });
+  }
+
+  //===================================================================================================================//
+
+  template <typename InputT, typename OutputT>
+  PredictScheduler<InputT, OutputT>::~PredictScheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->stopping = true;
+    }
+
+    this->inputQueued.notify_all();
+    this->roomFreed.notify_all();
+
+    for (std::thread& worker : this->workers)
+      worker.join();
+  }
+
+  //===================================================================================================================//
+
+  template <typename InputT, typename OutputT>
+  std::vector<OutputT> PredictScheduler<InputT, OutputT>::submit(std::vector<InputT> inputs, PredictLatency* latency)
+  {
+    auto request = std::make_shared<Request>();
+    request->submitTime = Clock::now();
+
+    if (inputs.empty())
+      return {};
+
+    if (inputs.size() > this->maxQueueSize)
+      throw std::runtime_error("Request of " + std::to_string(inputs.size()) + " inputs exceeds the queue size (" +
+                               std::to_string(this->maxQueueSize) + ")");
+
+    request->outputs.resize(inputs.size());
+    request->remaining = inputs.size();
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    //-- Admission: wait for room, up to admissionTimeout --//
+    bool admitted = this->roomFreed.wait_for(lock, this->admissionTimeout, [&]() {
+      return this->stopping || this->queue.size() + inputs.size() <= this->maxQueueSize;
+    });
+
+    if (this->stopping)
+      throw std::runtime_error("Server is shutting down");
+
+    if (!admitted)
+      throw std::runtime_error("Server busy: " + std::to_string(this->queue.size()) + " inputs already queued");
+
+    Clock::time_point deadline = Clock::now() + this->maxWait;
+
+    for (ulong i = 0; i < inputs.size(); i++)
+      this->queue.push_back({request, i, std::move(inputs[i]), deadline});
+
+    this->inputQueued.notify_all();
+
+    //-- Wait for the last output --//
+    this->requestFinished.wait(lock, [&]() { return request->remaining == 0; });
+
+    if (request->error)
+      std::rethrow_exception(request->error);
+
+    if (latency) {
+      latency->queueSeconds = std::chrono::duration<double>(request->startTime - request->submitTime).count();
+      latency->computeSeconds = std::chrono::duration<double>(request->finishTime - request->startTime).count();
+    }
+
+    return std::move(request->outputs);
+  }
+
+  //===================================================================================================================//
+
+  template <typename InputT, typename OutputT>
+  void PredictScheduler<InputT, OutputT>::work(int worker)
+  {
+    std::vector<QueuedInput> taken;
+    std::vector<InputT> batch;
+
+    while (true) {
+      std::unique_lock<std::mutex> lock(this->mutex);
+
+      //-- Wait for a full batch, or for the oldest input's deadline, while another worker is busy --//
+      while (true) {
+        if (this->queue.empty()) {
+          if (this->stopping)
+            return;
+
+          this->inputQueued.wait(lock);
+          continue;
+        }
+
+        Clock::time_point deadline = this->queue.front().deadline;
+        bool contended = this->busyWorkers > 0;
+
+        if (contended && this->queue.size() < this->maxBatchSize && !this->stopping && Clock::now() < deadline) {
+          this->inputQueued.wait_until(lock, deadline);
+          continue;
+        }
+
+        break;
+      }
+
+      ulong batchSize = std::min<ulong>(this->maxBatchSize, this->queue.size());
+      Clock::time_point startTime = Clock::now();
+      taken.clear();
+      batch.clear();
+
+      for (ulong i = 0; i < batchSize; i++) {
+        QueuedInput& queued = this->queue.front();
+
+        if (!queued.request->started) {
+          queued.request->started = true;
+          queued.request->startTime = startTime;
+        }
+
+        batch.push_back(std::move(queued.input));
+        taken.push_back(std::move(queued));
+        this->queue.pop_front();
+      }
+
+      this->busyWorkers++;
+      lock.unlock();
+      this->roomFreed.notify_all();
+
+      //-- Predict outside the lock --//
+      std::vector<OutputT> outputs;
+      std::exception_ptr error;
+
+      try {
+        outputs = this->predictBatch(worker, batch);
+
+        if (outputs.size() != batch.size())
+          throw std::runtime_error("Batch of " + std::to_string(batch.size()) + " inputs returned " +
+                                   std::to_string(outputs.size()) + " outputs");
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      Clock::time_point finishTime = Clock::now();
+      lock.lock();
+
+      for (ulong i = 0; i < taken.size(); i++) {
+        Request& request = *taken[i].request;
+
+        if (error)
+          request.error = error;
+        else
+          request.outputs[taken[i].index] = std::move(outputs[i]);
+
+        if (--request.remaining == 0)
+          request.finishTime = finishTime;
+      }
+
+      // The last busy worker going idle ends the contention other workers may be waiting out
+      bool idle = --this->busyWorkers == 0;
+      lock.unlock();
+      this->requestFinished.notify_all();
+
+      if (idle)
+        this->inputQueued.notify_all();
+    }
+  }
+
+  //===================================================================================================================//
+  //-- Explicit template instantiations --//
+  //===================================================================================================================//
+
+  template class PredictScheduler<ANN::Input<float>, ANN::Output<float>>;
+  template class PredictScheduler<CNN::Input<float>, CNN::Output<float>>;
+
+} // namespace NN_CLI
@@ -0,0 +1,108 @@
+#ifndef NN_CLI_PREDICTSCHEDULER_HPP
+#define NN_CLI_PREDICTSCHEDULER_HPP
+
+#include <ANN_Sample.hpp>
+#include <CNN_Sample.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  using ulong = unsigned long;
+
+  // Where a request's time went: waiting for its first input to be batched, then until its last output was ready.
+  struct PredictLatency {
+      double queueSeconds = 0;
+      double computeSeconds = 0;
+  };
+
+  /**
+ * PredictScheduler: shares a resident model among concurrent requests by predicting their inputs in micro-batches.
+ *
+ * submit() queues a request's inputs and waits for their outputs. numWorkers threads each take the oldest queued
+ * inputs as one batch, up to maxBatchSize, and hand the batch to the batch function. While no worker is busy, queued
+ * inputs are predicted at once, so a lone request never waits. While another worker is busy, more inputs are likely
+ * on their way, so an idle worker waits until maxBatchSize inputs are queued or the oldest has waited maxWait (its
+ * deadline). Small batches therefore keep latency low under light load, and full batches keep throughput high under
+ * heavy load.
+ *
+ * At most maxQueueSize inputs wait at once. A request that does not fit waits up to admissionTimeout for room
+ * (backpressure), and is then rejected with an exception (admission control), so an overloaded server answers
+ * quickly instead of letting every request's latency grow.
+ */
+  template <typename InputT, typename OutputT>
+  class PredictScheduler
+  {
+    public:
+      // Predicts one batch on worker `worker` (0 .. numWorkers - 1), returning one output per input, in order.
+      // May be called concurrently for different workers.
+      using BatchFunction = std::function<std::vector<OutputT>(int worker, std::vector<InputT>& batch)>;
+
+      PredictScheduler(int numWorkers, ulong maxBatchSize, std::chrono::microseconds maxWait, ulong maxQueueSize,
+                       std::chrono::microseconds admissionTimeout, BatchFunction predictBatch);
+
+      // Predicts what is still queued, then stops the workers.
+      ~PredictScheduler();
+
+      PredictScheduler(const PredictScheduler&) = delete;
+      PredictScheduler& operator=(const PredictScheduler&) = delete;
+
+      // Predict every input, keeping input order. Blocks until done; throws if the request is rejected or a batch
+      // holding one of its inputs fails.
+      std::vector<OutputT> submit(std::vector<InputT> inputs, PredictLatency* latency = nullptr);
+
+    private:
+      using Clock = std::chrono::steady_clock;
+
+      struct Request {
+          std::vector<OutputT> outputs;
+          ulong remaining = 0;
+          bool started = false;
+          Clock::time_point submitTime;
+          Clock::time_point startTime; // When its first input's batch started
+          Clock::time_point finishTime; // When its last input's batch finished
+          std::exception_ptr error;
+      };
+
+      struct QueuedInput {
+          std::shared_ptr<Request> request;
+          ulong index = 0;
+          InputT input;
+          Clock::time_point deadline; // Latest time to start a batch with this input
+      };
+
+      void work(int worker);
+
+      ulong maxBatchSize;
+      std::chrono::microseconds maxWait;
+      ulong maxQueueSize;
+      std::chrono::microseconds admissionTimeout;
+      BatchFunction predictBatch;
+
+      std::mutex mutex;
+      std::condition_variable inputQueued; // Workers: a batch may be ready, or stopping
+      std::condition_variable roomFreed; // submit(): inputs left the queue
+      std::condition_variable requestFinished; // submit(): some request's last output is ready
+      std::deque<QueuedInput> queue;
+      int busyWorkers = 0; // Workers predicting a batch
+      bool stopping = false;
+
+      std::vector<std::thread> workers;
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_PREDICTSCHEDULER_HPP
@@ -124,6 +124,45 @@ namespace NN_CLI
     }
   }
 
+  void ProgressBar::printStreamingProgress(const std::string& label, size_t items, size_t bytesRead, size_t bytesTotal,
+                                           ulong progressReports, int barWidth)
+  {
+    // Last report bucket printed; streams are loaded one at a time, and every stream prints its first item
+    static size_t lastBucket = 0;
+
+    if (progressReports == 0)
+      return;
+
+    bool isComplete = (bytesRead >= bytesTotal);
+    size_t bucket = (bytesTotal > 0) ? bytesRead * progressReports / bytesTotal : progressReports;
+
+    // Throttle: only print at first, last, and whenever another 1/progressReports of the file has been consumed
+    if (items != 1 && !isComplete && bucket == lastBucket) {
+      return;
+    }
+
+    lastBucket = bucket;
+
+    float percent = isComplete ? 1.0f : static_cast<float>(bytesRead) / static_cast<float>(bytesTotal);
+    int filledWidth = static_cast<int>(percent * barWidth);
+
+    std::ostringstream out;
+    out << "\r" << label << " [";
+
+    for (int i = 0; i < barWidth; i++) {
+      out << (i < filledWidth ? "█" : "░");
+    }
+
+    out << "] " << items << " loaded  " << std::fixed << std::setprecision(1) << (percent * 100.0f) << "%";
+    out << "   ";
+
+    std::cout << out.str() << std::flush;
+
+    if (isComplete) {
+      std::cout << std::endl;
+    }
+  }
+
   //===================================================================================================================//
   //-- GPU State Management --//
   //===================================================================================================================//
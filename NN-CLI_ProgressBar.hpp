@@ -40,6 +40,12 @@ namespace NN_CLI
       static void printLoadingProgress(const std::string& label, size_t current, size_t total,
                                        ulong progressReports = 1000, int barWidth = 40);
 
+      // Loading progress for streamed files, where the item count is only known at the end.
+      // The bar tracks bytes consumed; prints: "Loading samples: [████████░░░░░░░░] 1234 loaded  24.7%"
+      // Prints the first item, then at most progressReports updates, and the final line when bytesRead == bytesTotal.
+      static void printStreamingProgress(const std::string& label, size_t items, size_t bytesRead, size_t bytesTotal,
+                                         ulong progressReports = 1000, int barWidth = 40);
+
     private:
       //-- Configuration --//
       ulong progressReports;
@@ -1,38 +1,58 @@
 #include "NN-CLI_Runner.hpp"
 
+#include "NN-CLI_ConfigDocument.hpp"
 #include "NN-CLI_DataLoader.hpp"
 #include "NN-CLI_ImageLoader.hpp"
+#include "NN-CLI_JsonStream.hpp"
+#include "NN-CLI_JsonWriter.hpp"
 #include "NN-CLI_Loader.hpp"
+#include "NN-CLI_ModelFile.hpp"
+#include "NN-CLI_PackedDataset.hpp"
+#include "NN-CLI_ParallelImageWriter.hpp"
+#include "NN-CLI_PredictPipeline.hpp"
+#include "NN-CLI_PredictScheduler.hpp"
 #include "NN-CLI_ProgressBar.hpp"
-#include "NN-CLI_Utils.hpp"
+#include "NN-CLI_ScratchArena.hpp"
 
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <ANN_Utils.hpp>
 
 #include <json.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <numeric>
 #include <random>
 #include <sstream>
 
+#include <unistd.h>
+
 using namespace NN_CLI;
 
 //===================================================================================================================//
 
 Runner::Runner(const QCommandLineParser& parser, LogLevel logLevel) : parser(parser), logLevel(logLevel)
 {
+  auto startupStart = std::chrono::steady_clock::now();
   QString configPath = this->parser.value("config");
 
+  // Parse the config once; every loader below reads from this document ("parameters" stays unparsed until needed)
+  ConfigDocument configDocument = ConfigDocument::load(configPath.toStdString());
+  std::chrono::duration<double> parseElapsed = std::chrono::steady_clock::now() - startupStart;
+
   // Detect network type from config file
-  this->networkType = Loader::detectNetworkType(configPath.toStdString());
+  this->networkType = Loader::detectNetworkType(configDocument);
 
   // Build optional mode/device overrides as strings
   std::optional<std::string> modeOverride;
@@ -67,7 +87,7 @@ Runner::Runner(const QCommandLineParser& parser, LogLevel logLevel) : parser(par
     outputTypeOverride = this->parser.value("output-type").toLower().toStdString();
   }
 
-  this->ioConfig = Loader::loadIOConfig(configPath.toStdString(), inputTypeOverride, outputTypeOverride);
+  this->ioConfig = Loader::loadIOConfig(configDocument, inputTypeOverride, outputTypeOverride);
 
   // Display info (verbose level >= 1)
   std::string networkTypeStr = (this->networkType == NetworkType::CNN) ? "CNN" : "ANN";
@@ -83,18 +103,39 @@ Runner::Runner(const QCommandLineParser& parser, LogLevel logLevel) : parser(par
   }
 
   // Load NN-CLI-level settings from config root
-  this->progressReports = Loader::loadProgressReports(configPath.toStdString());
-  this->saveModelInterval = Loader::loadSaveModelInterval(configPath.toStdString());
+  this->progressReports = Loader::loadProgressReports(configDocument);
+  this->saveModelInterval = Loader::loadSaveModelInterval(configDocument);
+  this->imageCacheMB = Loader::loadImageCacheMB(configDocument);
+  this->imageCacheDir = Loader::loadImageCacheDir(configDocument);
+  this->ioThreads = Loader::loadIOThreads(configDocument);
+  this->testBatchSize = Loader::loadTestBatchSize(configDocument);
+  this->serveConfig = Loader::loadServeConfig(configDocument);
+
+  if (this->parser.isSet("cache-dir"))
+    this->imageCacheDir = this->parser.value("cache-dir").toStdString();
 
   // Load data augmentation config
-  auto augConfig = Loader::loadAugmentationConfig(configPath.toStdString());
+  auto augConfig = Loader::loadAugmentationConfig(configDocument);
   this->augmentationFactor = augConfig.augmentationFactor;
   this->balanceAugmentation = augConfig.balanceAugmentation;
   this->autoClassWeights = augConfig.autoClassWeights;
   this->augmentationProbability = augConfig.augmentationProbability;
+  this->augmentationSeed = augConfig.augmentationSeed;
   this->augTransforms = augConfig.transforms;
 
-  if (this->logLevel >= LogLevel::INFO && this->saveModelInterval > 0) {
+  // Convert mode only re-packs samples — no network is built
+  if (modeOverride.has_value() && modeOverride.value() == "convert") {
+    this->mode = "convert";
+    return;
+  }
+
+  // Serve mode predicts with the model it keeps loaded
+  bool serve = modeOverride.has_value() && modeOverride.value() == "serve";
+
+  if (serve)
+    modeOverride = "predict";
+
+  if (this->logLevel >= LogLevel::INFO && this->saveModelInterval > 0 && !serve) {
     std::cout << "Save model interval: every " << this->saveModelInterval << " epoch(s)\n";
   }
 
@@ -110,7 +151,7 @@ Runner::Runner(const QCommandLineParser& parser, LogLevel logLevel) : parser(par
     if (deviceOverride.has_value())
       annDeviceOverride = ANN::Device::nameToType(deviceOverride.value());
 
-    this->annCoreConfig = Loader::loadANNConfig(configPath.toStdString(), annModeOverride, annDeviceOverride);
+    this->annCoreConfig = Loader::loadANNConfig(configDocument, annModeOverride, annDeviceOverride);
     this->annCoreConfig.logLevel = static_cast<ANN::LogLevel>(this->logLevel);
 
     if (shuffleSamplesOverride.has_value())
@@ -118,7 +159,7 @@ Runner::Runner(const QCommandLineParser& parser, LogLevel logLevel) : parser(par
     this->mode = ANN::Mode::typeToName(this->annCoreConfig.modeType);
     this->annCore = ANN::Core<float>::makeCore(this->annCoreConfig);
   } else {
-    this->cnnCoreConfig = Loader::loadCNNConfig(configPath.toStdString(), modeOverride, deviceOverride);
+    this->cnnCoreConfig = Loader::loadCNNConfig(configDocument, modeOverride, deviceOverride);
     this->cnnCoreConfig.logLevel = static_cast<CNN::LogLevel>(this->logLevel);
 
     if (shuffleSamplesOverride.has_value())
@@ -126,12 +167,29 @@ Runner::Runner(const QCommandLineParser& parser, LogLevel logLevel) : parser(par
     this->mode = CNN::Mode::typeToName(this->cnnCoreConfig.modeType);
     this->cnnCore = CNN::Core<float>::makeCore(this->cnnCoreConfig);
   }
+
+  if (serve)
+    this->mode = "serve";
+
+  if (this->logLevel >= LogLevel::INFO) {
+    std::chrono::duration<double> startupElapsed = std::chrono::steady_clock::now() - startupStart;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << "Startup time: " << startupElapsed.count()
+        << "s (config parse: " << parseElapsed.count() << "s)\n";
+    std::cout << oss.str();
+  }
 }
 
 //===================================================================================================================//
 
 int Runner::run()
 {
+  if (this->mode == "convert")
+    return this->runConvert();
+
+  if (this->mode == "serve")
+    return this->runServe();
+
   if (this->networkType == NetworkType::ANN) {
     if (this->mode == "train")
       return this->runANNTrain();
@@ -161,12 +219,17 @@ int Runner::runANNTrain()
 
   QString inputFilePath;
   DataLoader<ANN::Sample<float>> dataLoader;
+  dataLoader.setIOThreads(this->ioThreads);
 
   int inputC = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputC) : 0;
   int inputH = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputH) : 0;
   int inputW = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputW) : 0;
 
-  if (this->parser.isSet("samples")) {
+  if (this->parser.isSet("samples") && PackedDataset::isPackedFile(this->parser.value("samples").toStdString())) {
+    // Packed dataset (from --mode convert) — memory-mapped, samples read straight from the mapped pages
+    inputFilePath = this->parser.value("samples");
+    dataLoader.loadPacked(inputFilePath.toStdString(), inputC, inputH, inputW);
+  } else if (this->parser.isSet("samples")) {
     // JSON samples — store lightweight manifest (images loaded on-demand per batch)
     inputFilePath = this->parser.value("samples");
     int outputC = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputC) : 0;
@@ -174,16 +237,22 @@ int Runner::runANNTrain()
     int outputW = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputW) : 0;
     dataLoader.loadManifest(inputFilePath.toStdString(), this->ioConfig, inputC, inputH, inputW, outputC, outputH,
                             outputW);
+    dataLoader.setImageCache(this->makeImageCache());
+    dataLoader.setDiskImageCache(this->makeDiskImageCache());
   } else {
-    // IDX or other format — load all samples into memory, then hand off to DataLoader
-    auto [samples, success] = this->loadANNSamplesFromOptions("training", inputFilePath);
+    // IDX — raw bytes stay in memory; samples are normalised and one-hot encoded per batch
+    QString idxLabelsPath;
 
-    if (!success)
+    if (!this->idxPathsFromOptions("training", inputFilePath, idxLabelsPath))
       return 1;
-    dataLoader.loadFromMemory(std::move(samples), inputC, inputH, inputW);
+    dataLoader.loadIDX(inputFilePath.toStdString(), idxLabelsPath.toStdString(), inputC, inputH, inputW);
+
+    if (this->logLevel >= LogLevel::INFO)
+      std::cout << "Loaded " << dataLoader.numSamples() << " training samples.\n";
   }
 
   dataLoader.planAugmentation(this->augmentationFactor, this->balanceAugmentation);
+  dataLoader.setAugmentationSeed(this->resolveAugmentationSeed());
 
   // Auto-compute class weights
   if (this->autoClassWeights && this->annCoreConfig.costFunctionConfig.weights.empty()) {
@@ -221,15 +290,21 @@ int Runner::runANNTrain()
 int Runner::runANNTest()
 {
   QString inputFilePath;
-  auto [samples, success] = this->loadANNSamplesFromOptions("test", inputFilePath);
+  DataLoader<ANN::Sample<float>> dataLoader;
+  dataLoader.setIOThreads(this->ioThreads);
 
-  if (!success)
+  int inputC = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputC) : 0;
+  int inputH = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputH) : 0;
+  int inputW = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputW) : 0;
+
+  if (!this->openSamplesFromOptions("test", dataLoader, inputFilePath, inputC, inputH, inputW))
     return 1;
 
   if (this->logLevel >= LogLevel::INFO)
     std::cout << "Running ANN evaluation...\n";
 
-  ANN::TestResult<float> result = this->annCore->test(samples);
+  ANN::TestResult<float> result = this->testInBatches<ANN::Sample<float>, ANN::TestResult<float>>(
+    dataLoader, [this](const ANN::Samples<float>& batch) { return this->annCore->test(batch); });
 
   if (this->logLevel > LogLevel::QUIET) {
     std::cout << "\nTest Results:\n";
@@ -269,16 +344,35 @@ int Runner::runANNPredict()
     if (this->ioConfig.outputType == DataType::IMAGE) {
       outputPath = outputDir.filePath("predict_" + inputInfo.completeBaseName());
     } else {
-      outputPath = outputDir.filePath("predict_" + inputInfo.completeBaseName() + ".json");
+      // JSON Lines in, JSON Lines out
+      QString extension = JsonStream::isJsonLinesPath(inputPath.toStdString()) ? ".jsonl" : ".json";
+      outputPath = outputDir.filePath("predict_" + inputInfo.completeBaseName() + extension);
     }
   }
 
+  if (this->parser.isSet("stream")) {
+    // One core per worker: the loaded one, plus replicas (see predictAll)
+    bool parallel = (this->annCoreConfig.deviceType == ANN::DeviceType::CPU);
+    int numWorkers = maxPredictWorkers(this->annCoreConfig.numThreads, parallel);
+    std::vector<std::unique_ptr<ANN::Core<float>>> replicas;
+
+    for (int w = 1; w < numWorkers; w++)
+      replicas.push_back(makeReplica<ANN::Core<float>>(this->annCoreConfig));
+
+    std::string baseDir = QFileInfo(inputPath).absolutePath().toStdString();
+
+    return this->runStreamingPredict(inputPath, outputPath, numWorkers, [&](int worker, const nlohmann::json& entry) {
+      ANN::Core<float>& core = (worker == 0) ? *this->annCore : *replicas[worker - 1];
+      return core.predict(Loader::parseANNInput(entry, this->ioConfig, baseDir));
+    });
+  }
+
   if (this->logLevel >= LogLevel::INFO)
     std::cout << "Loading inputs from: " << inputPath.toStdString() << "\n";
 
   ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
   std::vector<ANN::Input<float>> inputs =
-    Loader::loadANNInputs(inputPath.toStdString(), this->ioConfig, displayProgressReports);
+    Loader::loadANNInputs(inputPath.toStdString(), this->ioConfig, displayProgressReports, this->ioThreads);
 
   if (this->logLevel >= LogLevel::INFO) {
     std::cout << "Loaded " << inputs.size() << " input(s), each with " << inputs[0].size() << " values\n";
@@ -288,17 +382,9 @@ int Runner::runANNPredict()
   auto batchStart = std::chrono::system_clock::now();
   std::string startTimeStr = ANN::Utils<float>::formatISO8601();
 
-  std::vector<ANN::Output<float>> outputs;
-  outputs.reserve(inputs.size());
-
-  for (size_t i = 0; i < inputs.size(); ++i) {
-    ANN::Output<float> output = this->annCore->predict(inputs[i]);
-    outputs.push_back(std::move(output));
-
-    if (this->logLevel >= LogLevel::INFO && inputs.size() > 1) {
-      std::cout << "  Predicted input " << (i + 1) << "/" << inputs.size() << "\n";
-    }
-  }
+  int numWorkers = 1;
+  std::vector<ANN::Output<float>> outputs = this->predictAll<ANN::Output<float>>(
+    *this->annCore, this->annCoreConfig, this->annCoreConfig.deviceType == ANN::DeviceType::CPU, inputs, numWorkers);
 
   auto batchEnd = std::chrono::system_clock::now();
   std::string endTimeStr = ANN::Utils<float>::formatISO8601();
@@ -314,54 +400,35 @@ int Runner::runANNPredict()
     }
 
     // outputPath is a directory for batch image output
-    QDir outDir(outputPath);
-
-    if (!outDir.exists())
-      QDir().mkpath(outputPath);
-
-    for (size_t i = 0; i < outputs.size(); ++i) {
-      QString imgName = QString::number(i) + ".png";
-      std::string imgPath = outDir.filePath(imgName).toStdString();
-      ImageLoader::saveImage(imgPath, outputs[i], static_cast<int>(this->ioConfig.outputC),
-                             static_cast<int>(this->ioConfig.outputH), static_cast<int>(this->ioConfig.outputW));
-    }
+    this->saveOutputImages(outputPath, outputs);
 
     if (this->logLevel > LogLevel::QUIET) {
       std::cout << "Predict images saved to: " << outputPath.toStdString() << "\n";
       std::cout << "  Images: " << outputs.size() << "\n";
       std::cout << "  Shape: " << this->ioConfig.outputC << "x" << this->ioConfig.outputH << "x"
                 << this->ioConfig.outputW << "\n";
-      std::cout << "  Duration: " << batchDurationFormatted << "\n";
+      std::cout << "  Duration: " << batchDurationFormatted << " (" << numWorkers << " worker(s))\n";
     }
 
     return 0;
   }
 
+  if (JsonStream::isJsonLinesPath(outputPath.toStdString()))
+    return this->writePredictLines(outputPath, outputs, batchDurationFormatted, numWorkers);
+
   // Standard vector output: save as JSON with "outputs" array
-  nlohmann::ordered_json resultJson;
   nlohmann::ordered_json predictMetadataJson;
   predictMetadataJson["startTime"] = startTimeStr;
   predictMetadataJson["endTime"] = endTimeStr;
   predictMetadataJson["durationSeconds"] = batchDurationSeconds;
   predictMetadataJson["durationFormatted"] = batchDurationFormatted;
   predictMetadataJson["numInputs"] = inputs.size();
-  resultJson["predictMetadata"] = predictMetadataJson;
-  resultJson["outputs"] = outputs;
-
-  QFile outputFile(outputPath);
-
-  if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-    std::cerr << "Error: Failed to open output file: " << outputPath.toStdString() << "\n";
-    return 1;
-  }
-
-  std::string jsonStr = resultJson.dump(2);
-  outputFile.write(jsonStr.c_str(), jsonStr.size());
-  outputFile.close();
+  predictMetadataJson["numWorkers"] = numWorkers;
+  predictMetadataJson["inputsPerSecond"] = (batchDurationSeconds > 0) ? inputs.size() / batchDurationSeconds : 0.0;
+  predictMetadataJson["inputsPerSecondPerWorker"] =
+    (batchDurationSeconds > 0) ? inputs.size() / batchDurationSeconds / numWorkers : 0.0;
 
-  if (this->logLevel > LogLevel::QUIET)
-    std::cout << "Predict result saved to: " << outputPath.toStdString() << "\n";
-  return 0;
+  return this->writePredictJson(outputPath, predictMetadataJson, outputs);
 }
 
 //===================================================================================================================//
@@ -378,27 +445,38 @@ int Runner::runCNNTrain()
 
   QString inputFilePath;
   DataLoader<CNN::Sample<float>> dataLoader;
+  dataLoader.setIOThreads(this->ioThreads);
   const CNN::Shape3D& inputShape = this->cnnCoreConfig.inputShape;
   int inputC = static_cast<int>(inputShape.c);
   int inputH = static_cast<int>(inputShape.h);
   int inputW = static_cast<int>(inputShape.w);
 
-  if (this->parser.isSet("samples")) {
+  if (this->parser.isSet("samples") && PackedDataset::isPackedFile(this->parser.value("samples").toStdString())) {
+    // Packed dataset (from --mode convert) — memory-mapped, samples read straight from the mapped pages
+    inputFilePath = this->parser.value("samples");
+    dataLoader.loadPacked(inputFilePath.toStdString(), inputC, inputH, inputW);
+  } else if (this->parser.isSet("samples")) {
     // JSON samples — store lightweight manifest (images loaded on-demand per batch)
     inputFilePath = this->parser.value("samples");
     dataLoader.loadManifest(inputFilePath.toStdString(), this->ioConfig, inputC, inputH, inputW,
                             static_cast<int>(this->ioConfig.outputC), static_cast<int>(this->ioConfig.outputH),
                             static_cast<int>(this->ioConfig.outputW));
+    dataLoader.setImageCache(this->makeImageCache());
+    dataLoader.setDiskImageCache(this->makeDiskImageCache());
   } else {
-    // IDX or other format — load all samples into memory, then hand off to DataLoader
-    auto [samples, success] = this->loadCNNSamplesFromOptions("training", inputFilePath);
+    // IDX — raw bytes stay in memory; samples are normalised and one-hot encoded per batch
+    QString idxLabelsPath;
 
-    if (!success)
+    if (!this->idxPathsFromOptions("training", inputFilePath, idxLabelsPath))
       return 1;
-    dataLoader.loadFromMemory(std::move(samples), inputC, inputH, inputW);
+    dataLoader.loadIDX(inputFilePath.toStdString(), idxLabelsPath.toStdString(), inputC, inputH, inputW);
+
+    if (this->logLevel >= LogLevel::INFO)
+      std::cout << "Loaded " << dataLoader.numSamples() << " training samples.\n";
   }
 
   dataLoader.planAugmentation(this->augmentationFactor, this->balanceAugmentation);
+  dataLoader.setAugmentationSeed(this->resolveAugmentationSeed());
 
   // Auto-compute class weights
   if (this->autoClassWeights && this->cnnCoreConfig.costFunctionConfig.weights.empty()) {
@@ -441,15 +519,19 @@ int Runner::runCNNTrain()
 int Runner::runCNNTest()
 {
   QString inputFilePath;
-  auto [samples, success] = this->loadCNNSamplesFromOptions("test", inputFilePath);
+  DataLoader<CNN::Sample<float>> dataLoader;
+  dataLoader.setIOThreads(this->ioThreads);
+  const CNN::Shape3D& inputShape = this->cnnCoreConfig.inputShape;
 
-  if (!success)
+  if (!this->openSamplesFromOptions("test", dataLoader, inputFilePath, static_cast<int>(inputShape.c),
+                                    static_cast<int>(inputShape.h), static_cast<int>(inputShape.w)))
     return 1;
 
   if (this->logLevel >= LogLevel::INFO)
     std::cout << "Running CNN evaluation...\n";
 
-  CNN::TestResult<float> result = this->cnnCore->test(samples);
+  CNN::TestResult<float> result = this->testInBatches<CNN::Sample<float>, CNN::TestResult<float>>(
+    dataLoader, [this](const CNN::Samples<float>& batch) { return this->cnnCore->test(batch); });
 
   if (this->logLevel > LogLevel::QUIET) {
     std::cout << "\nTest Results:\n";
@@ -489,16 +571,36 @@ int Runner::runCNNPredict()
     if (this->ioConfig.outputType == DataType::IMAGE) {
       outputPath = outputDir.filePath("predict_" + inputInfo.completeBaseName());
     } else {
-      outputPath = outputDir.filePath("predict_" + inputInfo.completeBaseName() + ".json");
+      // JSON Lines in, JSON Lines out
+      QString extension = JsonStream::isJsonLinesPath(inputPath.toStdString()) ? ".jsonl" : ".json";
+      outputPath = outputDir.filePath("predict_" + inputInfo.completeBaseName() + extension);
     }
   }
 
+  if (this->parser.isSet("stream")) {
+    // One core per worker: the loaded one, plus replicas (see predictAll)
+    bool parallel = (this->cnnCoreConfig.deviceType == CNN::DeviceType::CPU);
+    int numWorkers = maxPredictWorkers(this->cnnCoreConfig.numThreads, parallel);
+    std::vector<std::unique_ptr<CNN::Core<float>>> replicas;
+
+    for (int w = 1; w < numWorkers; w++)
+      replicas.push_back(makeReplica<CNN::Core<float>>(this->cnnCoreConfig));
+
+    std::string baseDir = QFileInfo(inputPath).absolutePath().toStdString();
+
+    return this->runStreamingPredict(inputPath, outputPath, numWorkers, [&](int worker, const nlohmann::json& entry) {
+      CNN::Core<float>& core = (worker == 0) ? *this->cnnCore : *replicas[worker - 1];
+      return core.predict(Loader::parseCNNInput(entry, this->cnnCoreConfig.inputShape, this->ioConfig, baseDir));
+    });
+  }
+
   if (this->logLevel >= LogLevel::INFO)
     std::cout << "Loading inputs from: " << inputPath.toStdString() << "\n";
 
   ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
-  std::vector<CNN::Input<float>> inputs = Loader::loadCNNInputs(inputPath.toStdString(), this->cnnCoreConfig.inputShape,
-                                                                this->ioConfig, displayProgressReports);
+  std::vector<CNN::Input<float>> inputs =
+    Loader::loadCNNInputs(inputPath.toStdString(), this->cnnCoreConfig.inputShape, this->ioConfig,
+                          displayProgressReports, this->ioThreads);
 
   if (this->logLevel >= LogLevel::INFO) {
     std::cout << "Loaded " << inputs.size() << " input(s), each with " << inputs[0].data.size() << " values\n";
@@ -508,17 +610,9 @@ int Runner::runCNNPredict()
   auto batchStart = std::chrono::system_clock::now();
   std::string startTimeStr = ANN::Utils<float>::formatISO8601();
 
-  std::vector<CNN::Output<float>> outputs;
-  outputs.reserve(inputs.size());
-
-  for (size_t i = 0; i < inputs.size(); ++i) {
-    CNN::Output<float> output = this->cnnCore->predict(inputs[i]);
-    outputs.push_back(std::move(output));
-
-    if (this->logLevel >= LogLevel::INFO && inputs.size() > 1) {
-      std::cout << "  Predicted input " << (i + 1) << "/" << inputs.size() << "\n";
-    }
-  }
+  int numWorkers = 1;
+  std::vector<CNN::Output<float>> outputs = this->predictAll<CNN::Output<float>>(
+    *this->cnnCore, this->cnnCoreConfig, this->cnnCoreConfig.deviceType == CNN::DeviceType::CPU, inputs, numWorkers);
 
   auto batchEnd = std::chrono::system_clock::now();
   std::string endTimeStr = ANN::Utils<float>::formatISO8601();
@@ -534,53 +628,190 @@ int Runner::runCNNPredict()
     }
 
     // outputPath is a directory for batch image output
-    QDir outDir(outputPath);
-
-    if (!outDir.exists())
-      QDir().mkpath(outputPath);
-
-    for (size_t i = 0; i < outputs.size(); ++i) {
-      QString imgName = QString::number(i) + ".png";
-      std::string imgPath = outDir.filePath(imgName).toStdString();
-      ImageLoader::saveImage(imgPath, outputs[i], static_cast<int>(this->ioConfig.outputC),
-                             static_cast<int>(this->ioConfig.outputH), static_cast<int>(this->ioConfig.outputW));
-    }
+    this->saveOutputImages(outputPath, outputs);
 
     if (this->logLevel > LogLevel::QUIET) {
       std::cout << "Predict images saved to: " << outputPath.toStdString() << "\n";
       std::cout << "  Images: " << outputs.size() << "\n";
       std::cout << "  Shape: " << this->ioConfig.outputC << "x" << this->ioConfig.outputH << "x"
                 << this->ioConfig.outputW << "\n";
-      std::cout << "  Duration: " << batchDurationFormatted << "\n";
+      std::cout << "  Duration: " << batchDurationFormatted << " (" << numWorkers << " worker(s))\n";
     }
 
     return 0;
   }
 
+  if (JsonStream::isJsonLinesPath(outputPath.toStdString()))
+    return this->writePredictLines(outputPath, outputs, batchDurationFormatted, numWorkers);
+
   // Standard vector output: save as JSON with "outputs" array
-  nlohmann::ordered_json resultJson;
   nlohmann::ordered_json predictMetadataJson;
   predictMetadataJson["startTime"] = startTimeStr;
   predictMetadataJson["endTime"] = endTimeStr;
   predictMetadataJson["durationSeconds"] = batchDurationSeconds;
   predictMetadataJson["durationFormatted"] = batchDurationFormatted;
   predictMetadataJson["numInputs"] = inputs.size();
-  resultJson["predictMetadata"] = predictMetadataJson;
-  resultJson["outputs"] = outputs;
+  predictMetadataJson["numWorkers"] = numWorkers;
+  predictMetadataJson["inputsPerSecond"] = (batchDurationSeconds > 0) ? inputs.size() / batchDurationSeconds : 0.0;
+  predictMetadataJson["inputsPerSecondPerWorker"] =
+    (batchDurationSeconds > 0) ? inputs.size() / batchDurationSeconds / numWorkers : 0.0;
 
-  QFile outputFile(outputPath);
+  return this->writePredictJson(outputPath, predictMetadataJson, outputs);
+}
 
-  if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-    std::cerr << "Error: Failed to open output file: " << outputPath.toStdString() << "\n";
+//===================================================================================================================//
+//  Serve mode
+//===================================================================================================================//
+
+int Runner::runServe()
+{
+  // Image paths in requests are resolved against the working directory
+  std::string baseDir = QDir::currentPath().toStdString();
+
+  if (this->networkType == NetworkType::ANN) {
+    return this->serveRequests<ANN::Input<float>, ANN::Output<float>>(
+      *this->annCore, this->annCoreConfig, this->annCoreConfig.deviceType == ANN::DeviceType::CPU,
+      this->annCoreConfig.layersConfig.front().numNeurons,
+      [&](const nlohmann::json& entry) { return Loader::parseANNInput(entry, this->ioConfig, baseDir); },
+      [](std::vector<float>& values) { return std::move(values); });
+  }
+
+  return this->serveRequests<CNN::Input<float>, CNN::Output<float>>(
+    *this->cnnCore, this->cnnCoreConfig, this->cnnCoreConfig.deviceType == CNN::DeviceType::CPU,
+    this->cnnCoreConfig.inputShape.size(),
+    [&](const nlohmann::json& entry) {
+      return Loader::parseCNNInput(entry, this->cnnCoreConfig.inputShape, this->ioConfig, baseDir).data;
+    },
+    [&](std::vector<float>& values) {
+      CNN::Input<float> input(this->cnnCoreConfig.inputShape);
+      input.data = std::move(values);
+      return input;
+    });
+}
+
+//===================================================================================================================//
+
+template <typename InputT, typename OutputT, typename CoreT, typename CoreConfigT, typename MakeInput>
+int Runner::serveRequests(CoreT& core, const CoreConfigT& coreConfig, bool parallel, size_t inputSize,
+                          const Server::ParseFunction& parse, MakeInput makeInput)
+{
+  // One core per worker: the loaded one, plus replicas (see predictAll)
+  int numWorkers = maxPredictWorkers(coreConfig.numThreads, parallel);
+  std::vector<std::unique_ptr<CoreT>> replicas;
+
+  for (int w = 1; w < numWorkers; w++)
+    replicas.push_back(makeReplica<CoreT>(coreConfig));
+
+  const Loader::ServeConfig& serve = this->serveConfig;
+
+  // Requests from every connection are queued together and predicted in micro-batches, one batch per worker
+  PredictScheduler<InputT, OutputT> scheduler(
+    numWorkers, serve.maxBatchSize, std::chrono::microseconds(static_cast<long>(serve.maxWaitMs * 1000.0)),
+    serve.maxQueueSize, std::chrono::microseconds(static_cast<long>(serve.admissionTimeoutMs * 1000.0)),
+    [&](int worker, std::vector<InputT>& batch) {
+      CoreT& workerCore = (worker == 0) ? core : *replicas[worker - 1];
+      std::vector<OutputT> outputs;
+      outputs.reserve(batch.size());
+
+      for (const InputT& input : batch)
+        outputs.push_back(workerCore.predict(input));
+
+      return outputs;
+    });
+
+  Server server(inputSize, parse, [&](std::vector<std::vector<float>> values, PredictLatency& latency) {
+    std::vector<InputT> inputs;
+    inputs.reserve(values.size());
+
+    for (std::vector<float>& input : values)
+      inputs.push_back(makeInput(input));
+
+    return scheduler.submit(std::move(inputs), &latency);
+  });
+
+  if (this->logLevel >= LogLevel::INFO) {
+    std::cout << "Serve: " << numWorkers << " worker(s), batches of up to " << serve.maxBatchSize << " input(s), "
+              << "max wait " << serve.maxWaitMs << " ms, queue of " << serve.maxQueueSize << " input(s)\n";
+  }
+
+  try {
+    if (this->parser.isSet("socket")) {
+      std::string socketPath = this->parser.value("socket").toStdString();
+
+      if (this->logLevel > LogLevel::QUIET)
+        std::cout << "Serving on socket: " << socketPath << "\n" << std::flush;
+
+      server.serveSocket(socketPath);
+    } else {
+      if (this->logLevel > LogLevel::QUIET)
+        std::cout << "Serving on stdin/stdout\n" << std::flush;
+
+      server.serveStream(STDIN_FILENO, STDOUT_FILENO);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
     return 1;
   }
 
-  std::string jsonStr = resultJson.dump(2);
-  outputFile.write(jsonStr.c_str(), jsonStr.size());
-  outputFile.close();
+  return 0;
+}
+
+//===================================================================================================================//
+//  Dataset conversion
+//===================================================================================================================//
+
+int Runner::runConvert()
+{
+  if (!this->parser.isSet("output")) {
+    std::cerr << "Error: --output option is required for convert mode.\n";
+    return 1;
+  }
+
+  QString inputFilePath;
+  std::string outputPath = this->parser.value("output").toStdString();
+  DataLoader<ANN::Sample<float>> dataLoader;
+  dataLoader.setIOThreads(this->ioThreads);
+
+  // Packed files store flat tensors; the shape recorded is the one from the config (CNN inputShape or ANN image shape)
+  int inputC = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputC) : 0;
+  int inputH = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputH) : 0;
+  int inputW = this->ioConfig.hasInputShape() ? static_cast<int>(this->ioConfig.inputW) : 0;
+  bool quantizeInputs = false;
+
+  if (this->parser.isSet("samples")) {
+    inputFilePath = this->parser.value("samples");
+
+    if (this->logLevel >= LogLevel::INFO)
+      std::cout << "Converting samples from JSON: " << inputFilePath.toStdString() << "\n";
+
+    int outputC = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputC) : 0;
+    int outputH = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputH) : 0;
+    int outputW = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputW) : 0;
+    dataLoader.loadManifest(inputFilePath.toStdString(), this->ioConfig, inputC, inputH, inputW, outputC, outputH,
+                            outputW);
+    dataLoader.setDiskImageCache(this->makeDiskImageCache());
+
+    // Decoded 8-bit images round-trip exactly through uint8 storage
+    quantizeInputs = (this->ioConfig.inputType == DataType::IMAGE);
+  } else {
+    QString idxLabelsPath;
+
+    if (!this->idxPathsFromOptions("conversion", inputFilePath, idxLabelsPath))
+      return 1;
+    dataLoader.loadIDX(inputFilePath.toStdString(), idxLabelsPath.toStdString(), inputC, inputH, inputW);
+
+    // IDX pixel data is 8-bit
+    quantizeInputs = true;
+  }
+
+  ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
+  dataLoader.exportPacked(outputPath, quantizeInputs, displayProgressReports);
+
+  if (this->logLevel > LogLevel::QUIET) {
+    std::cout << "Packed dataset saved to: " << outputPath << "\n";
+    std::cout << "  Samples: " << dataLoader.numSamples() << "\n";
+  }
 
-  if (this->logLevel > LogLevel::QUIET)
-    std::cout << "Predict result saved to: " << outputPath.toStdString() << "\n";
   return 0;
 }
 
@@ -588,369 +819,475 @@ int Runner::runCNNPredict()
 //  Sample loading helpers
 //===================================================================================================================//
 
-std::pair<ANN::Samples<float>, bool> Runner::loadANNSamplesFromOptions(const std::string& modeName,
-                                                                       QString& inputFilePath)
+template <typename SampleT>
+bool Runner::openSamplesFromOptions(const std::string& modeName, DataLoader<SampleT>& dataLoader,
+                                    QString& inputFilePath, int inputC, int inputH, int inputW)
 {
-  ANN::Samples<float> samples;
-
   bool hasJsonSamples = this->parser.isSet("samples");
   bool hasIdxData = this->parser.isSet("idx-data");
-  bool hasIdxLabels = this->parser.isSet("idx-labels");
 
   if (hasJsonSamples && hasIdxData) {
     std::cerr << "Error: Cannot use both --samples and --idx-data. Choose one format.\n";
-    return {samples, false};
+    return false;
   }
 
-  ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
-
-  if (hasJsonSamples) {
-    QString samplesPath = this->parser.value("samples");
-    inputFilePath = samplesPath;
+  if (hasJsonSamples && PackedDataset::isPackedFile(this->parser.value("samples").toStdString())) {
+    // Packed dataset (from --mode convert) — memory-mapped, samples read straight from the mapped pages
+    inputFilePath = this->parser.value("samples");
 
     if (this->logLevel >= LogLevel::INFO)
-      std::cout << "Loading " << modeName << " samples from JSON: " << samplesPath.toStdString() << "\n";
-    samples = Loader::loadANNSamples(samplesPath.toStdString(), this->ioConfig, displayProgressReports);
-  } else if (hasIdxData) {
-    if (!hasIdxLabels) {
-      std::cerr << "Error: --idx-labels is required when using --idx-data.\n";
-      return {samples, false};
-    }
-
-    QString idxDataPath = this->parser.value("idx-data");
-    QString idxLabelsPath = this->parser.value("idx-labels");
-    inputFilePath = idxDataPath;
+      std::cout << "Loading " << modeName << " samples from packed dataset: " << inputFilePath.toStdString() << "\n";
+    dataLoader.loadPacked(inputFilePath.toStdString(), inputC, inputH, inputW);
+  } else if (hasJsonSamples) {
+    // JSON samples — lightweight manifest; images are decoded per batch. Each image is read once per run, so only
+    // the persistent cache can help here.
+    inputFilePath = this->parser.value("samples");
 
-    if (this->logLevel >= LogLevel::INFO) {
-      std::cout << "Loading " << modeName << " samples from IDX:\n";
-      std::cout << "  Data:   " << idxDataPath.toStdString() << "\n";
-      std::cout << "  Labels: " << idxLabelsPath.toStdString() << "\n";
-    }
+    if (this->logLevel >= LogLevel::INFO)
+      std::cout << "Loading " << modeName << " samples from JSON: " << inputFilePath.toStdString() << "\n";
 
-    samples = Utils<float>::loadANNIDX(idxDataPath.toStdString(), idxLabelsPath.toStdString(), displayProgressReports);
+    int outputC = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputC) : 0;
+    int outputH = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputH) : 0;
+    int outputW = this->ioConfig.hasOutputShape() ? static_cast<int>(this->ioConfig.outputW) : 0;
+    dataLoader.loadManifest(inputFilePath.toStdString(), this->ioConfig, inputC, inputH, inputW, outputC, outputH,
+                            outputW);
+    dataLoader.setDiskImageCache(this->makeDiskImageCache());
   } else {
-    std::cerr << "Error: " << modeName << " requires either --samples (JSON) or --idx-data and --idx-labels (IDX).\n";
-    return {samples, false};
+    // IDX — raw bytes stay in memory; samples are normalised and one-hot encoded per batch
+    QString idxLabelsPath;
+
+    if (!this->idxPathsFromOptions(modeName, inputFilePath, idxLabelsPath))
+      return false;
+    dataLoader.loadIDX(inputFilePath.toStdString(), idxLabelsPath.toStdString(), inputC, inputH, inputW);
   }
 
   if (this->logLevel >= LogLevel::INFO)
-    std::cout << "Loaded " << samples.size() << " " << modeName << " samples.\n";
+    std::cout << "Loaded " << dataLoader.numSamples() << " " << modeName << " samples.\n";
 
-  return {samples, true};
+  return true;
 }
 
 //===================================================================================================================//
 
-std::pair<CNN::Samples<float>, bool> Runner::loadCNNSamplesFromOptions(const std::string& modeName,
-                                                                       QString& inputFilePath)
+template <typename SampleT, typename ResultT, typename TestFunction>
+ResultT Runner::testInBatches(const DataLoader<SampleT>& dataLoader, TestFunction test)
 {
-  CNN::Samples<float> samples;
+  ulong numSamples = dataLoader.numSamples();
+  ulong batchSize = this->testBatchSize;
+  ulong numBatches = (numSamples + batchSize - 1) / batchSize;
+  ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
 
-  bool hasJsonSamples = this->parser.isSet("samples");
-  bool hasIdxData = this->parser.isSet("idx-data");
-  bool hasIdxLabels = this->parser.isSet("idx-labels");
+  // Same provider as training, without augmentation: batch b + 1 is loaded while batch b is evaluated
+  std::vector<ulong> indices(numSamples);
+  std::iota(indices.begin(), indices.end(), 0);
+  auto sampleProvider = dataLoader.makeSampleProvider();
 
-  if (hasJsonSamples && hasIdxData) {
-    std::cerr << "Error: Cannot use both --samples and --idx-data. Choose one format.\n";
-    return {samples, false};
+  // Loss is summed in double so a long run of float batch totals does not lose precision
+  double totalLoss = 0.0;
+  ulong numCorrect = 0;
+  ulong numEvaluated = 0;
+
+  for (ulong b = 0; b < numBatches; b++) {
+    std::vector<SampleT> batch = sampleProvider(indices, batchSize, b);
+    ResultT batchResult = test(batch);
+    dataLoader.recycle(std::move(batch)); // Its buffers are refilled by a later prefetch
+
+    totalLoss += batchResult.totalLoss;
+    numCorrect += batchResult.numCorrect;
+    numEvaluated += batchResult.numSamples;
+
+    ProgressBar::printLoadingProgress("Evaluating:", numEvaluated, numSamples, displayProgressReports);
   }
 
-  const CNN::Shape3D& inputShape = this->cnnCoreConfig.inputShape;
+  ResultT result{};
+  result.numSamples = numEvaluated;
+  result.totalLoss = static_cast<decltype(result.totalLoss)>(totalLoss);
+  result.numCorrect = numCorrect;
+
+  if (numEvaluated > 0) {
+    result.averageLoss = static_cast<decltype(result.averageLoss)>(totalLoss / numEvaluated);
+    result.accuracy = static_cast<decltype(result.accuracy)>(100.0 * numCorrect / numEvaluated);
+  }
+
+  return result;
+}
+
+//===================================================================================================================//
+
+bool Runner::idxPathsFromOptions(const std::string& modeName, QString& dataPath, QString& labelsPath)
+{
+  if (!this->parser.isSet("idx-data")) {
+    std::cerr << "Error: " << modeName << " requires either --samples (JSON) or --idx-data and --idx-labels (IDX).\n";
+    return false;
+  }
 
+  if (!this->parser.isSet("idx-labels")) {
+    std::cerr << "Error: --idx-labels is required when using --idx-data.\n";
+    return false;
+  }
+
+  dataPath = this->parser.value("idx-data");
+  labelsPath = this->parser.value("idx-labels");
+
+  if (this->logLevel >= LogLevel::INFO) {
+    std::cout << "Loading " << modeName << " samples from IDX:\n";
+    std::cout << "  Data:   " << dataPath.toStdString() << "\n";
+    std::cout << "  Labels: " << labelsPath.toStdString() << "\n";
+  }
+
+  return true;
+}
+
+//===================================================================================================================//
+//  Predict helpers
+//===================================================================================================================//
+
+template <typename OutputT, typename CoreT, typename CoreConfigT, typename InputT>
+std::vector<OutputT> Runner::predictAll(CoreT& core, const CoreConfigT& coreConfig, bool parallel,
+                                        const std::vector<InputT>& inputs, int& numWorkers)
+{
+  // Inputs are handed out in chunks: small enough to balance the load, large enough to keep the counter cold
+  constexpr ulong chunkSize = 32;
+
+  ulong total = inputs.size();
+  ulong numChunks = (total + chunkSize - 1) / chunkSize;
+  numWorkers = static_cast<int>(std::max<ulong>(1, std::min<ulong>(maxPredictWorkers(coreConfig.numThreads, parallel),
+                                                                   numChunks)));
+
+  if (this->logLevel >= LogLevel::INFO && numWorkers > 1)
+    std::cout << "Predicting on " << numWorkers << " worker threads...\n";
+
+  std::vector<OutputT> outputs(total);
   ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
 
-  if (hasJsonSamples) {
-    QString samplesPath = this->parser.value("samples");
-    inputFilePath = samplesPath;
+  std::atomic<ulong> nextChunk{0};
+  std::atomic<bool> failed{false};
+  std::mutex mutex; // Guards completed, firstError and the progress line
+  ulong completed = 0;
+  std::exception_ptr firstError;
 
-    if (this->logLevel >= LogLevel::INFO)
-      std::cout << "Loading " << modeName << " samples from JSON: " << samplesPath.toStdString() << "\n";
-    samples = Loader::loadCNNSamples(samplesPath.toStdString(), inputShape, this->ioConfig, displayProgressReports);
-  } else if (hasIdxData) {
-    if (!hasIdxLabels) {
-      std::cerr << "Error: --idx-labels is required when using --idx-data.\n";
-      return {samples, false};
+  // Each worker writes only its own output slots, so results stay in input order
+  auto work = [&](CoreT& workerCore) {
+    while (!failed.load(std::memory_order_relaxed)) {
+      ulong start = nextChunk.fetch_add(1, std::memory_order_relaxed) * chunkSize;
+
+      if (start >= total)
+        return;
+
+      ulong end = std::min(start + chunkSize, total);
+
+      for (ulong i = start; i < end; i++)
+        outputs[i] = workerCore.predict(inputs[i]);
+
+      std::lock_guard<std::mutex> lock(mutex);
+
+      for (ulong i = start; i < end; i++)
+        ProgressBar::printLoadingProgress("Predicting:", ++completed, total, displayProgressReports);
     }
+  };
+
+  // Worker 0 uses the loaded core; the others build their own replica, since a core's predict is not safe to call
+  // concurrently
+  auto runWorker = [&](int worker) {
+    try {
+      if (worker == 0) {
+        work(core);
+        return;
+      }
 
-    QString idxDataPath = this->parser.value("idx-data");
-    QString idxLabelsPath = this->parser.value("idx-labels");
-    inputFilePath = idxDataPath;
+      auto replica = makeReplica<CoreT>(coreConfig);
+      work(*replica);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
 
-    if (this->logLevel >= LogLevel::INFO) {
-      std::cout << "Loading " << modeName << " samples from IDX:\n";
-      std::cout << "  Data:   " << idxDataPath.toStdString() << "\n";
-      std::cout << "  Labels: " << idxLabelsPath.toStdString() << "\n";
+      if (!firstError)
+        firstError = std::current_exception();
+
+      failed.store(true, std::memory_order_relaxed);
     }
+  };
 
-    samples = Utils<float>::loadCNNIDX(idxDataPath.toStdString(), idxLabelsPath.toStdString(), inputShape,
-                                       displayProgressReports);
+  if (numWorkers == 1) {
+    runWorker(0);
   } else {
-    std::cerr << "Error: " << modeName << " requires either --samples (JSON) or --idx-data and --idx-labels (IDX).\n";
-    return {samples, false};
+    QThreadPool pool;
+    pool.setMaxThreadCount(numWorkers);
+
+    QVector<QFuture<void>> futures;
+    futures.reserve(numWorkers);
+
+    for (int w = 0; w < numWorkers; w++)
+      futures.append(QtConcurrent::run(&pool, [&runWorker, w]() { runWorker(w); }));
+
+    for (auto& f : futures)
+      f.waitForFinished();
   }
 
-  if (this->logLevel >= LogLevel::INFO)
-    std::cout << "Loaded " << samples.size() << " " << modeName << " samples.\n";
+  if (firstError)
+    std::rethrow_exception(firstError);
 
-  return {samples, true};
+  return outputs;
 }
 
 //===================================================================================================================//
-//  Model saving
+
+int Runner::maxPredictWorkers(int numThreads, bool parallel)
+{
+  if (!parallel)
+    return 1;
+
+  return (numThreads > 0) ? numThreads : QThread::idealThreadCount();
+}
+
 //===================================================================================================================//
 
-void Runner::saveANNModel(const ANN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
-                          ulong progressReports, ulong saveModelInterval)
+template <typename CoreT, typename CoreConfigT>
+std::unique_ptr<CoreT> Runner::makeReplica(const CoreConfigT& coreConfig)
 {
-  nlohmann::ordered_json json;
+  // Single-threaded and silent: replicas run side by side, and the loaded core has already reported itself
+  CoreConfigT replicaConfig = coreConfig;
+  replicaConfig.numThreads = 1;
+  replicaConfig.logLevel = static_cast<decltype(replicaConfig.logLevel)>(LogLevel::QUIET);
+  return CoreT::makeCore(replicaConfig);
+}
 
-  json["mode"] = ANN::Mode::typeToName(core.getModeType());
-  json["device"] = ANN::Device::typeToName(core.getDeviceType());
-  json["numThreads"] = core.getNumThreads();
-  json["numGPUs"] = core.getNumGPUs();
+//===================================================================================================================//
 
-  // NN-CLI settings
-  json["progressReports"] = progressReports;
-  json["saveModelInterval"] = saveModelInterval;
+template <typename OutputT>
+void Runner::saveOutputImages(const QString& outputPath, const std::vector<OutputT>& outputs)
+{
+  QDir outDir(outputPath);
 
-  // I/O types (NN-CLI concept, persisted so predict/test can reload them)
-  json["inputType"] = dataTypeToString(ioConfig.inputType);
-  json["outputType"] = dataTypeToString(ioConfig.outputType);
+  if (!outDir.exists())
+    QDir().mkpath(outputPath);
 
-  if (ioConfig.hasInputShape()) {
-    nlohmann::ordered_json isJson;
-    isJson["c"] = ioConfig.inputC;
-    isJson["h"] = ioConfig.inputH;
-    isJson["w"] = ioConfig.inputW;
-    json["inputShape"] = isJson;
-  }
+  ImageLoader::setPngCompressionLevel(this->ioConfig.pngCompressionLevel);
+  ParallelImageWriter imageWriter(this->ioThreads, this->ioConfig.jpegQuality);
+  QString extension = QString::fromStdString("." + this->ioConfig.outputImageFormat);
 
-  if (ioConfig.hasOutputShape()) {
-    nlohmann::ordered_json osJson;
-    osJson["c"] = ioConfig.outputC;
-    osJson["h"] = ioConfig.outputH;
-    osJson["w"] = ioConfig.outputW;
-    json["outputShape"] = osJson;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    imageWriter.add(outDir.filePath(QString::number(i) + extension).toStdString(), outputs[i],
+                    static_cast<int>(this->ioConfig.outputC), static_cast<int>(this->ioConfig.outputH),
+                    static_cast<int>(this->ioConfig.outputW));
   }
 
-  // Layers config
-  nlohmann::ordered_json layersArr = nlohmann::ordered_json::array();
-  for (const auto& layer : core.getLayersConfig()) {
-    nlohmann::ordered_json layerJson;
-    layerJson["numNeurons"] = layer.numNeurons;
-    layerJson["actvFunc"] = ANN::ActvFunc::typeToName(layer.actvFuncType);
-    layersArr.push_back(layerJson);
-  }
+  ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
+  imageWriter.saveAll("Saving images:", displayProgressReports);
+}
 
-  json["layersConfig"] = layersArr;
+//===================================================================================================================//
 
-  // Cost function config
-  nlohmann::ordered_json cfcJson;
-  cfcJson["type"] = ANN::CostFunction::typeToName(core.getCostFunctionConfig().type);
+template <typename OutputT>
+int Runner::writePredictJson(const QString& outputPath, const nlohmann::ordered_json& predictMetadata,
+                             const std::vector<OutputT>& outputs)
+{
+  QFile outputFile(outputPath);
 
-  if (!core.getCostFunctionConfig().weights.empty()) {
-    cfcJson["weights"] = core.getCostFunctionConfig().weights;
+  if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    std::cerr << "Error: Failed to open output file: " << outputPath.toStdString() << "\n";
+    return 1;
   }
 
-  json["costFunctionConfig"] = cfcJson;
+  JsonWriter writer(outputFile);
+  writer.raw("{\n  \"predictMetadata\": ");
+  writer.value(predictMetadata, 2, 1);
+  writer.raw(",\n  \"outputs\": [");
 
-  // Training config
-  nlohmann::ordered_json tcJson;
-  tcJson["numEpochs"] = core.getTrainingConfig().numEpochs;
-  tcJson["learningRate"] = core.getTrainingConfig().learningRate;
-  tcJson["batchSize"] = core.getTrainingConfig().batchSize;
-  tcJson["shuffleSamples"] = core.getTrainingConfig().shuffleSamples;
+  for (size_t i = 0; i < outputs.size(); i++) {
+    writer.raw(i > 0 ? ",\n    " : "\n    ");
+    writer.array(outputs[i]);
+  }
 
-  if (core.getTrainingConfig().dropoutRate > 0.0f)
-    tcJson["dropoutRate"] = core.getTrainingConfig().dropoutRate;
-  json["trainingConfig"] = tcJson;
+  writer.raw("\n  ]\n}\n");
+  writer.flush();
+  outputFile.close();
 
-  // Training metadata
-  const auto& md = core.getTrainingMetadata();
-  nlohmann::ordered_json mdJson;
-  mdJson["startTime"] = md.startTime;
-  mdJson["endTime"] = md.endTime;
-  mdJson["durationSeconds"] = md.durationSeconds;
-  mdJson["durationFormatted"] = md.durationFormatted;
-  mdJson["numSamples"] = md.numSamples;
-  mdJson["finalLoss"] = md.finalLoss;
-  json["trainingMetadata"] = mdJson;
+  if (this->logLevel > LogLevel::QUIET)
+    std::cout << "Predict result saved to: " << outputPath.toStdString() << "\n";
+  return 0;
+}
 
-  // Parameters
-  nlohmann::ordered_json paramsJson;
-  paramsJson["weights"] = core.getParameters().weights;
-  paramsJson["biases"] = core.getParameters().biases;
-  json["parameters"] = paramsJson;
+//===================================================================================================================//
 
-  // Write to file
-  QFile file(QString::fromStdString(filePath));
+template <typename OutputT>
+int Runner::writePredictLines(const QString& outputPath, const std::vector<OutputT>& outputs,
+                              const std::string& durationFormatted, int numWorkers)
+{
+  QFile outputFile(outputPath);
 
-  if (!file.open(QIODevice::WriteOnly)) {
-    throw std::runtime_error("Failed to open file for writing: " + filePath);
+  if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    std::cerr << "Error: Failed to open output file: " << outputPath.toStdString() << "\n";
+    return 1;
+  }
+
+  JsonWriter writer(outputFile);
+
+  for (const OutputT& output : outputs) {
+    writer.array(output);
+    writer.raw("\n", 1);
+  }
+
+  writer.flush();
+  outputFile.close();
+
+  if (this->logLevel > LogLevel::QUIET) {
+    std::cout << "Predict result saved to: " << outputPath.toStdString() << "\n";
+    std::cout << "  Outputs: " << outputs.size() << "\n";
+    std::cout << "  Duration: " << durationFormatted << " (" << numWorkers << " worker(s))\n";
   }
 
-  std::string jsonStr = json.dump(4);
-  file.write(jsonStr.c_str());
-  file.close();
+  return 0;
 }
 
 //===================================================================================================================//
 
-void Runner::saveCNNModel(const CNN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
-                          ulong progressReports, ulong saveModelInterval)
+int Runner::runStreamingPredict(const QString& inputPath, const QString& outputPath, int numWorkers,
+                                const PredictPipeline::PredictFunction& predict)
 {
-  nlohmann::ordered_json json;
-
-  json["mode"] = CNN::Mode::typeToName(core.getModeType());
-  json["device"] = CNN::Device::typeToName(core.getDeviceType());
-  json["numThreads"] = core.getNumThreads();
-  json["numGPUs"] = core.getNumGPUs();
-
-  // NN-CLI settings
-  json["progressReports"] = progressReports;
-  json["saveModelInterval"] = saveModelInterval;
-
-  // I/O types (NN-CLI concept, persisted so predict/test can reload them)
-  json["inputType"] = dataTypeToString(ioConfig.inputType);
-  json["outputType"] = dataTypeToString(ioConfig.outputType);
-
-  // Input shape (CNN network shape, always present)
-  const auto& shape = core.getInputShape();
-  nlohmann::ordered_json shapeJson;
-  shapeJson["c"] = shape.c;
-  shapeJson["h"] = shape.h;
-  shapeJson["w"] = shape.w;
-  json["inputShape"] = shapeJson;
-
-  // Output shape (for image output reconstruction)
-  if (ioConfig.hasOutputShape()) {
-    nlohmann::ordered_json osJson;
-    osJson["c"] = ioConfig.outputC;
-    osJson["h"] = ioConfig.outputH;
-    osJson["w"] = ioConfig.outputW;
-    json["outputShape"] = osJson;
-  }
-
-  // CNN layers config
-  nlohmann::ordered_json cnnLayersArr = nlohmann::ordered_json::array();
-  for (const auto& layer : core.getLayersConfig().cnnLayers) {
-    nlohmann::ordered_json layerJson;
-    switch (layer.type) {
-    case CNN::LayerType::CONV: {
-      const auto& conv = std::get<CNN::ConvLayerConfig>(layer.config);
-      layerJson["type"] = "conv";
-      layerJson["numFilters"] = conv.numFilters;
-      layerJson["filterH"] = conv.filterH;
-      layerJson["filterW"] = conv.filterW;
-      layerJson["strideY"] = conv.strideY;
-      layerJson["strideX"] = conv.strideX;
-      layerJson["slidingStrategy"] = CNN::SlidingStrategy::typeToName(conv.slidingStrategy);
-      break;
-    }
+  QFile inputFile(inputPath);
 
-    case CNN::LayerType::RELU:
-      layerJson["type"] = "relu";
-      break;
-    case CNN::LayerType::POOL: {
-      const auto& pool = std::get<CNN::PoolLayerConfig>(layer.config);
-      layerJson["type"] = "pool";
-      layerJson["poolType"] = CNN::PoolType::typeToName(pool.poolType);
-      layerJson["poolH"] = pool.poolH;
-      layerJson["poolW"] = pool.poolW;
-      layerJson["strideY"] = pool.strideY;
-      layerJson["strideX"] = pool.strideX;
-      break;
-    }
+  if (!inputFile.open(QIODevice::ReadOnly)) {
+    std::cerr << "Error: Failed to open input file: " << inputPath.toStdString() << "\n";
+    return 1;
+  }
 
-    case CNN::LayerType::FLATTEN:
-      layerJson["type"] = "flatten";
-      break;
-    }
+  bool imageOutput = (this->ioConfig.outputType == DataType::IMAGE);
 
-    cnnLayersArr.push_back(layerJson);
+  if (imageOutput && !this->ioConfig.hasOutputShape()) {
+    std::cerr << "Error: outputType is 'image' but no outputShape provided in config.\n";
+    return 1;
   }
 
-  json["convolutionalLayersConfig"] = cnnLayersArr;
+  // Image outputs go to a folder as they complete; vector outputs are appended to the "outputs" array, or written
+  // one per line (and flushed, so the file can be tailed) for JSON Lines
+  bool jsonLines = !imageOutput && JsonStream::isJsonLinesPath(outputPath.toStdString());
+  QDir outDir(outputPath);
+  QFile outputFile(outputPath);
+  JsonWriter writer(outputFile);
+
+  if (imageOutput) {
+    if (!outDir.exists())
+      QDir().mkpath(outputPath);
+
+    ImageLoader::setPngCompressionLevel(this->ioConfig.pngCompressionLevel);
+  } else {
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+      std::cerr << "Error: Failed to open output file: " << outputPath.toStdString() << "\n";
+      return 1;
+    }
 
-  // Dense layers config
-  nlohmann::ordered_json denseLayersArr = nlohmann::ordered_json::array();
-  for (const auto& layer : core.getLayersConfig().denseLayers) {
-    nlohmann::ordered_json layerJson;
-    layerJson["numNeurons"] = layer.numNeurons;
-    layerJson["actvFunc"] = ANN::ActvFunc::typeToName(layer.actvFuncType);
-    denseLayersArr.push_back(layerJson);
+    if (!jsonLines)
+      writer.raw("{\n  \"outputs\": [");
   }
 
-  json["denseLayersConfig"] = denseLayersArr;
+  if (this->logLevel >= LogLevel::INFO) {
+    std::cout << "Streaming inputs from: " << inputPath.toStdString() << " (" << numWorkers << " worker(s))\n";
+  }
 
-  // Cost function config
-  nlohmann::ordered_json cfcJson;
-  cfcJson["type"] = CNN::CostFunction::typeToName(core.getCostFunctionConfig().type);
+  auto batchStart = std::chrono::system_clock::now();
+  std::string startTimeStr = ANN::Utils<float>::formatISO8601();
+  double firstResultSeconds = 0.0;
+
+  // Output images are encoded and saved on the worker that predicted them; the writer only keeps the order
+  PredictPipeline::FinishFunction saveImage;
 
-  if (!core.getCostFunctionConfig().weights.empty()) {
-    cfcJson["weights"] = core.getCostFunctionConfig().weights;
+  if (imageOutput) {
+    // Paths are built from plain strings, since the workers share them
+    std::string imageDir = outDir.absolutePath().toStdString() + "/";
+
+    saveImage = [this, imageDir](ulong index, const std::vector<float>& output) {
+      std::string imagePath = imageDir + std::to_string(index) + "." + this->ioConfig.outputImageFormat;
+      ImageLoader::saveImage(imagePath, output, static_cast<int>(this->ioConfig.outputC),
+                             static_cast<int>(this->ioConfig.outputH), static_cast<int>(this->ioConfig.outputW),
+                             this->ioConfig.jpegQuality);
+    };
   }
 
-  json["costFunctionConfig"] = cfcJson;
+  auto write = [&](ulong index, const std::vector<float>& output) {
+    if (index == 0) {
+      std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - batchStart;
+      firstResultSeconds = elapsed.count();
+    }
 
-  // Training config
-  nlohmann::ordered_json tcJson;
-  tcJson["numEpochs"] = core.getTrainingConfig().numEpochs;
-  tcJson["learningRate"] = core.getTrainingConfig().learningRate;
-  tcJson["batchSize"] = core.getTrainingConfig().batchSize;
-  tcJson["shuffleSamples"] = core.getTrainingConfig().shuffleSamples;
+    if (imageOutput)
+      return;
 
-  if (core.getTrainingConfig().dropoutRate > 0.0f)
-    tcJson["dropoutRate"] = core.getTrainingConfig().dropoutRate;
-  json["trainingConfig"] = tcJson;
+    if (jsonLines) {
+      writer.array(output);
+      writer.raw("\n", 1);
+      writer.flush();
+      return;
+    }
+
+    writer.raw(index == 0 ? "\n    " : ",\n    ");
+    writer.array(output);
+  };
 
-  // Training metadata
-  const auto& md = core.getTrainingMetadata();
-  nlohmann::ordered_json mdJson;
-  mdJson["startTime"] = md.startTime;
-  mdJson["endTime"] = md.endTime;
-  mdJson["durationSeconds"] = md.durationSeconds;
-  mdJson["durationFormatted"] = md.durationFormatted;
-  mdJson["numSamples"] = md.numSamples;
-  mdJson["finalLoss"] = md.finalLoss;
-  json["trainingMetadata"] = mdJson;
+  ulong displayProgressReports = (this->logLevel > LogLevel::QUIET) ? this->progressReports : 0;
+  PredictPipeline pipeline(numWorkers, static_cast<ulong>(numWorkers) * 16);
+  ulong numInputs = pipeline.run(inputFile, "inputs", predict, saveImage, write, displayProgressReports);
 
-  // Parameters
-  nlohmann::ordered_json paramsJson;
+  if (numInputs == 0) {
+    if (!imageOutput)
+      outputFile.remove();
 
-  // Conv parameters
-  nlohmann::ordered_json convArr = nlohmann::ordered_json::array();
-  for (const auto& cp : core.getParameters().convParams) {
-    nlohmann::ordered_json cpJson;
-    cpJson["numFilters"] = cp.numFilters;
-    cpJson["inputC"] = cp.inputC;
-    cpJson["filterH"] = cp.filterH;
-    cpJson["filterW"] = cp.filterW;
-    cpJson["filters"] = cp.filters;
-    cpJson["biases"] = cp.biases;
-    convArr.push_back(cpJson);
+    throw std::runtime_error("No inputs found in: " + inputPath.toStdString());
   }
 
-  paramsJson["convolutional"] = convArr;
+  auto batchEnd = std::chrono::system_clock::now();
+  std::string endTimeStr = ANN::Utils<float>::formatISO8601();
+  std::chrono::duration<double> batchElapsed = batchEnd - batchStart;
+  double batchDurationSeconds = batchElapsed.count();
+  std::string batchDurationFormatted = ANN::Utils<float>::formatDuration(batchDurationSeconds);
 
-  // Dense parameters
-  nlohmann::ordered_json denseParamsJson;
-  denseParamsJson["weights"] = core.getParameters().denseParams.weights;
-  denseParamsJson["biases"] = core.getParameters().denseParams.biases;
-  paramsJson["dense"] = denseParamsJson;
+  if (imageOutput) {
+    if (this->logLevel > LogLevel::QUIET) {
+      std::cout << "Predict images saved to: " << outputPath.toStdString() << "\n";
+      std::cout << "  Images: " << numInputs << "\n";
+      std::cout << "  Shape: " << this->ioConfig.outputC << "x" << this->ioConfig.outputH << "x"
+                << this->ioConfig.outputW << "\n";
+      std::cout << "  Duration: " << batchDurationFormatted << " (" << numWorkers << " worker(s))\n";
+    }
+
+    return 0;
+  }
 
-  json["parameters"] = paramsJson;
+  if (jsonLines) {
+    writer.flush();
+    outputFile.close();
 
-  // Write to file
-  QFile file(QString::fromStdString(filePath));
+    if (this->logLevel > LogLevel::QUIET) {
+      std::cout << "Predict result saved to: " << outputPath.toStdString() << "\n";
+      std::cout << "  Outputs: " << numInputs << "\n";
+      std::cout << "  Duration: " << batchDurationFormatted << " (" << numWorkers << " worker(s))\n";
+      std::cout << "  First result after: " << ANN::Utils<float>::formatDuration(firstResultSeconds) << "\n";
+    }
 
-  if (!file.open(QIODevice::WriteOnly)) {
-    throw std::runtime_error("Failed to open file for writing: " + filePath);
+    return 0;
   }
 
-  std::string jsonStr = json.dump(4);
-  file.write(jsonStr.c_str());
-  file.close();
+  // Metadata is only known at the end, so it follows the outputs
+  nlohmann::ordered_json predictMetadataJson;
+  predictMetadataJson["startTime"] = startTimeStr;
+  predictMetadataJson["endTime"] = endTimeStr;
+  predictMetadataJson["durationSeconds"] = batchDurationSeconds;
+  predictMetadataJson["durationFormatted"] = batchDurationFormatted;
+  predictMetadataJson["numInputs"] = numInputs;
+  predictMetadataJson["numWorkers"] = numWorkers;
+  predictMetadataJson["inputsPerSecond"] = (batchDurationSeconds > 0) ? numInputs / batchDurationSeconds : 0.0;
+  predictMetadataJson["inputsPerSecondPerWorker"] =
+    (batchDurationSeconds > 0) ? numInputs / batchDurationSeconds / numWorkers : 0.0;
+  predictMetadataJson["firstResultSeconds"] = firstResultSeconds;
+
+  writer.raw("\n  ],\n  \"predictMetadata\": ");
+  writer.value(predictMetadataJson, 2, 1);
+  writer.raw("\n}\n");
+  writer.flush();
+  outputFile.close();
+
+  if (this->logLevel > LogLevel::QUIET)
+    std::cout << "Predict result saved to: " << outputPath.toStdString() << "\n";
+  return 0;
 }
 
 //===================================================================================================================//
@@ -982,7 +1319,8 @@ std::string Runner::generateDefaultOutputPath(const QString& inputFilePath, ulon
 
 //===================================================================================================================//
 
-std::string Runner::generateCheckpointPath(const QString& inputFilePath, ulong epoch, float loss)
+std::string Runner::generateCheckpointPath(const QString& inputFilePath, ulong epoch, float loss,
+                                           const std::string& extension)
 {
   QFileInfo inputInfo(inputFilePath);
   QDir inputDir = inputInfo.absoluteDir();
@@ -993,12 +1331,33 @@ std::string Runner::generateCheckpointPath(const QString& inputFilePath, ulong e
   }
 
   std::ostringstream oss;
-  oss << "checkpoint_E-" << epoch << "_L-" << std::fixed << std::setprecision(6) << loss << ".json";
+  oss << "checkpoint_E-" << epoch << "_L-" << std::fixed << std::setprecision(6) << loss << extension;
 
   QString outputPath = outputDir.filePath(QString::fromStdString(oss.str()));
   return outputPath.toStdString();
 }
 
+std::string Runner::modelFileExtension() const
+{
+  // Checkpoints use the same container format as the final model (--output model.nnb selects binary)
+  if (this->parser.isSet("output"))
+    return ModelFile::extension(ModelFile::formatForPath(this->parser.value("output").toStdString()));
+
+  return ModelFile::extension(ModelFile::Format::JSON);
+}
+
+ModelFile::Settings Runner::modelSettings() const
+{
+  // Saved into models and checkpoints so predict/test/serve runs of them get the settings they were trained with
+  ModelFile::Settings settings;
+  settings.progressReports = this->progressReports;
+  settings.saveModelInterval = this->saveModelInterval;
+  settings.ioThreads = this->ioThreads;
+  settings.testBatchSize = this->testBatchSize;
+  settings.serveConfig = this->serveConfig;
+  return settings;
+}
+
 //===================================================================================================================//
 //  Training helpers
 //===================================================================================================================//
@@ -1012,6 +1371,8 @@ void Runner::setupANNTrainingCallback(const QString& inputFilePath)
 
   static ProgressBar progressBar(this->progressReports);
 
+  this->checkpointWriter = std::make_unique<CheckpointWriter>(this->logLevel);
+
   this->annCore->setTrainingCallback([this, inputFilePath](const ANN::TrainingProgress<float>& progress) {
     if (this->logLevel > LogLevel::QUIET) {
       ProgressInfo info{progress.currentEpoch, progress.totalEpochs, progress.currentSample, progress.totalSamples,
@@ -1019,13 +1380,19 @@ void Runner::setupANNTrainingCallback(const QString& inputFilePath)
       progressBar.update(info);
     }
 
-    if (this->saveModelInterval > 0 && progress.currentEpoch > lastCallbackEpoch) {
-      if (lastCallbackEpoch > 0 && lastCallbackEpoch % this->saveModelInterval == 0) {
-        std::string checkpointPath = generateCheckpointPath(inputFilePath, lastCallbackEpoch, lastEpochLoss);
-        saveANNModel(*this->annCore, checkpointPath, this->ioConfig, this->progressReports, this->saveModelInterval);
+    if (progress.currentEpoch > lastCallbackEpoch) {
+      if (lastCallbackEpoch > 0)
+        this->reportSampleLoading("epoch " + std::to_string(lastCallbackEpoch));
 
-        if (this->logLevel > LogLevel::QUIET)
-          std::cout << "\nCheckpoint saved to: " << checkpointPath << "\n";
+      if (this->saveModelInterval > 0 && lastCallbackEpoch > 0 && lastCallbackEpoch % this->saveModelInterval == 0) {
+        std::string checkpointPath =
+          generateCheckpointPath(inputFilePath, lastCallbackEpoch, lastEpochLoss, this->modelFileExtension());
+
+        // Only copy the parameters here; serialisation and the file write happen on the checkpoint thread
+        auto snapshot = std::make_shared<ModelFile::ANNSnapshot>(
+          ModelFile::snapshotANN(*this->annCore, this->ioConfig, this->modelSettings()));
+        this->checkpointWriter->submit(
+          checkpointPath, [snapshot](const std::string& filePath) { ModelFile::saveANNModel(*snapshot, filePath); });
       }
 
       lastCallbackEpoch = progress.currentEpoch;
@@ -1047,6 +1414,8 @@ void Runner::setupCNNTrainingCallback(const QString& inputFilePath)
 
   static ProgressBar progressBar(this->progressReports);
 
+  this->checkpointWriter = std::make_unique<CheckpointWriter>(this->logLevel);
+
   this->cnnCore->setTrainingCallback([this, inputFilePath](const CNN::TrainingProgress<float>& progress) {
     if (this->logLevel > LogLevel::QUIET) {
       ProgressInfo info{progress.currentEpoch, progress.totalEpochs, progress.currentSample, progress.totalSamples,
@@ -1054,13 +1423,19 @@ void Runner::setupCNNTrainingCallback(const QString& inputFilePath)
       progressBar.update(info);
     }
 
-    if (this->saveModelInterval > 0 && progress.currentEpoch > lastCallbackEpoch) {
-      if (lastCallbackEpoch > 0 && lastCallbackEpoch % this->saveModelInterval == 0) {
-        std::string checkpointPath = generateCheckpointPath(inputFilePath, lastCallbackEpoch, lastEpochLoss);
-        saveCNNModel(*this->cnnCore, checkpointPath, this->ioConfig, this->progressReports, this->saveModelInterval);
+    if (progress.currentEpoch > lastCallbackEpoch) {
+      if (lastCallbackEpoch > 0)
+        this->reportSampleLoading("epoch " + std::to_string(lastCallbackEpoch));
+
+      if (this->saveModelInterval > 0 && lastCallbackEpoch > 0 && lastCallbackEpoch % this->saveModelInterval == 0) {
+        std::string checkpointPath =
+          generateCheckpointPath(inputFilePath, lastCallbackEpoch, lastEpochLoss, this->modelFileExtension());
 
-        if (this->logLevel > LogLevel::QUIET)
-          std::cout << "\nCheckpoint saved to: " << checkpointPath << "\n";
+        // Only copy the parameters here; serialisation and the file write happen on the checkpoint thread
+        auto snapshot = std::make_shared<ModelFile::CNNSnapshot>(
+          ModelFile::snapshotCNN(*this->cnnCore, this->ioConfig, this->modelSettings()));
+        this->checkpointWriter->submit(
+          checkpointPath, [snapshot](const std::string& filePath) { ModelFile::saveCNNModel(*snapshot, filePath); });
       }
 
       lastCallbackEpoch = progress.currentEpoch;
@@ -1073,11 +1448,110 @@ void Runner::setupCNNTrainingCallback(const QString& inputFilePath)
 
 //===================================================================================================================//
 
+std::shared_ptr<ImageCache> Runner::makeImageCache()
+{
+  bool decodesImages = (this->ioConfig.inputType == DataType::IMAGE || this->ioConfig.outputType == DataType::IMAGE);
+
+  if (this->imageCacheMB == 0 || !decodesImages)
+    return nullptr;
+
+  this->imageCache = std::make_shared<ImageCache>(static_cast<size_t>(this->imageCacheMB) * 1024 * 1024);
+
+  if (this->logLevel >= LogLevel::INFO)
+    std::cout << "Image cache: " << this->imageCacheMB << " MB\n";
+
+  return this->imageCache;
+}
+
+//===================================================================================================================//
+
+std::shared_ptr<DiskImageCache> Runner::makeDiskImageCache()
+{
+  bool decodesImages = (this->ioConfig.inputType == DataType::IMAGE || this->ioConfig.outputType == DataType::IMAGE);
+
+  if (this->imageCacheDir.empty() || !decodesImages)
+    return nullptr;
+
+  this->diskImageCache = std::make_shared<DiskImageCache>(this->imageCacheDir);
+
+  if (this->logLevel >= LogLevel::INFO)
+    std::cout << "Image cache directory: " << this->diskImageCache->directory() << "\n";
+
+  return this->diskImageCache;
+}
+
+//===================================================================================================================//
+
+ulong Runner::resolveAugmentationSeed()
+{
+  ulong seed;
+
+  if (this->augmentationSeed.has_value()) {
+    seed = this->augmentationSeed.value();
+  } else {
+    std::random_device device;
+    seed = (static_cast<ulong>(device()) << 32) | device();
+  }
+
+  // Printed so a run with a drawn seed can be repeated by setting it as augmentationSeed
+  if (this->logLevel >= LogLevel::INFO && (this->augmentationFactor > 0 || this->balanceAugmentation))
+    std::cout << "Augmentation seed: " << seed << "\n";
+
+  return seed;
+}
+
+//===================================================================================================================//
+
+void Runner::reportSampleLoading(const std::string& label)
+{
+  if (this->imageCache) {
+    ImageCache::Stats stats = this->imageCache->takeStats();
+
+    if (this->logLevel >= LogLevel::INFO && stats.hits + stats.misses > 0) {
+      std::ostringstream line;
+      line << std::fixed << std::setprecision(1) << "\nImage cache (" << label << "): " << (stats.hitRate() * 100.0)
+           << "% hits (" << stats.hits << " hits, " << stats.misses << " misses), " << stats.entries << " images, "
+           << (static_cast<double>(stats.bytes) / (1024.0 * 1024.0)) << " MB\n";
+      std::cout << line.str();
+    }
+  }
+
+  if (this->diskImageCache) {
+    DiskImageCache::Stats stats = this->diskImageCache->takeStats();
+
+    if (this->logLevel >= LogLevel::INFO && stats.hits + stats.misses + stats.rebuilt > 0) {
+      std::cout << "\nImage cache directory (" << label << "): " << stats.hits << " read, "
+                << (stats.misses + stats.rebuilt) << " decoded (" << stats.rebuilt << " stale or corrupt)\n";
+    }
+
+    if (stats.writeFailures > 0 && this->logLevel > LogLevel::QUIET) {
+      std::cerr << "\nWarning: " << stats.writeFailures << " image(s) could not be written to the cache directory: "
+                << this->diskImageCache->directory() << "\n";
+    }
+  }
+
+  // Decoding buffers served by the I/O threads' scratch arenas, and those that still needed malloc
+  ScratchArena::Stats scratchStats = ScratchArena::takeStats();
+
+  if (this->logLevel >= LogLevel::INFO && scratchStats.batches > 0 &&
+      scratchStats.scratchAllocations + scratchStats.heapAllocations > 0) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1) << "\nDecoding allocations per batch (" << label << "): "
+         << scratchStats.perBatch(scratchStats.scratchAllocations) << " from scratch arenas, "
+         << scratchStats.perBatch(scratchStats.heapAllocations) << " from the heap\n";
+    std::cout << line.str();
+  }
+}
+
+//===================================================================================================================//
+
 int Runner::finishANNTraining(const QString& inputFilePath)
 {
   if (this->logLevel > LogLevel::QUIET)
     std::cout << "\nTraining completed.\n";
 
+  this->reportSampleLoading("final epoch");
+
   const auto& trainingConfig = this->annCore->getTrainingConfig();
   const auto& trainingMetadata = this->annCore->getTrainingMetadata();
 
@@ -1090,7 +1564,11 @@ int Runner::finishANNTraining(const QString& inputFilePath)
                                               trainingMetadata.finalLoss);
   }
 
-  saveANNModel(*this->annCore, outputPathStr, this->ioConfig, this->progressReports, this->saveModelInterval);
+  // Let any in-flight checkpoint finish before the final model is written
+  if (this->checkpointWriter)
+    this->checkpointWriter->flush();
+
+  ModelFile::saveANNModel(*this->annCore, outputPathStr, this->ioConfig, this->modelSettings());
 
   if (this->logLevel > LogLevel::QUIET)
     std::cout << "Model saved to: " << outputPathStr << "\n";
@@ -1104,6 +1582,8 @@ int Runner::finishCNNTraining(const QString& inputFilePath)
   if (this->logLevel > LogLevel::QUIET)
     std::cout << "\nTraining completed.\n";
 
+  this->reportSampleLoading("final epoch");
+
   const auto& trainingConfig = this->cnnCore->getTrainingConfig();
   const auto& trainingMetadata = this->cnnCore->getTrainingMetadata();
 
@@ -1116,7 +1596,11 @@ int Runner::finishCNNTraining(const QString& inputFilePath)
                                               trainingMetadata.finalLoss);
   }
 
-  saveCNNModel(*this->cnnCore, outputPathStr, this->ioConfig, this->progressReports, this->saveModelInterval);
+  // Let any in-flight checkpoint finish before the final model is written
+  if (this->checkpointWriter)
+    this->checkpointWriter->flush();
+
+  ModelFile::saveCNNModel(*this->cnnCore, outputPathStr, this->ioConfig, this->modelSettings());
 
   if (this->logLevel > LogLevel::QUIET)
     std::cout << "Model saved to: " << outputPathStr << "\n";
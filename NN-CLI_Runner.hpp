@@ -1,10 +1,16 @@
 #ifndef NN_CLI_RUNNER_HPP
 #define NN_CLI_RUNNER_HPP
 
+#include "NN-CLI_CheckpointWriter.hpp"
+#include "NN-CLI_DiskImageCache.hpp"
+#include "NN-CLI_ImageCache.hpp"
 #include "NN-CLI_Loader.hpp"
 #include "NN-CLI_NetworkType.hpp"
 #include "NN-CLI_IOConfig.hpp"
 #include "NN-CLI_LogLevel.hpp"
+#include "NN-CLI_ModelFile.hpp"
+#include "NN-CLI_PredictPipeline.hpp"
+#include "NN-CLI_Server.hpp"
 
 #include <ANN_Core.hpp>
 #include <CNN_Core.hpp>
@@ -12,6 +18,7 @@
 #include <QCommandLineParser>
 
 #include <memory>
+#include <optional>
 #include <string>
 
 //===================================================================================================================//
@@ -19,8 +26,11 @@
 namespace NN_CLI
 {
 
+  template <typename SampleT>
+  class DataLoader;
+
   /**
- * Runner class handles the execution of ANN and CNN modes (train, test, predict).
+ * Runner class handles the execution of ANN and CNN modes (train, test, predict) and dataset conversion.
  * Automatically detects network type from the config file and delegates to the
  * appropriate library.
  */
@@ -44,23 +54,77 @@ namespace NN_CLI
       int runCNNTest();
       int runCNNPredict();
 
-      //-- Sample loading --//
-      std::pair<ANN::Samples<float>, bool> loadANNSamplesFromOptions(const std::string& modeName,
-                                                                     QString& inputFilePath);
-      std::pair<CNN::Samples<float>, bool> loadCNNSamplesFromOptions(const std::string& modeName,
-                                                                     QString& inputFilePath);
+      //-- Serve mode --//
+      // Answer framed predict requests on stdin/stdout, or on the --socket Unix domain socket, until end of input
+      int runServe();
+
+      // Serve with one core per worker (core plus replicas, as in predictAll), batching the inputs of concurrent
+      // requests through a PredictScheduler; makeInput turns a request's flat values into an InputT
+      template <typename InputT, typename OutputT, typename CoreT, typename CoreConfigT, typename MakeInput>
+      int serveRequests(CoreT& core, const CoreConfigT& coreConfig, bool parallel, size_t inputSize,
+                        const Server::ParseFunction& parse, MakeInput makeInput);
+
+      //-- Dataset conversion --//
+      int runConvert();
 
-      //-- Model saving --//
-      static void saveANNModel(const ANN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
-                               ulong progressReports, ulong saveModelInterval);
-      static void saveCNNModel(const CNN::Core<float>& core, const std::string& filePath, const IOConfig& ioConfig,
-                               ulong progressReports, ulong saveModelInterval);
+      //-- Sample loading --//
+      // Point dataLoader at the --samples (JSON or packed) or --idx-data/--idx-labels set, without loading sample
+      // data; prints the error and returns false if the options are unusable
+      template <typename SampleT>
+      bool openSamplesFromOptions(const std::string& modeName, DataLoader<SampleT>& dataLoader,
+                                  QString& inputFilePath, int inputC, int inputH, int inputW);
+
+      // Evaluate every sample of dataLoader in batches of testBatchSize, prefetching the next batch while the current
+      // one is tested, and merge the per-batch results
+      template <typename SampleT, typename ResultT, typename TestFunction>
+      ResultT testInBatches(const DataLoader<SampleT>& dataLoader, TestFunction test);
+
+      // Validate --idx-data/--idx-labels and report them; prints the error and returns false if unusable
+      bool idxPathsFromOptions(const std::string& modeName, QString& dataPath, QString& labelsPath);
+
+      //-- Predict helpers --//
+      // Predict every input, keeping input order. When parallel (CPU cores), inputs are shared out among up to
+      // coreConfig.numThreads workers (0 = one per core), each predicting with its own replica of the core.
+      // numWorkers receives the number of workers used.
+      template <typename OutputT, typename CoreT, typename CoreConfigT, typename InputT>
+      std::vector<OutputT> predictAll(CoreT& core, const CoreConfigT& coreConfig, bool parallel,
+                                      const std::vector<InputT>& inputs, int& numWorkers);
+
+      // Worker threads available to predict: numThreads (0 = one per core) when parallel, otherwise 1
+      static int maxPredictWorkers(int numThreads, bool parallel);
+
+      // Independent copy of the loaded model for one predict worker (single-threaded, silent)
+      template <typename CoreT, typename CoreConfigT>
+      static std::unique_ptr<CoreT> makeReplica(const CoreConfigT& coreConfig);
+
+      // Save image outputs as 0.<format>, 1.<format>, ... in the outputPath folder, encoding them on ioThreads workers
+      template <typename OutputT>
+      void saveOutputImages(const QString& outputPath, const std::vector<OutputT>& outputs);
+
+      // Save vector outputs as {"predictMetadata": ..., "outputs": [...]}, one output per line
+      template <typename OutputT>
+      int writePredictJson(const QString& outputPath, const nlohmann::ordered_json& predictMetadata,
+                           const std::vector<OutputT>& outputs);
+
+      // Save vector outputs as JSON Lines, one per line in input order; metadata is printed instead of stored
+      template <typename OutputT>
+      int writePredictLines(const QString& outputPath, const std::vector<OutputT>& outputs,
+                            const std::string& durationFormatted, int numWorkers);
+
+      // --stream: read, predict and write concurrently (see PredictPipeline), so memory does not grow with the
+      // number of inputs. Vector outputs are appended to the JSON (or JSON Lines) file as they complete, images
+      // saved one by one.
+      int runStreamingPredict(const QString& inputPath, const QString& outputPath, int numWorkers,
+                              const PredictPipeline::PredictFunction& predict);
 
       //-- Output path helpers --//
       static std::string generateTrainingFilename(ulong epochs, ulong samples, float loss);
       static std::string generateDefaultOutputPath(const QString& inputFilePath, ulong epochs, ulong samples,
                                                    float loss);
-      static std::string generateCheckpointPath(const QString& inputFilePath, ulong epoch, float loss);
+      static std::string generateCheckpointPath(const QString& inputFilePath, ulong epoch, float loss,
+                                                const std::string& extension);
+      std::string modelFileExtension() const;
+      ModelFile::Settings modelSettings() const;
 
       //-- Training helpers --//
       void setupANNTrainingCallback(const QString& inputFilePath);
@@ -68,6 +132,12 @@ namespace NN_CLI
       int finishANNTraining(const QString& inputFilePath);
       int finishCNNTraining(const QString& inputFilePath);
 
+      //-- Image cache and sample loading helpers --//
+      std::shared_ptr<ImageCache> makeImageCache();
+      std::shared_ptr<DiskImageCache> makeDiskImageCache();
+      ulong resolveAugmentationSeed();
+      void reportSampleLoading(const std::string& label);
+
       //-- Class weight computation --//
       std::vector<float> computeClassWeightsFromOutputs(const std::vector<std::vector<float>>& outputs);
 
@@ -75,16 +145,22 @@ namespace NN_CLI
       const QCommandLineParser& parser;
       LogLevel logLevel;
       NetworkType networkType;
-      std::string mode; // "train", "test", "predict"
+      std::string mode; // "train", "test", "predict", "convert", "serve"
       IOConfig ioConfig; // inputType / outputType / shapes (NN-CLI concept only)
       ulong progressReports = 1000; // NN-CLI display frequency (not used by ANN/CNN libs)
       ulong saveModelInterval = 10; // 0 = disabled
+      ulong imageCacheMB = 512; // Decoded-image cache budget for JSON samples (0 = disabled)
+      std::string imageCacheDir; // Persistent decoded-image cache directory (empty = disabled)
+      int ioThreads = 0; // Image-decoding threads (0 = one per core)
+      ulong testBatchSize = 1024; // Samples held in memory at once in test mode
+      Loader::ServeConfig serveConfig; // Micro-batching of serve mode requests
 
       //-- Data augmentation config (parsed from trainingConfig, handled by NN-CLI only) --//
       ulong augmentationFactor = 0; // 0 = disabled; N = N× total samples per class
       bool balanceAugmentation = false; // true = augment minority classes up to max class count
       bool autoClassWeights = false; // true = auto-compute inverse-frequency class weights
       float augmentationProbability = 0.5f; // Probability of applying each enabled transform
+      std::optional<ulong> augmentationSeed; // Seed of the transforms (unset = a new one each run)
       Loader::AugmentationTransforms augTransforms; // Which transforms to apply
 
       //-- ANN members --//
@@ -94,6 +170,13 @@ namespace NN_CLI
       //-- CNN members --//
       std::unique_ptr<CNN::Core<float>> cnnCore;
       CNN::CoreConfig<float> cnnCoreConfig;
+
+      //-- Background checkpoint writes (created when training starts) --//
+      std::unique_ptr<CheckpointWriter> checkpointWriter;
+
+      //-- Decoded-image caches for manifest samples (nullptr when unused) --//
+      std::shared_ptr<ImageCache> imageCache;
+      std::shared_ptr<DiskImageCache> diskImageCache;
   };
 
 } // namespace NN_CLI
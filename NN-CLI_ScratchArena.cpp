@@ -0,0 +1,190 @@
+#include "NN-CLI_ScratchArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  namespace
+  {
+    constexpr size_t alignment = alignof(std::max_align_t);
+    constexpr size_t growthStep = 64 * 1024;
+    constexpr size_t noAllocation = static_cast<size_t>(-1);
+
+    size_t alignUp(size_t size, size_t to)
+    {
+      return (size + to - 1) / to * to;
+    }
+
+    struct Arena {
+        std::unique_ptr<unsigned char[]> block;
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t lastOffset = noAllocation; // The most recent allocation, which can grow and shrink in place
+        int depth = 0; // Scopes alive on this thread
+        size_t demand = 0; // Bytes the outermost Scope has needed so far, from the arena or from malloc
+
+        // Counted per thread and published when the outermost Scope ends, to keep allocations free of atomics
+        ulong scratchAllocations = 0;
+        ulong heapAllocations = 0;
+
+        bool owns(const void* pointer) const
+        {
+          const unsigned char* bytes = static_cast<const unsigned char*>(pointer);
+          return this->block && bytes >= this->block.get() && bytes < this->block.get() + this->capacity;
+        }
+    };
+
+    thread_local Arena arena;
+
+    std::atomic<ulong> batches{0};
+    std::atomic<ulong> scratchAllocations{0};
+    std::atomic<ulong> heapAllocations{0};
+
+    void* heapAllocate(size_t size)
+    {
+      arena.heapAllocations++;
+
+      if (arena.depth > 0)
+        arena.demand += alignUp(size, alignment);
+
+      return std::malloc(size);
+    }
+  }
+
+  //===================================================================================================================//
+
+  ScratchArena::Scope::Scope() : mark(arena.used)
+  {
+    arena.depth++;
+  }
+
+  //===================================================================================================================//
+
+  ScratchArena::Scope::~Scope()
+  {
+    arena.used = this->mark;
+    arena.lastOffset = noAllocation;
+
+    if (--arena.depth > 0)
+      return;
+
+    // Size the arena for the largest demand seen, so the next sample is served from it entirely
+    if (arena.demand > arena.capacity && arena.capacity < maxCapacity) {
+      arena.capacity = std::min(maxCapacity, alignUp(arena.demand, growthStep));
+      arena.block.reset(new unsigned char[arena.capacity]);
+    }
+
+    arena.demand = 0;
+    scratchAllocations.fetch_add(arena.scratchAllocations, std::memory_order_relaxed);
+    heapAllocations.fetch_add(arena.heapAllocations, std::memory_order_relaxed);
+    arena.scratchAllocations = 0;
+    arena.heapAllocations = 0;
+  }
+
+  //===================================================================================================================//
+
+  void* ScratchArena::allocate(size_t size)
+  {
+    size_t aligned = alignUp(std::max<size_t>(size, 1), alignment);
+
+    if (arena.depth == 0 || arena.capacity - arena.used < aligned)
+      return heapAllocate(size);
+
+    arena.lastOffset = arena.used;
+    arena.used += aligned;
+    arena.demand = std::max(arena.demand, arena.used);
+    arena.scratchAllocations++;
+    return arena.block.get() + arena.lastOffset;
+  }
+
+  //===================================================================================================================//
+
+  void* ScratchArena::reallocate(void* pointer, size_t oldSize, size_t newSize)
+  {
+    if (!pointer)
+      return allocate(newSize);
+
+    if (!arena.owns(pointer)) {
+      arena.heapAllocations++;
+
+      if (arena.depth > 0)
+        arena.demand += alignUp(newSize, alignment);
+
+      return std::realloc(pointer, newSize);
+    }
+
+    size_t offset = static_cast<size_t>(static_cast<unsigned char*>(pointer) - arena.block.get());
+    size_t aligned = alignUp(std::max<size_t>(newSize, 1), alignment);
+
+    // The most recent allocation grows in place while there is room (stb grows its zlib buffers this way)
+    if (offset == arena.lastOffset && arena.capacity - offset >= aligned) {
+      arena.used = offset + aligned;
+      arena.demand = std::max(arena.demand, arena.used);
+      return pointer;
+    }
+
+    void* moved = allocate(newSize);
+
+    if (moved)
+      std::memcpy(moved, pointer, std::min(oldSize, newSize));
+
+    release(pointer);
+    return moved;
+  }
+
+  //===================================================================================================================//
+
+  void ScratchArena::release(void* pointer)
+  {
+    if (!pointer)
+      return;
+
+    if (!arena.owns(pointer)) {
+      std::free(pointer);
+      return;
+    }
+
+    // Only the most recent allocation can be handed back early; the rest go when their Scope ends
+    size_t offset = static_cast<size_t>(static_cast<unsigned char*>(pointer) - arena.block.get());
+
+    if (offset == arena.lastOffset) {
+      arena.used = offset;
+      arena.lastOffset = noAllocation;
+    }
+  }
+
+  //===================================================================================================================//
+
+  void ScratchArena::recordBatch()
+  {
+    batches.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  //===================================================================================================================//
+
+  ScratchArena::Stats ScratchArena::takeStats()
+  {
+    Stats stats;
+    stats.batches = batches.exchange(0, std::memory_order_relaxed);
+    stats.scratchAllocations = scratchAllocations.exchange(0, std::memory_order_relaxed);
+    stats.heapAllocations = heapAllocations.exchange(0, std::memory_order_relaxed);
+    return stats;
+  }
+
+  //===================================================================================================================//
+
+  size_t ScratchArena::capacity()
+  {
+    return arena.capacity;
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,74 @@
+#ifndef NN_CLI_SCRATCHARENA_HPP
+#define NN_CLI_SCRATCHARENA_HPP
+
+#include <cstddef>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  using ulong = unsigned long;
+
+  /**
+ * ScratchArena: per-thread bump allocator for the short-lived buffers of decoding one image (stb's decode and resize
+ * buffers, which ImageLoader routes here through STBI_MALLOC / STBIR_MALLOC, libpng's, and the decoded pixels).
+ *
+ * Allocations made while a Scope is alive on a thread come from that thread's arena and are all released when the
+ * Scope ends, so the I/O threads stop contending in malloc for them. An allocation that does not fit is served by
+ * malloc instead; when the outermost Scope ends the arena grows to what that Scope needed (up to maxCapacity), so
+ * after the first few samples every allocation fits. Outside a Scope the functions behave like malloc/realloc/free.
+ *
+ * Memory must be freed on the thread that allocated it, before that thread's Scope ends.
+ */
+  class ScratchArena
+  {
+    public:
+      struct Stats {
+          ulong batches = 0; // Batches loaded (counted by DataLoader)
+          ulong scratchAllocations = 0; // Served from an arena
+          ulong heapAllocations = 0; // Served by malloc: outside a Scope, or the arena was full
+
+          double perBatch(ulong allocations) const
+          {
+            return (this->batches > 0) ? static_cast<double>(allocations) / this->batches : 0.0;
+          }
+      };
+
+      // Largest arena kept by a thread; bigger demands are served by malloc
+      static constexpr size_t maxCapacity = 64ul * 1024 * 1024;
+
+      // Scratch allocations on the constructing thread come from its arena until the Scope ends. Scopes nest;
+      // each releases what was allocated inside it.
+      class Scope
+      {
+        public:
+          Scope();
+          ~Scope();
+
+          Scope(const Scope&) = delete;
+          Scope& operator=(const Scope&) = delete;
+
+        private:
+          size_t mark;
+      };
+
+      static void* allocate(size_t size);
+      static void* reallocate(void* pointer, size_t oldSize, size_t newSize);
+      static void release(void* pointer);
+
+      // Record one loaded batch, so takeStats can report allocations per batch
+      static void recordBatch();
+
+      // Process-wide counters since the previous call (they are reset)
+      static Stats takeStats();
+
+      // Bytes currently reserved by the calling thread's arena
+      static size_t capacity();
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_SCRATCHARENA_HPP
@@ -0,0 +1,385 @@
+#include "NN-CLI_Server.hpp"
+#include "NN-CLI_JsonWriter.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace NN_CLI
+{
+
+  //===================================================================================================================//
+
+  namespace
+  {
+    // Read up to `size` bytes, stopping early only at end of file. Returns the number of bytes read.
+    size_t readFully(int fd, char* data, size_t size)
+    {
+      size_t done = 0;
+
+      while (done < size) {
+        ssize_t n = ::read(fd, data + done, size - done);
+
+        if (n < 0 && errno == EINTR)
+          continue;
+
+        if (n < 0)
+          throw std::runtime_error(std::string("Failed to read request: ") + std::strerror(errno));
+
+        if (n == 0)
+          break;
+
+        done += static_cast<size_t>(n);
+      }
+
+      return done;
+    }
+
+    void writeFully(int fd, const char* data, size_t size)
+    {
+      while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+
+        if (n < 0 && errno == EINTR)
+          continue;
+
+        if (n <= 0)
+          throw std::runtime_error(std::string("Failed to write response: ") + std::strerror(errno));
+
+        data += n;
+        size -= static_cast<size_t>(n);
+      }
+    }
+
+    // A client that disconnects mid-response must end its session, not the process
+    void ignoreBrokenPipes()
+    {
+      std::signal(SIGPIPE, SIG_IGN);
+    }
+
+    // The connection threads of one serveSocket call. They use the Server, so they are shut down and joined before
+    // serveSocket returns or throws. A connection's fd stays open until its thread is joined, so shutting it down
+    // can never hit a reused fd.
+    class ConnectionThreads
+    {
+      public:
+        ~ConnectionThreads()
+        {
+          std::list<Connection> open;
+
+          {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            for (Connection& connection : this->connections)
+              ::shutdown(connection.fd, SHUT_RDWR);
+
+            open.swap(this->connections);
+          }
+
+          join(open);
+        }
+
+        void start(int fd, std::function<void(int fd)> serve)
+        {
+          std::lock_guard<std::mutex> lock(this->mutex);
+          this->connections.push_back({fd, std::thread(), false});
+          Connection* connection = &this->connections.back();
+
+          try {
+            connection->thread = std::thread([this, connection, serve = std::move(serve)]() {
+              serve(connection->fd);
+
+              std::lock_guard<std::mutex> lock(this->mutex);
+              connection->finished = true;
+            });
+          } catch (...) {
+            this->connections.pop_back();
+            ::close(fd);
+            throw;
+          }
+        }
+
+        // Join the threads of connections that have ended, so a long-running server does not collect them
+        void reapFinished()
+        {
+          std::list<Connection> finished;
+
+          {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            for (auto it = this->connections.begin(); it != this->connections.end();) {
+              auto next = std::next(it);
+
+              if (it->finished)
+                finished.splice(finished.end(), this->connections, it);
+
+              it = next;
+            }
+          }
+
+          join(finished);
+        }
+
+      private:
+        struct Connection {
+            int fd;
+            std::thread thread;
+            bool finished;
+        };
+
+        std::mutex mutex;
+        std::list<Connection> connections;
+
+        static void join(std::list<Connection>& connections)
+        {
+          for (Connection& connection : connections) {
+            connection.thread.join();
+            ::close(connection.fd);
+          }
+        }
+    };
+  }
+
+  //===================================================================================================================//
+
+  Server::Server(size_t inputSize, ParseFunction parse, PredictFunction predict)
+    : inputSize(inputSize), parse(std::move(parse)), predict(std::move(predict))
+  {
+  }
+
+  //===================================================================================================================//
+  //-- Transports --//
+  //===================================================================================================================//
+
+  void Server::serveStream(int inFd, int outFd)
+  {
+    ignoreBrokenPipes();
+    Frame request;
+
+    while (true) {
+      try {
+        if (!readFrame(inFd, request))
+          return;
+      } catch (const std::exception& e) {
+        // The stream can no longer be trusted to be in sync: report and give up on it
+        writeFrame(outFd, {'E', e.what()});
+        throw;
+      }
+
+      writeFrame(outFd, this->handle(request));
+    }
+  }
+
+  //===================================================================================================================//
+
+  void Server::serveSocket(const std::string& socketPath)
+  {
+    ignoreBrokenPipes();
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path))
+      throw std::runtime_error("Socket path is too long: " + socketPath);
+
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listenFd < 0)
+      throw std::runtime_error(std::string("Failed to create socket: ") + std::strerror(errno));
+
+    // A socket file left behind by a previous server would make bind() fail
+    ::unlink(socketPath.c_str());
+
+    if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+      std::string error = std::strerror(errno);
+      ::close(listenFd);
+      throw std::runtime_error("Failed to listen on socket " + socketPath + ": " + error);
+    }
+
+    ConnectionThreads connections;
+
+    while (true) {
+      int connectionFd = ::accept(listenFd, nullptr, nullptr);
+      connections.reapFinished();
+
+      if (connectionFd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED)
+          continue;
+
+        std::string error = std::strerror(errno);
+        ::close(listenFd);
+        throw std::runtime_error("Failed to accept connection on " + socketPath + ": " + error);
+      }
+
+      connections.start(connectionFd, [this](int fd) {
+        try {
+          this->serveStream(fd, fd);
+        } catch (const std::exception& e) {
+          std::cerr << "Connection closed: " << e.what() << "\n";
+        }
+      });
+    }
+  }
+
+  //===================================================================================================================//
+  //-- Requests --//
+  //===================================================================================================================//
+
+  Server::Frame Server::handle(const Frame& request)
+  {
+    try {
+      if (request.type == 'J')
+        return this->handleJson(request.payload);
+
+      if (request.type == 'F')
+        return this->handleFloats(request.payload);
+
+      throw std::runtime_error("Unknown request type '" + std::string(1, request.type) + "'");
+    } catch (const std::exception& e) {
+      return {'E', e.what()};
+    }
+  }
+
+  //===================================================================================================================//
+
+  Server::Frame Server::handleJson(const std::string& payload)
+  {
+    nlohmann::json request;
+
+    try {
+      request = nlohmann::json::parse(payload);
+    } catch (const nlohmann::json::parse_error& e) {
+      throw std::runtime_error(std::string("Invalid JSON request: ") + e.what());
+    }
+
+    bool single = request.is_object() && request.contains("input");
+    std::vector<std::vector<float>> inputs;
+
+    if (single) {
+      inputs.push_back(this->parse(request.at("input")));
+    } else if (request.is_object() && request.contains("inputs") && request.at("inputs").is_array()) {
+      for (const auto& entry : request.at("inputs"))
+        inputs.push_back(this->parse(entry));
+    } else {
+      throw std::runtime_error("Request must be an object with \"input\" or an \"inputs\" array");
+    }
+
+    for (const auto& input : inputs) {
+      if (input.size() != this->inputSize)
+        throw std::runtime_error("Input size (" + std::to_string(input.size()) + ") does not match the model (" +
+                                 std::to_string(this->inputSize) + ")");
+    }
+
+    PredictLatency latency;
+    std::vector<std::vector<float>> outputs = this->predict(std::move(inputs), latency);
+
+    Frame response;
+    JsonWriter writer(response.payload, 4096);
+
+    if (single) {
+      writer.raw("{\"output\":");
+      writer.array(outputs.front());
+    } else {
+      writer.raw("{\"outputs\":");
+      writer.array(outputs);
+    }
+
+    writer.raw(",\"queueMs\":");
+    writer.number(static_cast<float>(latency.queueSeconds * 1000.0));
+    writer.raw(",\"computeMs\":");
+    writer.number(static_cast<float>(latency.computeSeconds * 1000.0));
+    writer.raw("}");
+    writer.flush();
+    return response;
+  }
+
+  //===================================================================================================================//
+
+  Server::Frame Server::handleFloats(const std::string& payload)
+  {
+    size_t numValues = payload.size() / sizeof(float);
+
+    if (payload.size() % sizeof(float) != 0 || numValues == 0 || this->inputSize == 0 ||
+        numValues % this->inputSize != 0)
+      throw std::runtime_error("float32 request of " + std::to_string(payload.size()) +
+                               " bytes is not a whole number of inputs of " + std::to_string(this->inputSize) +
+                               " values");
+
+    std::vector<std::vector<float>> inputs(numValues / this->inputSize, std::vector<float>(this->inputSize));
+
+    for (size_t i = 0; i < inputs.size(); i++)
+      std::memcpy(inputs[i].data(), payload.data() + i * this->inputSize * sizeof(float),
+                  this->inputSize * sizeof(float));
+
+    PredictLatency latency;
+    std::vector<std::vector<float>> outputs = this->predict(std::move(inputs), latency);
+
+    Frame response;
+    response.type = 'F';
+
+    for (const auto& output : outputs)
+      response.payload.append(reinterpret_cast<const char*>(output.data()), output.size() * sizeof(float));
+
+    return response;
+  }
+
+  //===================================================================================================================//
+  //-- Framing --//
+  //===================================================================================================================//
+
+  bool Server::readFrame(int fd, Frame& frame)
+  {
+    unsigned char header[5];
+    size_t headerRead = readFully(fd, reinterpret_cast<char*>(header), sizeof(header));
+
+    if (headerRead == 0)
+      return false;
+
+    if (headerRead < sizeof(header))
+      throw std::runtime_error("Truncated frame header");
+
+    uint32_t size = static_cast<uint32_t>(header[0]) | (static_cast<uint32_t>(header[1]) << 8) |
+                    (static_cast<uint32_t>(header[2]) << 16) | (static_cast<uint32_t>(header[3]) << 24);
+
+    if (size > maxPayloadSize)
+      throw std::runtime_error("Frame of " + std::to_string(size) + " bytes exceeds the " +
+                               std::to_string(maxPayloadSize) + "-byte limit");
+
+    frame.type = static_cast<char>(header[4]);
+    frame.payload.resize(size);
+
+    if (readFully(fd, &frame.payload[0], size) < size)
+      throw std::runtime_error("Truncated frame payload");
+
+    return true;
+  }
+
+  //===================================================================================================================//
+
+  void Server::writeFrame(int fd, const Frame& frame)
+  {
+    uint32_t size = static_cast<uint32_t>(frame.payload.size());
+    char header[5] = {static_cast<char>(size & 0xFF), static_cast<char>((size >> 8) & 0xFF),
+                      static_cast<char>((size >> 16) & 0xFF), static_cast<char>((size >> 24) & 0xFF), frame.type};
+
+    // Header and payload in a single write, so a small response leaves as one packet
+    std::string bytes(header, sizeof(header));
+    bytes += frame.payload;
+    writeFully(fd, bytes.data(), bytes.size());
+  }
+
+  //===================================================================================================================//
+
+} // namespace NN_CLI
@@ -0,0 +1,85 @@
+#ifndef NN_CLI_SERVER_HPP
+#define NN_CLI_SERVER_HPP
+
+#include "NN-CLI_PredictScheduler.hpp"
+
+#include <json.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+//===================================================================================================================//
+
+namespace NN_CLI
+{
+
+  /**
+ * Server: answers predict requests for a model that stays loaded (--mode serve).
+ *
+ * Requests and responses are frames, read from and written to a file descriptor pair (stdin/stdout) or the
+ * connections of a Unix domain socket:
+ *
+ *   [uint32 payload length, little-endian][uint8 type][payload]
+ *
+ *   'J'  JSON:     {"inputs": [entry, ...]} -> {"outputs": [[...], ...]}, or {"input": entry} -> {"output": [...]}.
+ *                  An entry is what an "inputs" array of a predict file holds: a vector, or an image path.
+ *                  The response also carries the request's "queueMs" and "computeMs" (see PredictLatency).
+ *   'F'  float32:  one or more inputs back to back -> their outputs back to back (native byte order).
+ *   'E'  error:    UTF-8 message, sent instead of a response when a request fails.
+ *
+ * A failed request does not end the session; a malformed frame does. Each connection is served in order on its own
+ * thread, so predict may be called concurrently. serveSocket joins those threads before it returns.
+ */
+  class Server
+  {
+    public:
+      struct Frame {
+          char type = 'J';
+          std::string payload;
+      };
+
+      // Turns one request entry (see above) into a flat input vector.
+      using ParseFunction = std::function<std::vector<float>(const nlohmann::json& entry)>;
+
+      // Predicts a request's inputs, returning one output per input, in order, and reporting where the time went.
+      // May run on several threads at once.
+      using PredictFunction = std::function<std::vector<std::vector<float>>(std::vector<std::vector<float>> inputs,
+                                                                            PredictLatency& latency)>;
+
+      // inputSize: values per input, used to split float32 requests.
+      Server(size_t inputSize, ParseFunction parse, PredictFunction predict);
+
+      // Serve frames from inFd until it reaches end of file, writing responses to outFd.
+      void serveStream(int inFd, int outFd);
+
+      // Listen on a Unix domain socket at socketPath (replacing a stale one) and serve every connection until accept()
+      // fails. Open connections are then shut down and their threads joined before the error is thrown.
+      void serveSocket(const std::string& socketPath);
+
+      // Answer one request frame; failures become an 'E' frame.
+      Frame handle(const Frame& request);
+
+      //-- Framing (also usable by clients) --//
+
+      // Returns false on end of file before a frame starts. Throws on a truncated or oversized frame.
+      static bool readFrame(int fd, Frame& frame);
+      static void writeFrame(int fd, const Frame& frame);
+
+      static constexpr uint32_t maxPayloadSize = 1u << 30;
+
+    private:
+      size_t inputSize;
+      ParseFunction parse;
+      PredictFunction predict;
+
+      Frame handleJson(const std::string& payload);
+      Frame handleFloats(const std::string& payload);
+  };
+
+} // namespace NN_CLI
+
+//===================================================================================================================//
+
+#endif // NN_CLI_SERVER_HPP
@@ -5,7 +5,6 @@
 #include <CNN_Types.hpp>
 #include <CNN_Sample.hpp>
 
-#include <fstream>
 #include <string>
 #include <vector>
 
@@ -25,11 +24,6 @@ namespace NN_CLI
       /// Load IDX dataset as CNN samples (3D tensor inputs with given shape)
       static CNN::Samples<T> loadCNNIDX(const std::string& dataPath, const std::string& labelsPath,
                                         const CNN::Shape3D& inputShape, ulong progressReports = 1000);
-
-    private:
-      static uint32_t readBigEndianUInt32(std::ifstream& stream);
-      static std::vector<std::vector<unsigned char>> loadIDXData(const std::string& path);
-      static std::vector<unsigned char> loadIDXLabels(const std::string& path);
   };
 
 } // namespace NN_CLI
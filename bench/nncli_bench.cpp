@@ -0,0 +1,461 @@
+#include "../NN-CLI_ConfigDocument.hpp"
+#include "../NN-CLI_DataLoader.hpp"
+#include "../NN-CLI_ImageDecoder.hpp"
+#include "../NN-CLI_ImageLoader.hpp"
+#include "../NN-CLI_Loader.hpp"
+#include "../NN-CLI_LogLevel.hpp"
+#include "../NN-CLI_ModelFile.hpp"
+#include "../NN-CLI_PixelKernels.hpp"
+#include "../NN-CLI_ScratchArena.hpp"
+#include "../NN-CLI_Utils.hpp"
+
+#include <ANN_Core.hpp>
+#include <ANN_Utils.hpp>
+#include <CNN_Core.hpp>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace NN_CLI;
+
+//===================================================================================================================//
+
+/**
+ * nncli_bench: microbenchmarks for the NN-CLI hot paths, reported as JSON so runs can be compared across upgrades.
+ *
+ * Every fixture (images, manifests, IDX files, models) is generated from fixed seeds in a scratch directory, so the
+ * same build on the same machine measures the same work every run. Each benchmark runs once untimed to warm caches,
+ * then `iterations` timed runs; the median is the figure to track, min/max show the noise.
+ */
+
+namespace
+{
+  struct Bench {
+      std::string name;
+      ulong iterations;
+      nlohmann::ordered_json params;
+      std::function<void()> run;
+  };
+
+  struct Fixtures {
+      std::string dir;
+      std::string smallImagePath; // 64x64 RGB
+      std::string largeImagePath; // 256x256 RGB
+      std::string photoPath; // 1600x1200 RGB JPEG
+      std::string vectorManifestPath; // 20000 samples of 64 values
+      std::string imageManifestPath; // 512 samples of 32x32 RGB images
+      std::string idxDataPath; // 10000 28x28 images
+      std::string idxLabelsPath;
+      std::string annModelPath; // 784-2048-2048-10
+      std::string cnnModelPath; // 32x32x3 input, 3 conv layers, 1024-wide dense head
+  };
+
+  //===================================================================================================================//
+
+  std::vector<float> randomImage(int c, int h, int w, std::mt19937& rng)
+  {
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> data(static_cast<size_t>(c) * h * w);
+
+    for (float& value : data)
+      value = dist(rng);
+
+    return data;
+  }
+
+  void writeFile(const std::string& path, const std::string& contents)
+  {
+    QFile file(QString::fromStdString(path));
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      throw std::runtime_error("Failed to write benchmark fixture: " + path);
+
+    file.write(contents.data(), static_cast<qint64>(contents.size()));
+  }
+
+  void appendBigEndian(std::string& bytes, uint32_t value)
+  {
+    bytes.push_back(static_cast<char>(value >> 24));
+    bytes.push_back(static_cast<char>(value >> 16));
+    bytes.push_back(static_cast<char>(value >> 8));
+    bytes.push_back(static_cast<char>(value));
+  }
+
+  //===================================================================================================================//
+
+  Fixtures makeFixtures(const std::string& dir)
+  {
+    Fixtures fixtures;
+    fixtures.dir = dir;
+    std::mt19937 rng(42);
+
+    //-- Images --//
+    fixtures.smallImagePath = dir + "/small.png";
+    fixtures.largeImagePath = dir + "/large.png";
+    ImageLoader::saveImage(fixtures.smallImagePath, randomImage(3, 64, 64, rng), 3, 64, 64);
+    ImageLoader::saveImage(fixtures.largeImagePath, randomImage(3, 256, 256, rng), 3, 256, 256);
+    fixtures.photoPath = dir + "/photo.jpg";
+    ImageLoader::saveImage(fixtures.photoPath, randomImage(3, 1200, 1600, rng), 3, 1200, 1600);
+
+    //-- Manifests --//
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    nlohmann::json vectorSamples = nlohmann::json::array();
+
+    for (int i = 0; i < 20000; i++) {
+      std::vector<float> input(64);
+
+      for (float& value : input)
+        value = dist(rng);
+
+      vectorSamples.push_back({{"input", input}, {"output", {i % 2, 1 - i % 2}}});
+    }
+
+    fixtures.vectorManifestPath = dir + "/vector_samples.json";
+    writeFile(fixtures.vectorManifestPath, nlohmann::json({{"samples", vectorSamples}}).dump());
+
+    nlohmann::json imageSamples = nlohmann::json::array();
+
+    for (int i = 0; i < 512; i++) {
+      std::string imageName = "image_" + std::to_string(i) + ".png";
+      ImageLoader::saveImage(dir + "/" + imageName, randomImage(3, 32, 32, rng), 3, 32, 32);
+      imageSamples.push_back({{"input", imageName}, {"output", {i % 2, 1 - i % 2}}});
+    }
+
+    fixtures.imageManifestPath = dir + "/image_samples.json";
+    writeFile(fixtures.imageManifestPath, nlohmann::json({{"samples", imageSamples}}).dump());
+
+    //-- IDX pair --//
+    const uint32_t numImages = 10000;
+    std::string data;
+    appendBigEndian(data, 0x00000803);
+    appendBigEndian(data, numImages);
+    appendBigEndian(data, 28);
+    appendBigEndian(data, 28);
+
+    for (uint32_t i = 0; i < numImages * 28 * 28; i++)
+      data.push_back(static_cast<char>(rng() & 0xFF));
+
+    std::string labels;
+    appendBigEndian(labels, 0x00000801);
+    appendBigEndian(labels, numImages);
+
+    for (uint32_t i = 0; i < numImages; i++)
+      labels.push_back(static_cast<char>(i % 10));
+
+    fixtures.idxDataPath = dir + "/data.idx3";
+    fixtures.idxLabelsPath = dir + "/labels.idx1";
+    writeFile(fixtures.idxDataPath, data);
+    writeFile(fixtures.idxLabelsPath, labels);
+
+    //-- Model configs (saved as trained models by the save benchmarks) --//
+    nlohmann::json trainingConfig = {{"numEpochs", 1}, {"learningRate", 0.01}};
+
+    nlohmann::json annConfig = {
+      {"mode", "train"},
+      {"device", "cpu"},
+      {"progressReports", 0},
+      {"layersConfig",
+       {{{"numNeurons", 784}, {"actvFunc", "relu"}},
+        {{"numNeurons", 2048}, {"actvFunc", "relu"}},
+        {{"numNeurons", 2048}, {"actvFunc", "relu"}},
+        {{"numNeurons", 10}, {"actvFunc", "sigmoid"}}}},
+      {"trainingConfig", trainingConfig}};
+
+    nlohmann::json cnnConfig = {
+      {"mode", "train"},
+      {"device", "cpu"},
+      {"progressReports", 0},
+      {"inputShape", {{"c", 3}, {"h", 32}, {"w", 32}}},
+      {"convolutionalLayersConfig",
+       {{{"type", "conv"}, {"numFilters", 64}, {"filterH", 3}, {"filterW", 3}, {"strideY", 1}, {"strideX", 1},
+         {"slidingStrategy", "same"}},
+        {{"type", "relu"}},
+        {{"type", "pool"}, {"poolType", "max"}, {"poolH", 2}, {"poolW", 2}, {"strideY", 2}, {"strideX", 2}},
+        {{"type", "conv"}, {"numFilters", 128}, {"filterH", 3}, {"filterW", 3}, {"strideY", 1}, {"strideX", 1},
+         {"slidingStrategy", "same"}},
+        {{"type", "relu"}},
+        {{"type", "pool"}, {"poolType", "max"}, {"poolH", 2}, {"poolW", 2}, {"strideY", 2}, {"strideX", 2}},
+        {{"type", "conv"}, {"numFilters", 128}, {"filterH", 3}, {"filterW", 3}, {"strideY", 1}, {"strideX", 1},
+         {"slidingStrategy", "same"}},
+        {{"type", "relu"}},
+        {{"type", "flatten"}}}},
+      {"denseLayersConfig",
+       {{{"numNeurons", 1024}, {"actvFunc", "relu"}}, {{"numNeurons", 10}, {"actvFunc", "sigmoid"}}}},
+      {"trainingConfig", trainingConfig}};
+
+    fixtures.annModelPath = dir + "/ann_config.json";
+    fixtures.cnnModelPath = dir + "/cnn_config.json";
+    writeFile(fixtures.annModelPath, annConfig.dump(2));
+    writeFile(fixtures.cnnModelPath, cnnConfig.dump(2));
+
+    return fixtures;
+  }
+
+  //===================================================================================================================//
+
+  nlohmann::ordered_json measure(const Bench& bench)
+  {
+    bench.run(); // Warm-up: page cache, allocator, thread pools
+
+    std::vector<double> millis;
+    millis.reserve(bench.iterations);
+
+    for (ulong i = 0; i < bench.iterations; i++) {
+      auto start = std::chrono::steady_clock::now();
+      bench.run();
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      millis.push_back(elapsed.count());
+    }
+
+    std::sort(millis.begin(), millis.end());
+    double total = 0;
+
+    for (double ms : millis)
+      total += ms;
+
+    nlohmann::ordered_json result;
+    result["name"] = bench.name;
+    result["params"] = bench.params;
+    result["iterations"] = bench.iterations;
+    result["medianMs"] = millis[millis.size() / 2];
+    result["meanMs"] = total / static_cast<double>(millis.size());
+    result["minMs"] = millis.front();
+    result["maxMs"] = millis.back();
+    return result;
+  }
+}
+
+//===================================================================================================================//
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("nncli_bench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("NN-CLI microbenchmarks (JSON results)");
+  parser.addHelpOption();
+
+  QCommandLineOption outputOption(QStringList() << "o" << "output", "Write the JSON results to this file.", "file");
+  parser.addOption(outputOption);
+
+  QCommandLineOption filterOption(QStringList() << "f" << "filter",
+                                  "Only run benchmarks whose name contains this text.", "text");
+  parser.addOption(filterOption);
+
+  QCommandLineOption scaleOption(QStringList() << "s" << "scale",
+                                 "Multiply every benchmark's iteration count (default: 1).", "factor", "1");
+  parser.addOption(scaleOption);
+
+  parser.process(app);
+
+  ulong scale = std::max(1ul, parser.value(scaleOption).toULong());
+  std::string filter = parser.value(filterOption).toStdString();
+
+  std::string dir = QDir::temp().filePath("nncli_bench_" + QString::number(::getpid())).toStdString();
+  QDir().mkpath(QString::fromStdString(dir));
+
+  int exitCode = 0;
+
+  try {
+    std::cerr << "Generating fixtures in " << dir << "\n";
+    Fixtures fixtures = makeFixtures(dir);
+
+    std::mt19937 rng(7);
+    const int augC = 3, augH = 224, augW = 224;
+    const std::vector<float> augSource = randomImage(augC, augH, augW, rng);
+    std::vector<float> augData;
+    AugmentationRNG augRng(7, 0, 0);
+    nlohmann::ordered_json augParams = {{"c", augC}, {"h", augH}, {"w", augW}};
+
+    // Each transform runs on a fresh copy of the same image; the copy is part of every augmentation figure
+    auto augment = [&](std::function<void(std::vector<float>&)> transform) {
+      return [&, transform]() {
+        augData = augSource;
+        transform(augData);
+      };
+    };
+
+    Loader::AugmentationTransforms allTransforms;
+    IOConfig vectorIO;
+    IOConfig imageIO;
+    imageIO.inputType = DataType::IMAGE;
+
+    // Batches come from a SampleProvider, as in training; each call returns one loaded batch
+    DataLoader<CNN::Sample<float>> batchLoader;
+    batchLoader.loadManifest(fixtures.imageManifestPath, imageIO, 3, 32, 32);
+    auto provider = batchLoader.makeSampleProvider(allTransforms, 0.5f);
+    std::vector<ulong> batchIndices(batchLoader.numSamples());
+    std::iota(batchIndices.begin(), batchIndices.end(), 0);
+    const ulong batchSize = 64;
+    ulong batchIndex = 0;
+
+    // Models to save: built once, in train mode so the library initialises their parameters
+    ConfigDocument annConfigDocument = ConfigDocument::load(fixtures.annModelPath);
+    ConfigDocument cnnConfigDocument = ConfigDocument::load(fixtures.cnnModelPath);
+    ANN::CoreConfig<float> annCoreConfig = Loader::loadANNConfig(annConfigDocument);
+    CNN::CoreConfig<float> cnnCoreConfig = Loader::loadCNNConfig(cnnConfigDocument);
+    annCoreConfig.logLevel = static_cast<ANN::LogLevel>(LogLevel::QUIET);
+    cnnCoreConfig.logLevel = static_cast<CNN::LogLevel>(LogLevel::QUIET);
+    auto annCore = ANN::Core<float>::makeCore(annCoreConfig);
+    auto cnnCore = CNN::Core<float>::makeCore(cnnCoreConfig);
+    IOConfig modelIO;
+    ModelFile::Settings modelSettings{0, 0};
+
+    std::string annJsonPath = dir + "/ann_model.json";
+    std::string annBinaryPath = dir + "/ann_model.nnb";
+    std::string cnnJsonPath = dir + "/cnn_model.json";
+    std::string cnnBinaryPath = dir + "/cnn_model.nnb";
+    ModelFile::saveCNNModel(*cnnCore, cnnJsonPath, modelIO, modelSettings);
+    ModelFile::saveCNNModel(*cnnCore, cnnBinaryPath, modelIO, modelSettings);
+
+    std::vector<Bench> benches = {
+      {"ImageLoader::loadImage/resize", 50, {{"source", "256x256x3 png"}, {"target", "64x64x3"}},
+       [&]() { ImageLoader::loadImage(fixtures.largeImagePath, 3, 64, 64); }},
+      {"ImageLoader::loadImage/noResize", 50, {{"source", "256x256x3 png"}, {"target", "256x256x3"}},
+       [&]() { ImageLoader::loadImage(fixtures.largeImagePath, 3, 256, 256); }},
+      {"ImageLoader::loadImage/small", 200, {{"source", "64x64x3 png"}, {"target", "64x64x3"}},
+       [&]() { ImageLoader::loadImage(fixtures.smallImagePath, 3, 64, 64); }},
+
+      {"ImageLoader::horizontalFlip", 200, augParams,
+       augment([&](std::vector<float>& d) { ImageLoader::horizontalFlip(d, augC, augH, augW); })},
+      {"ImageLoader::randomRotation", 100, augParams,
+       augment([&](std::vector<float>& d) { ImageLoader::randomRotation(d, augC, augH, augW, 15.0f, augRng); })},
+      {"ImageLoader::randomBrightness", 200, augParams,
+       augment([&](std::vector<float>& d) { ImageLoader::randomBrightness(d, augC, augH, augW, 0.1f, augRng); })},
+      {"ImageLoader::randomContrast", 200, augParams,
+       augment([&](std::vector<float>& d) { ImageLoader::randomContrast(d, augC, augH, augW, 0.8f, 1.2f, augRng); })},
+      {"ImageLoader::randomTranslation", 100, augParams,
+       augment([&](std::vector<float>& d) { ImageLoader::randomTranslation(d, augC, augH, augW, 0.1f, augRng); })},
+      {"ImageLoader::addGaussianNoise", 100, augParams,
+       augment([&](std::vector<float>& d) { ImageLoader::addGaussianNoise(d, 0.02f, augRng); })},
+      {"ImageLoader::applyRandomTransforms", 100, augParams,
+       augment([&](std::vector<float>& d) {
+         ImageLoader::applyRandomTransforms(d, augC, augH, augW, augRng, allTransforms, 1.0f);
+       })},
+
+      {"DataLoader::loadManifest/vectors", 5, {{"samples", 20000}, {"inputSize", 64}},
+       [&]() {
+         DataLoader<ANN::Sample<float>> loader;
+         loader.loadManifest(fixtures.vectorManifestPath, vectorIO, 0, 0, 0);
+       }},
+      {"DataLoader::loadBatch", 40, {{"batchSize", batchSize}, {"image", "32x32x3 png"}, {"augmentation", 0.5}},
+       [&]() {
+         provider(batchIndices, batchSize, batchIndex);
+         batchIndex = (batchIndex + 1) % (batchIndices.size() / batchSize);
+       }},
+
+      {"Utils::loadANNIDX", 10, {{"samples", 10000}, {"image", "28x28"}},
+       [&]() { Utils<float>::loadANNIDX(fixtures.idxDataPath, fixtures.idxLabelsPath, 0); }},
+
+      {"ModelFile::saveANNModel/json", 5, {{"layers", "784-2048-2048-10"}},
+       [&]() { ModelFile::saveANNModel(*annCore, annJsonPath, modelIO, modelSettings); }},
+      {"ModelFile::saveANNModel/binary", 5, {{"layers", "784-2048-2048-10"}},
+       [&]() { ModelFile::saveANNModel(*annCore, annBinaryPath, modelIO, modelSettings); }},
+      {"ModelFile::saveCNNModel/json", 5, {{"model", "3 conv + 1024 dense"}},
+       [&]() { ModelFile::saveCNNModel(*cnnCore, cnnJsonPath, modelIO, modelSettings); }},
+      {"ModelFile::saveCNNModel/binary", 5, {{"model", "3 conv + 1024 dense"}},
+       [&]() { ModelFile::saveCNNModel(*cnnCore, cnnBinaryPath, modelIO, modelSettings); }},
+
+      {"Loader::loadCNNConfig/json", 5, {{"model", "3 conv + 1024 dense"}},
+       [&]() { Loader::loadCNNConfig(ConfigDocument::load(cnnJsonPath)); }},
+      {"Loader::loadCNNConfig/binary", 10, {{"model", "3 conv + 1024 dense"}},
+       [&]() { Loader::loadCNNConfig(ConfigDocument::load(cnnBinaryPath)); }},
+    };
+
+    // Layout conversion on every instruction set this CPU supports, scalar first, so each kernel's speedup shows
+    const size_t kernelPlaneSize = static_cast<size_t>(augH) * augW;
+    const std::vector<float> kernelSource = randomImage(4, augH, augW, rng);
+    std::vector<unsigned char> kernelPixels(kernelSource.size());
+    std::vector<float> kernelData(kernelSource.size());
+    PixelKernels::nchwToHWC(kernelSource.data(), kernelPixels.data(), 4, kernelPlaneSize);
+
+    for (int isa = 0; isa <= static_cast<int>(PixelKernels::detectISA()); isa++) {
+      for (int c : {1, 3, 4}) {
+        std::string suffix = "/" + PixelKernels::isaName(PixelKernels::ISA(isa)) + "/c" + std::to_string(c);
+        nlohmann::ordered_json params = {{"c", c}, {"h", augH}, {"w", augW}};
+
+        benches.push_back({"PixelKernels::hwcToNCHW" + suffix, 500, params, [&, isa, c]() {
+                             PixelKernels::hwcToNCHW(kernelPixels.data(), kernelData.data(), c, kernelPlaneSize,
+                                                     PixelKernels::ISA(isa));
+                           }});
+        benches.push_back({"PixelKernels::nchwToHWC" + suffix, 500, params, [&, isa, c]() {
+                             PixelKernels::nchwToHWC(kernelSource.data(), kernelPixels.data(), c, kernelPlaneSize,
+                                                     PixelKernels::ISA(isa));
+                           }});
+      }
+    }
+
+    // Decoding with each compiled-in backend; libjpeg decodes the photo at 1/8 scale for a 128x128 target
+    using Backend = ImageDecoder::Backend;
+    const std::vector<std::pair<Backend, std::string>> decodes = {
+      {Backend::STB, "jpeg"}, {Backend::LIBJPEG, "jpeg"}, {Backend::STB, "png"}, {Backend::LIBPNG, "png"}};
+
+    for (const auto& decode : decodes) {
+      Backend backend = decode.first;
+      const std::string& format = decode.second;
+
+      if (!ImageDecoder::available(backend))
+        continue;
+
+      bool isJpeg = (format == "jpeg");
+      nlohmann::ordered_json params = {{"source", isJpeg ? "1600x1200x3 jpg" : "256x256x3 png"},
+                                       {"target", isJpeg ? "128x128x3" : "256x256x3"}};
+
+      std::string name = "ImageDecoder::decode/" + ImageDecoder::backendName(backend) + "/" + format;
+
+      benches.push_back({name, isJpeg ? 10ul : 50ul, params, [&, backend, isJpeg]() {
+                           int size = isJpeg ? 128 : 256;
+                           const std::string& path = isJpeg ? fixtures.photoPath : fixtures.largeImagePath;
+                           ScratchArena::release(ImageDecoder::decode(path, 3, size, size, backend).pixels);
+                         }});
+    }
+
+    nlohmann::ordered_json report;
+    report["benchmark"] = "nncli_bench";
+    report["startTime"] = ANN::Utils<float>::formatISO8601();
+    report["scale"] = scale;
+    report["results"] = nlohmann::ordered_json::array();
+
+    for (Bench& bench : benches) {
+      if (!filter.empty() && bench.name.find(filter) == std::string::npos)
+        continue;
+
+      bench.iterations *= scale;
+      std::cerr << "Running " << bench.name << " (" << bench.iterations << " iterations)\n";
+      report["results"].push_back(measure(bench));
+    }
+
+    std::string json = report.dump(2) + "\n";
+
+    if (parser.isSet(outputOption)) {
+      writeFile(parser.value(outputOption).toStdString(), json);
+      std::cerr << "Results saved to: " << parser.value(outputOption).toStdString() << "\n";
+    } else {
+      std::cout << json;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    exitCode = 1;
+  }
+
+  QDir(QString::fromStdString(dir)).removeRecursively();
+  return exitCode;
+}
@@ -14,19 +14,24 @@ void printUsage()
   std::cout << "Usage:\n";
   std::cout << "  NN-CLI --config <file> --mode train [options]       # Training\n";
   std::cout << "  NN-CLI --config <file> --mode predict --input <f>   # Predict (batch)\n";
-  std::cout << "  NN-CLI --config <file> --mode test [options]        # Evaluation\n\n";
+  std::cout << "  NN-CLI --config <file> --mode test [options]        # Evaluation\n";
+  std::cout << "  NN-CLI --config <file> --mode convert --output <f>  # Pack samples into a binary dataset\n";
+  std::cout << "  NN-CLI --config <file> --mode serve [--socket <p>]  # Keep the model loaded, answer requests\n\n";
   std::cout << "Options:\n";
   std::cout << "  --config, -c <file>    Path to JSON configuration file (required)\n";
-  std::cout << "  --mode, -m <mode>      Mode: 'train', 'predict', or 'test' (overrides config file)\n";
+  std::cout << "  --mode, -m <mode>      Mode: 'train', 'predict', 'test', 'convert', or 'serve' (overrides config)\n";
   std::cout << "  --device, -d <device>  Device: 'cpu' or 'gpu' (overrides config file)\n";
-  std::cout << "  --input, -i <file>     Path to JSON file with batch inputs (predict mode, required)\n";
+  std::cout << "  --input, -i <file>     Path to JSON or .jsonl file with batch inputs (predict mode, required)\n";
   std::cout << "  --input-type <type>    Input data type: 'vector' or 'image' (overrides config file)\n";
-  std::cout << "  --samples, -s <file>   Path to JSON file with samples (train/test modes)\n";
+  std::cout << "  --samples, -s <file>   Path to JSON samples or packed dataset file (train/test/convert modes)\n";
   std::cout << "  --idx-data <file>      Path to IDX3 data file (alternative to --samples)\n";
   std::cout << "  --idx-labels <file>    Path to IDX1 labels file (requires --idx-data)\n";
-  std::cout << "  --output, -o <file>    Output file/dir (default: predict_<input>.json or folder for images)\n";
+  std::cout << "  --output, -o <file>    Output file/dir (default: predict_<input>.json[l] or folder for images)\n";
   std::cout << "  --output-type <type>   Output data type: 'vector' or 'image' (overrides config file)\n";
   std::cout << "  --shuffle-samples <b>  Shuffle samples each epoch: true/false (overrides config file)\n";
+  std::cout << "  --cache-dir <dir>      Directory for decoded training images, reused across runs\n";
+  std::cout << "  --stream               Predict mode: stream inputs, writing results as they complete\n";
+  std::cout << "  --socket <path>        Serve mode: listen on a Unix domain socket instead of stdin/stdout\n";
   std::cout << "  --log-level, -l <lvl>  Log level: quiet, error, warning, info, debug (default: error)\n";
   std::cout << "  --help, -h             Show this help message\n";
 }
@@ -45,8 +50,9 @@ int main(int argc, char* argv[])
   QCommandLineOption configOption(QStringList() << "c" << "config", "Path to JSON configuration file.", "file");
   parser.addOption(configOption);
 
-  // Mode option (train, predict, or test)
-  QCommandLineOption modeOption(QStringList() << "m" << "mode", "Mode: 'train', 'predict', or 'test'.", "mode");
+  // Mode option (train, predict, test, convert, or serve)
+  QCommandLineOption modeOption(QStringList() << "m" << "mode",
+                                "Mode: 'train', 'predict', 'test', 'convert', or 'serve'.", "mode");
   parser.addOption(modeOption);
 
   // Device option (cpu or gpu)
@@ -79,10 +85,12 @@ int main(int argc, char* argv[])
                                      "file");
   parser.addOption(idxLabelsOption);
 
-  // Output file (train: model, predict: predict result with metadata)
-  QCommandLineOption outputOption(
-    QStringList() << "o" << "output",
-    "Output file. Train mode: saves trained model. Predict mode: saves predict result with model metadata.", "file");
+  // Output file (train: model, predict: predict result with metadata, convert: packed dataset)
+  QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                  "Output file. Train mode: saves trained model (.nnb for the binary model format). "
+                                  "Predict mode: saves predict result with model metadata. Convert mode: saves packed "
+                                  "dataset.",
+                                  "file");
   parser.addOption(outputOption);
 
   // Output type option (vector or image)
@@ -102,6 +110,24 @@ int main(int argc, char* argv[])
                                           "bool");
   parser.addOption(shuffleSamplesOption);
 
+  // Persistent decoded-image cache directory (overrides config file)
+  QCommandLineOption cacheDirOption(QStringList() << "cache-dir",
+                                    "Directory for decoded training images, reused across runs "
+                                    "(overrides config file).",
+                                    "dir");
+  parser.addOption(cacheDirOption);
+
+  // Streaming predict: read, predict and write concurrently in constant memory
+  QCommandLineOption streamOption(QStringList() << "stream",
+                                  "Predict mode: stream inputs through a read/predict/write pipeline, writing results "
+                                  "as they complete.");
+  parser.addOption(streamOption);
+
+  // Serve mode transport: a Unix domain socket instead of stdin/stdout
+  QCommandLineOption socketOption(QStringList() << "socket",
+                                  "Serve mode: listen for connections on this Unix domain socket path.", "path");
+  parser.addOption(socketOption);
+
   parser.process(app);
 
   // Validate that --config is provided
@@ -115,8 +141,9 @@ int main(int argc, char* argv[])
   if (parser.isSet(modeOption)) {
     QString modeStr = parser.value(modeOption).toLower();
 
-    if (modeStr != "train" && modeStr != "predict" && modeStr != "test") {
-      std::cerr << "Error: Mode must be 'train', 'predict', or 'test'.\n";
+    if (modeStr != "train" && modeStr != "predict" && modeStr != "test" && modeStr != "convert" &&
+        modeStr != "serve") {
+      std::cerr << "Error: Mode must be 'train', 'predict', 'test', 'convert', or 'serve'.\n";
       return 1;
     }
   }
@@ -183,6 +210,10 @@ int main(int argc, char* argv[])
     }
   }
 
+  // Serving over stdin/stdout: stdout carries response frames only, so messages go to stderr
+  if (parser.isSet(modeOption) && parser.value(modeOption).toLower() == "serve" && !parser.isSet(socketOption))
+    std::cout.rdbuf(std::cerr.rdbuf());
+
   try {
     NN_CLI::Runner runner(parser, logLevel);
     return runner.run();
@@ -34,6 +34,7 @@ static void testANNNetworkDetection()
 
   CHECK(result.exitCode == 0, "ANN detection: exit code 0");
   CHECK(result.stdOut.contains("Network type: ANN"), "ANN detection: stdout contains 'Network type: ANN'");
+  CHECK(result.stdOut.contains("Startup time:"), "ANN detection: startup time reported at info level");
   std::cout << std::endl;
 }
 
@@ -59,6 +60,45 @@ static void testANNTrainXOR()
   std::cout << std::endl;
 }
 
+static void testANNBinaryModelRoundTrip()
+{
+  std::cout << "  testANNBinaryModelRoundTrip... ";
+
+  QString modelPath = tempDir() + "/ann_xor_model.nnb";
+  QFile::remove(modelPath);
+
+  auto trainResult = runNNCLI({"--config", fixturePath("ann_train_config.json"), "--mode", "train", "--device", "cpu",
+                               "--samples", fixturePath("ann_train_samples.json"), "--output", modelPath});
+
+  CHECK(trainResult.exitCode == 0, "ANN binary model: train exit code 0");
+  CHECK(QFile::exists(modelPath), "ANN binary model: .nnb file exists");
+
+  QFile modelFile(modelPath);
+
+  if (modelFile.open(QIODevice::ReadOnly)) {
+    CHECK(modelFile.read(7) == QByteArray("NNCLIMB"), "ANN binary model: file starts with binary model magic");
+    modelFile.close();
+  }
+
+  // --config detects the binary container automatically
+  QString inputPath = tempDir() + "/ann_binary_input.json";
+  QFile inputFile(inputPath);
+
+  if (inputFile.open(QIODevice::WriteOnly)) {
+    inputFile.write(R"({"inputs": [[0.0, 1.0], [1.0, 1.0]]})");
+    inputFile.close();
+  }
+
+  QString outputPath = tempDir() + "/ann_binary_output.json";
+  auto predictResult = runNNCLI({"--config", modelPath, "--mode", "predict", "--device", "cpu", "--input", inputPath,
+                                 "--output", outputPath, "--log-level", "info"});
+
+  CHECK(predictResult.exitCode == 0, "ANN binary model: predict exit code 0");
+  CHECK(predictResult.stdOut.contains("Network type: ANN"), "ANN binary model: network type detected from header");
+  CHECK(QFile::exists(outputPath), "ANN binary model: predict output written");
+  std::cout << std::endl;
+}
+
 static void testANNPredictMNIST()
 {
   std::cout << "  testANNPredictMNIST... " << std::flush;
@@ -119,6 +159,7 @@ static void testANNPredictMNIST()
     CHECK(meta.contains("durationSeconds"), "ANN predict MNIST: metadata has 'durationSeconds'");
     CHECK(meta.contains("durationFormatted"), "ANN predict MNIST: metadata has 'durationFormatted'");
     CHECK(meta.contains("numInputs"), "ANN predict MNIST: metadata has 'numInputs'");
+    CHECK(meta["numWorkers"].toInt() >= 1, "ANN predict MNIST: metadata has 'numWorkers'");
     file.close();
   } else {
     CHECK(false, "ANN predict MNIST: failed to open output file");
@@ -590,11 +631,60 @@ static void testANNDropoutRateParsing()
 
 //===================================================================================================================//
 
+static void testANNModelKeepsNNCLISettings()
+{
+  std::cout << "  testANNModelKeepsNNCLISettings... ";
+
+  // Root-level NN-CLI settings must survive into the trained model, which predict/test/serve load as config
+  QString configPath = tempDir() + "/ann_settings_config.json";
+  QFile configFile(configPath);
+
+  if (configFile.open(QIODevice::WriteOnly)) {
+    configFile.write(R"({
+      "mode": "train", "device": "cpu", "numThreads": 1, "progressReports": 100, "saveModelInterval": 0,
+      "ioThreads": 3, "testBatchSize": 256,
+      "serveConfig": {"maxBatchSize": 8, "maxWaitMs": 5.0, "maxQueueSize": 64, "admissionTimeoutMs": 50.0},
+      "layersConfig": [
+        {"numNeurons": 2, "actvFunc": "relu"}, {"numNeurons": 4, "actvFunc": "relu"},
+        {"numNeurons": 2, "actvFunc": "sigmoid"}
+      ],
+      "trainingConfig": {"numEpochs": 5, "learningRate": 0.5}
+    })");
+    configFile.close();
+  }
+
+  QString outputPath = tempDir() + "/ann_settings_model.json";
+  auto result = runNNCLI({"--config", configPath, "--samples", fixturePath("ann_train_samples.json"), "--output",
+                          outputPath});
+
+  CHECK(result.exitCode == 0, "ANN settings training exits 0");
+
+  QFile file(outputPath);
+  file.open(QIODevice::ReadOnly);
+  auto json = QJsonDocument::fromJson(file.readAll()).object();
+  file.close();
+
+  CHECK(json["ioThreads"].toInt() == 3, "ioThreads saved in model JSON");
+  CHECK(json["testBatchSize"].toInt() == 256, "testBatchSize saved in model JSON");
+
+  auto sc = json["serveConfig"].toObject();
+  CHECK(sc["maxBatchSize"].toInt() == 8, "serveConfig.maxBatchSize saved in model JSON");
+  CHECK(std::abs(sc["maxWaitMs"].toDouble() - 5.0) < 1e-9, "serveConfig.maxWaitMs saved in model JSON");
+  CHECK(sc["maxQueueSize"].toInt() == 64, "serveConfig.maxQueueSize saved in model JSON");
+  CHECK(std::abs(sc["admissionTimeoutMs"].toDouble() - 50.0) < 1e-9,
+        "serveConfig.admissionTimeoutMs saved in model JSON");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
 void runANNTests()
 {
   // Train XOR first — downstream tests use its output model
   testANNTrainXOR();
   testANNNetworkDetection();
+  testANNBinaryModelRoundTrip();
   testANNModeOverride();
   testANNTrainWithWeightedLoss();
   testANNCheckpointParameters();
@@ -603,6 +693,7 @@ void runANNTests()
   testANNTrainWithDropout();
   testANNTrainWithAugmentation();
   testANNDropoutRateParsing();
+  testANNModelKeepsNNCLISettings();
   // MNIST tests (--full only): train first, then predict/test using trained model
   testANNTrainAndTestMNIST();
   testANNTrainAndTestMNISTGPU();
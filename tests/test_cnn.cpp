@@ -78,6 +78,7 @@ static void testCNNPredict()
     CHECK(meta.contains("startTime"), "CNN predict: metadata has 'startTime'");
     CHECK(meta.contains("durationSeconds"), "CNN predict: metadata has 'durationSeconds'");
     CHECK(meta.contains("numInputs"), "CNN predict: metadata has 'numInputs'");
+    CHECK(meta["numWorkers"].toInt() >= 1, "CNN predict: metadata has 'numWorkers'");
     file.close();
   } else {
     CHECK(false, "CNN predict: failed to open output file");
@@ -1,5 +1,18 @@
 #include "test_helpers.hpp"
+#include "../NN-CLI_CheckpointWriter.hpp"
 #include "../NN-CLI_DataLoader.hpp"
+#include "../NN-CLI_ImageDecoder.hpp"
+#include "../NN-CLI_ImageLoader.hpp"
+#include "../NN-CLI_JsonStream.hpp"
+#include "../NN-CLI_JsonWriter.hpp"
+#include "../NN-CLI_ModelFile.hpp"
+#include "../NN-CLI_ParallelImageLoader.hpp"
+#include "../NN-CLI_ParallelImageWriter.hpp"
+#include "../NN-CLI_PixelKernels.hpp"
+#include "../NN-CLI_PredictPipeline.hpp"
+#include "../NN-CLI_PredictScheduler.hpp"
+#include "../NN-CLI_ScratchArena.hpp"
+#include "../NN-CLI_Server.hpp"
 
 #include <ANN_Sample.hpp>
 #include <CNN_Sample.hpp>
@@ -7,10 +20,18 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
 #include <numeric>
 #include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 using namespace NN_CLI;
 
 //===================================================================================================================//
@@ -171,10 +192,1483 @@ static void testNewEpochResetsPrefetch()
 
 //===================================================================================================================//
 
+static void testRecycledBatchesReuseSampleBuffers()
+{
+  std::cout << "  testRecycledBatchesReuseSampleBuffers... ";
+
+  auto samples = makeANNSamples(9);
+  DataLoader<ANN::Sample<float>> loader;
+  loader.loadFromMemory(std::move(samples), 1, 1, 1);
+
+  auto provider = loader.makeSampleProvider();
+  std::vector<ulong> indices(9);
+  std::iota(indices.begin(), indices.end(), 0);
+  ulong batchSize = 3;
+
+  // Batch 1 is prefetched before batch 0 comes back, so batch 2 is the first one loaded into recycled buffers
+  auto batch0 = provider(indices, batchSize, 0);
+  std::vector<const float*> inputs, outputs;
+
+  for (const auto& sample : batch0) {
+    inputs.push_back(sample.input.data());
+    outputs.push_back(sample.output.data());
+  }
+
+  loader.recycle(std::move(batch0));
+  auto batch1 = provider(indices, batchSize, 1);
+  CHECK(batch1[0].input[0] == 3.0f, "batch 1 correct");
+  loader.recycle(std::move(batch1));
+
+  auto batch2 = provider(indices, batchSize, 2);
+  CHECK(batch2.size() == 3, "batch 2 has 3 samples");
+
+  for (ulong i = 0; i < batch2.size(); i++) {
+    CHECK(batch2[i].input[0] == static_cast<float>(6 + i), "recycled sample " + std::to_string(i) + " refilled");
+    CHECK(batch2[i].output[(6 + i) % 3] == 1.0f, "recycled output " + std::to_string(i) + " refilled");
+    CHECK(batch2[i].input.data() == inputs[i], "input buffer " + std::to_string(i) + " reused");
+    CHECK(batch2[i].output.data() == outputs[i], "output buffer " + std::to_string(i) + " reused");
+  }
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testAugmentationIndependentOfThreadsAndBatches()
+{
+  std::cout << "  testAugmentationIndependentOfThreadsAndBatches... ";
+
+  // The inputs of every sample the provider returns over a number of epochs: 12 random 3x8x8 images, tripled
+  auto loadEpochs = [](int ioThreads, ulong batchSize, ulong seed, int epochs) {
+    std::mt19937 imageRng(9);
+    std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+    ANN::Samples<float> samples = makeANNSamples(12);
+
+    for (auto& sample : samples) {
+      sample.input.resize(3 * 8 * 8);
+
+      for (float& value : sample.input)
+        value = pixel(imageRng);
+    }
+
+    DataLoader<ANN::Sample<float>> loader;
+    loader.loadFromMemory(std::move(samples), 3, 8, 8);
+    loader.setIOThreads(ioThreads);
+    loader.setAugmentationSeed(seed);
+    loader.planAugmentation(3, false);
+
+    auto provider = loader.makeSampleProvider();
+    std::vector<ulong> indices(loader.numSamples());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::vector<std::vector<float>> inputs;
+
+    for (int epoch = 0; epoch < epochs; epoch++)
+      for (ulong b = 0; b * batchSize < indices.size(); b++)
+        for (const auto& sample : provider(indices, batchSize, b))
+          inputs.push_back(sample.input);
+
+    return inputs;
+  };
+
+  std::vector<std::vector<float>> reference = loadEpochs(1, 4, 123, 2);
+  CHECK(reference.size() == 2 * 36, "two epochs of 36 samples");
+  CHECK(loadEpochs(4, 7, 123, 2) == reference, "same transforms with other thread counts and batch sizes");
+  CHECK(loadEpochs(1, 4, 124, 2) != reference, "another seed gives other transforms");
+
+  // Originals come back unchanged each epoch; augmented copies get new transforms
+  std::vector<std::vector<float>> firstEpoch(reference.begin(), reference.begin() + 36);
+  std::vector<std::vector<float>> secondEpoch(reference.begin() + 36, reference.end());
+  ulong unchanged = 0;
+
+  for (ulong i = 0; i < 36; i++)
+    unchanged += (firstEpoch[i] == secondEpoch[i]) ? 1 : 0;
+
+  CHECK(unchanged >= 12 && unchanged < 36, "each epoch draws new transforms for augmented samples");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testPackedDatasetRoundTrip()
+{
+  std::cout << "  testPackedDatasetRoundTrip... ";
+
+  std::string packedPath = (tempDir() + "/dataloader_roundtrip.nnd").toStdString();
+
+  // Export 7 in-memory samples, then read them back through a memory-mapped packed source
+  DataLoader<ANN::Sample<float>> source;
+  source.loadFromMemory(makeANNSamples(7), 1, 1, 1);
+  source.exportPacked(packedPath, false, 0);
+
+  CHECK(PackedDataset::isPackedFile(packedPath), "exported file has packed dataset magic");
+
+  DataLoader<ANN::Sample<float>> loader;
+  loader.loadPacked(packedPath, 1, 1, 1);
+  CHECK(loader.numSamples() == 7, "packed loader has 7 samples");
+
+  auto provider = loader.makeSampleProvider();
+  std::vector<ulong> indices = {6, 0, 3};
+  auto batch = provider(indices, 3, 0);
+
+  CHECK(batch.size() == 3, "packed batch has 3 samples");
+  CHECK(batch[0].input[0] == 6.0f, "packed sample 0 = original[6]");
+  CHECK(batch[1].input[0] == 0.0f, "packed sample 1 = original[0]");
+  CHECK(batch[2].output.size() == 3 && batch[2].output[0] == 1.0f, "packed sample 2 output = one-hot class 0");
+
+  auto outputs = loader.getAllOutputs();
+  CHECK(outputs.size() == 7 && outputs[4][1] == 1.0f, "packed getAllOutputs reads labels from the file");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+// Overwrite `size` bytes at `offset` in a file and report whether PackedDataset::open then rejects it.
+static bool packedOpenRejectsPatch(const std::string& path, qint64 offset, const void* value, qint64 size)
+{
+  QFile file(QString::fromStdString(path));
+  file.open(QIODevice::ReadWrite);
+  file.seek(offset);
+  file.write(static_cast<const char*>(value), size);
+  file.close();
+
+  try {
+    PackedDataset::open(path);
+  } catch (const std::runtime_error&) {
+    return true;
+  }
+
+  return false;
+}
+
+static void testPackedDatasetRejectsCorruptHeader()
+{
+  std::cout << "  testPackedDatasetRejectsCorruptHeader... ";
+
+  std::string packedPath = (tempDir() + "/dataloader_corrupt.nnd").toStdString();
+  DataLoader<ANN::Sample<float>> source;
+  source.loadFromMemory(makeANNSamples(4), 1, 1, 1);
+
+  // Header field offsets: inputType 16, numSamples 24, inputSize 32, inputC 48, inputOffset 72, outputOffset 80
+  uint32_t badType = 7;
+  uint64_t manySamples = uint64_t(1) << 60;
+  uint64_t hugeSize = ~uint64_t(0) / 2;
+  int32_t badChannels = 2;
+  uint64_t headerOffset = 8;
+  uint64_t endOffset = 1ull << 40;
+
+  source.exportPacked(packedPath, false, 0);
+  CHECK(packedOpenRejectsPatch(packedPath, 16, &badType, sizeof(badType)), "unknown input type rejected");
+  source.exportPacked(packedPath, false, 0);
+  CHECK(packedOpenRejectsPatch(packedPath, 24, &manySamples, sizeof(manySamples)), "sample count past EOF rejected");
+  source.exportPacked(packedPath, false, 0);
+  CHECK(packedOpenRejectsPatch(packedPath, 32, &hugeSize, sizeof(hugeSize)), "overflowing input size rejected");
+  source.exportPacked(packedPath, false, 0);
+  CHECK(packedOpenRejectsPatch(packedPath, 48, &badChannels, sizeof(badChannels)), "shape/size mismatch rejected");
+  source.exportPacked(packedPath, false, 0);
+  CHECK(packedOpenRejectsPatch(packedPath, 72, &headerOffset, sizeof(headerOffset)), "input inside header rejected");
+  source.exportPacked(packedPath, false, 0);
+  CHECK(packedOpenRejectsPatch(packedPath, 80, &endOffset, sizeof(endOffset)), "output offset past EOF rejected");
+
+  source.exportPacked(packedPath, false, 0);
+  CHECK(PackedDataset::open(packedPath)->numSamples() == 4, "intact file still opens");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testManifestStreamsSamplesArray()
+{
+  std::cout << "  testManifestStreamsSamplesArray... ";
+
+  std::string samplesPath = (tempDir() + "/dataloader_stream_samples.json").toStdString();
+
+  // Other keys (before and after, including a nested "samples") must not be picked up as entries
+  QFile file(QString::fromStdString(samplesPath));
+  file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  file.write("{\"meta\": {\"samples\": [9]}, \"samples\": [");
+  file.write("{\"input\": [0.5, 1], \"output\": [1, 0], \"note\": {\"tags\": [[1], []]}},");
+  file.write("{\"input\": [2, 3e-1], \"output\": [0, 1]}");
+  file.write("], \"trailer\": [{\"input\": [7]}]}");
+  file.close();
+
+  DataLoader<ANN::Sample<float>> loader;
+  loader.loadManifest(samplesPath, IOConfig(), 0, 0, 0, 0, 0, 0);
+  CHECK(loader.numSamples() == 2, "streamed manifest has 2 entries");
+
+  auto provider = loader.makeSampleProvider();
+  std::vector<ulong> indices = {1, 0};
+  auto batch = provider(indices, 2, 0);
+
+  CHECK(batch.size() == 2, "streamed batch has 2 samples");
+  CHECK(batch[0].input.size() == 2 && batch[0].input[1] == 0.3f, "streamed sample 1 input parsed");
+  CHECK(batch[1].output.size() == 2 && batch[1].output[0] == 1.0f, "streamed sample 0 output parsed");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testCheckpointWriterKeepsLatestAndFinishes()
+{
+  std::cout << "  testCheckpointWriterKeepsLatestAndFinishes... ";
+
+  std::mutex writtenMutex;
+  std::vector<std::string> written;
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+
+  auto record = [&](const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(writtenMutex);
+    written.push_back(filePath);
+  };
+
+  {
+    CheckpointWriter writer(LogLevel::QUIET);
+
+    // While "a" is being written, "b" is pending until "c" supersedes it
+    writer.submit("a", [&](const std::string& filePath) {
+      entered = true;
+
+      while (!release)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      record(filePath);
+    });
+
+    while (!entered)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    writer.submit("b", record);
+    writer.submit("c", record);
+    release = true;
+    writer.flush();
+
+    CHECK(written == std::vector<std::string>({"a", "c"}), "flush waits for the in-flight write; newer job wins");
+
+    // A job throwing something other than std::exception must not leave flush() waiting forever
+    writer.submit("d", [](const std::string&) { throw 42; });
+    writer.flush();
+    writer.submit("e", record);
+    writer.flush();
+
+    CHECK(written.size() == 3 && written.back() == "e", "writer keeps working after a job throws a non-exception");
+  }
+
+  // A failed save leaves neither a .tmp file nor a partial model: the previous file stays as it was
+  std::string modelPath = (tempDir() + "/checkpoint_failed.json").toStdString();
+  QFile previous(QString::fromStdString(modelPath));
+  previous.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  previous.write("{}");
+  previous.close();
+
+  ModelFile::ANNSnapshot snapshot;
+  snapshot.header["name"] = "\xff"; // Invalid UTF-8: the header cannot be serialised
+
+  {
+    CheckpointWriter writer(LogLevel::QUIET);
+    writer.submit(modelPath, [&](const std::string& filePath) { ModelFile::saveANNModel(snapshot, filePath); });
+    writer.flush();
+  }
+
+  previous.open(QIODevice::ReadOnly);
+  CHECK(previous.readAll() == QByteArray("{}"), "failed write leaves the previous model intact");
+  previous.close();
+  CHECK(!QFile::exists(QString::fromStdString(modelPath + ".tmp")), "failed write leaves no .tmp file");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testBinaryModelRejectsCorruptPreamble()
+{
+  std::cout << "  testBinaryModelRejectsCorruptPreamble... ";
+
+  std::string modelPath = (tempDir() + "/corrupt_preamble.nnb").toStdString();
+  ModelFile::ANNSnapshot snapshot;
+  snapshot.header["mode"] = "predict";
+  ModelFile::saveANNModel(snapshot, modelPath);
+
+  QFile file(QString::fromStdString(modelPath));
+  file.open(QIODevice::ReadOnly);
+  QByteArray bytes = file.readAll();
+  file.close();
+
+  size_t blobOffset = 0;
+  nlohmann::json header = ModelFile::readBinaryHeader(bytes.constData(), bytes.size(), modelPath, blobOffset);
+  CHECK(header.value("mode", "") == "predict", "intact binary model header is read back");
+
+  // headerOffset (at 16) + headerSize (at 24) wrapping past 2^64 must not pass as inside the file
+  auto rejects = [&](size_t fieldOffset, uint64_t value) {
+    QByteArray corrupt = bytes;
+    std::memcpy(corrupt.data() + fieldOffset, &value, sizeof(value));
+
+    try {
+      ModelFile::readBinaryHeader(corrupt.constData(), corrupt.size(), modelPath, blobOffset);
+    } catch (const std::runtime_error& e) {
+      return std::string(e.what()).find("truncated?") != std::string::npos;
+    }
+
+    return false;
+  };
+
+  uint64_t headerOffset = 0;
+  std::memcpy(&headerOffset, bytes.constData() + 16, sizeof(headerOffset));
+
+  CHECK(rejects(24, std::numeric_limits<uint64_t>::max() - headerOffset + 1), "wrapping headerSize rejected");
+  CHECK(rejects(16, std::numeric_limits<uint64_t>::max()), "headerOffset past the end rejected");
+  CHECK(rejects(24, static_cast<uint64_t>(bytes.size())), "header running past the end rejected");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testImageCacheEvictsWithinBudget()
+{
+  std::cout << "  testImageCacheEvictsWithinBudget... ";
+
+  // One shard, room for three 10-byte images
+  ImageCache cache(30, 1);
+  auto image = [](unsigned char value) {
+    return std::make_shared<const std::vector<unsigned char>>(10, value);
+  };
+
+  cache.insert(0, image(0));
+  cache.insert(1, image(1));
+  cache.insert(2, image(2));
+  CHECK(cache.find(0) && (*cache.find(0))[0] == 0, "image 0 cached");
+
+  // Image 0 was referenced, so CLOCK evicts image 1 to make room
+  cache.insert(3, image(3));
+  CHECK(cache.find(1) == nullptr, "unreferenced image 1 evicted");
+  CHECK(cache.find(0) != nullptr && cache.find(3) != nullptr, "images 0 and 3 present");
+
+  ImageCache::Stats stats = cache.takeStats();
+  CHECK(stats.entries == 3 && stats.bytes == 30, "cache stays within budget");
+  CHECK(stats.hits == 4 && stats.misses == 1, "hits and misses counted");
+  CHECK(cache.takeStats().hits == 0, "takeStats resets the counters");
+
+  cache.insert(4, std::make_shared<const std::vector<unsigned char>>(31, 0));
+  CHECK(cache.find(4) == nullptr, "image larger than the budget is not cached");
+
+  // Input images only (DataLoader keys 2 * sample): every shard takes a share, so 90% of the budget fits
+  ImageCache sharded(16 * 100);
+
+  for (ulong sample = 0; sample < 144; sample++)
+    sharded.insert(sample * 2, image(static_cast<unsigned char>(sample)));
+
+  stats = sharded.takeStats();
+  CHECK(stats.entries == 144 && stats.bytes == 1440, "input-only keys use every shard before evicting");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testManifestImagesServedFromCache()
+{
+  std::cout << "  testManifestImagesServedFromCache... ";
+
+  std::string imagePath = (tempDir() + "/dataloader_cache_image.png").toStdString();
+  std::string samplesPath = (tempDir() + "/dataloader_cache_samples.json").toStdString();
+
+  ImageLoader::saveImage(imagePath, {0.0f, 1.0f, 1.0f, 0.0f}, 1, 2, 2);
+
+  QFile file(QString::fromStdString(samplesPath));
+  file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  file.write("{\"samples\": [{\"input\": \"dataloader_cache_image.png\", \"output\": [1, 0]},");
+  file.write("{\"input\": \"dataloader_cache_image.png\", \"output\": [0, 1]}]}");
+  file.close();
+
+  IOConfig ioConfig;
+  ioConfig.inputType = DataType::IMAGE;
+
+  auto cache = std::make_shared<ImageCache>(1024 * 1024);
+  DataLoader<ANN::Sample<float>> loader;
+  loader.loadManifest(samplesPath, ioConfig, 1, 2, 2);
+  loader.setImageCache(cache);
+
+  auto provider = loader.makeSampleProvider();
+  std::vector<ulong> indices = {0, 1};
+
+  auto first = provider(indices, 2, 0);
+  ImageCache::Stats firstStats = cache->takeStats();
+  CHECK(firstStats.misses == 2 && firstStats.hits == 0, "first epoch decodes every image");
+
+  auto second = provider(indices, 2, 0);
+  ImageCache::Stats secondStats = cache->takeStats();
+  CHECK(secondStats.hits == 2 && secondStats.misses == 0, "second epoch is served from the cache");
+  CHECK(second[0].input == first[0].input, "cached image converts to the same input");
+  CHECK(second[1].input.size() == 4 && second[1].input[1] == 1.0f, "cached image keeps NCHW values");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testDiskImageCacheDetectsStaleAndCorruptEntries()
+{
+  std::cout << "  testDiskImageCacheDetectsStaleAndCorruptEntries... ";
+
+  QString cacheDir = tempDir() + "/dataloader_disk_cache";
+  QDir(cacheDir).removeRecursively();
+
+  std::string imagePath = (tempDir() + "/dataloader_disk_cache_image.png").toStdString();
+  ImageLoader::saveImage(imagePath, {0.0f, 1.0f, 1.0f, 0.0f}, 1, 2, 2);
+  std::vector<unsigned char> pixels = ImageLoader::decodeImage(imagePath, 1, 2, 2);
+
+  DiskImageCache cache(cacheDir.toStdString());
+  std::vector<unsigned char> loaded;
+
+  CHECK(!cache.load(imagePath, 1, 2, 2, loaded), "empty cache misses");
+  cache.store(imagePath, 1, 2, 2, pixels);
+  CHECK(cache.load(imagePath, 1, 2, 2, loaded) && loaded == pixels, "stored entry reads back");
+  CHECK(!cache.load(imagePath, 1, 4, 4, loaded), "different target shape is a different entry");
+
+  // Flip a pixel byte at the end of the entry: the checksum no longer matches
+  QStringList entries = QDir(cacheDir).entryList(QStringList() << "*.nnic", QDir::Files);
+  CHECK(entries.size() == 1, "one entry file written");
+
+  QFile entryFile(cacheDir + "/" + entries[0]);
+  entryFile.open(QIODevice::ReadWrite);
+  QByteArray entryData = entryFile.readAll();
+
+  std::string backend = ImageDecoder::backendName(ImageDecoder::select(imagePath, 1));
+  CHECK(entryData.toStdString().find("|" + backend) != std::string::npos, "entry key records the decoder backend");
+  entryData[entryData.size() - 1] = static_cast<char>(entryData[entryData.size() - 1] ^ 0xFF);
+  entryFile.seek(0);
+  entryFile.write(entryData);
+  entryFile.close();
+
+  CHECK(!cache.load(imagePath, 1, 2, 2, loaded), "corrupt entry is rejected");
+  cache.store(imagePath, 1, 2, 2, pixels);
+  CHECK(cache.load(imagePath, 1, 2, 2, loaded) && loaded == pixels, "corrupt entry rebuilt");
+
+  // Replacing the source image (different size on disk) makes the entry stale
+  ImageLoader::saveImage(imagePath, std::vector<float>(64 * 64, 0.5f), 1, 64, 64);
+  CHECK(!cache.load(imagePath, 1, 2, 2, loaded), "entry of a changed source is stale");
+
+  DiskImageCache::Stats stats = cache.takeStats();
+  CHECK(stats.hits == 2 && stats.misses == 2 && stats.rebuilt == 2, "disk cache counters");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+// Write a big-endian uint32 (IDX header field).
+static void writeBigEndian(QFile& file, uint32_t value)
+{
+  char bytes[4] = {static_cast<char>(value >> 24), static_cast<char>(value >> 16), static_cast<char>(value >> 8),
+                   static_cast<char>(value)};
+  file.write(bytes, 4);
+}
+
+static void testParallelImageLoaderKeepsRequestOrder()
+{
+  std::cout << "  testParallelImageLoaderKeepsRequestOrder... ";
+
+  // Distinct grey levels (multiples of 17 survive the 8-bit round trip exactly)
+  const int numImages = 16;
+  ParallelImageLoader imageLoader(4);
+
+  for (int i = 0; i < numImages; i++) {
+    std::string imagePath = (tempDir() + "/parallel_image_" + QString::number(i) + ".png").toStdString();
+    ImageLoader::saveImage(imagePath, std::vector<float>(3 * 3, i * 17.0f / 255.0f), 1, 3, 3);
+    imageLoader.add(imagePath, 1, 3, 3);
+  }
+
+  std::vector<std::vector<float>> images = imageLoader.loadAll("Decoding images:", 0);
+  bool ordered = images.size() == static_cast<size_t>(numImages);
+
+  for (int i = 0; ordered && i < numImages; i++)
+    ordered = images[i].size() == 9 && images[i][4] == i * 17.0f / 255.0f;
+
+  CHECK(ordered, "images come back in request order");
+  CHECK(imageLoader.size() == 0, "loadAll clears the queue");
+
+  // A failing image surfaces as the original error, not a generic one
+  imageLoader.add((tempDir() + "/parallel_image_0.png").toStdString(), 1, 3, 3);
+  imageLoader.add((tempDir() + "/parallel_image_missing.png").toStdString(), 1, 3, 3);
+
+  bool threw = false;
+
+  try {
+    imageLoader.loadAll("Decoding images:", 0);
+  } catch (const std::runtime_error& e) {
+    threw = std::string(e.what()).find("parallel_image_missing.png") != std::string::npos;
+  }
+
+  CHECK(threw, "missing image rethrows its load error");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testParallelImageWriterSavesEveryImage()
+{
+  std::cout << "  testParallelImageWriterSavesEveryImage... ";
+
+  // Each image is a distinct grey level; outputs must stay alive until saveAll() returns
+  const int numImages = 12;
+  std::vector<std::vector<float>> outputs;
+
+  for (int i = 0; i < numImages; i++)
+    outputs.push_back(std::vector<float>(16 * 16, i * 17.0f / 255.0f));
+
+  ParallelImageWriter imageWriter(4);
+
+  for (int i = 0; i < numImages; i++) {
+    std::string imagePath = (tempDir() + "/parallel_output_" + QString::number(i) + ".png").toStdString();
+    imageWriter.add(imagePath, outputs[i], 1, 16, 16);
+  }
+
+  imageWriter.saveAll("Saving images:", 0);
+  CHECK(imageWriter.size() == 0, "saveAll clears the queue");
+
+  bool saved = true;
+
+  for (int i = 0; saved && i < numImages; i++) {
+    std::string imagePath = (tempDir() + "/parallel_output_" + QString::number(i) + ".png").toStdString();
+    saved = ImageLoader::loadImage(imagePath, 1, 16, 16)[100] == i * 17.0f / 255.0f;
+  }
+
+  CHECK(saved, "every image is saved to its own path");
+
+  // The compression level only changes how hard deflate searches; PNG stays lossless
+  std::vector<float> gradient(64 * 64);
+
+  for (size_t i = 0; i < gradient.size(); i++)
+    gradient[i] = static_cast<float>(i % 64) * 4.0f / 255.0f;
+
+  std::string fastPath = (tempDir() + "/parallel_output_fast.png").toStdString();
+  std::string smallPath = (tempDir() + "/parallel_output_small.png").toStdString();
+  ImageLoader::setPngCompressionLevel(0);
+  ImageLoader::saveImage(fastPath, gradient, 1, 64, 64);
+  ImageLoader::setPngCompressionLevel(32);
+  ImageLoader::saveImage(smallPath, gradient, 1, 64, 64);
+  ImageLoader::setPngCompressionLevel(8);
+
+  bool lossless = ImageLoader::loadImage(fastPath, 1, 64, 64) == gradient &&
+                  ImageLoader::loadImage(smallPath, 1, 64, 64) == gradient;
+  CHECK(lossless, "PNG round-trips exactly at any compression level");
+
+  // JPEG quality is passed through: a lower quality gives a smaller file
+  std::string highPath = (tempDir() + "/parallel_output_q95.jpg").toStdString();
+  std::string lowPath = (tempDir() + "/parallel_output_q10.jpg").toStdString();
+  ImageLoader::saveImage(highPath, gradient, 1, 64, 64, 95);
+  ImageLoader::saveImage(lowPath, gradient, 1, 64, 64, 10);
+
+  CHECK(QFile(QString::fromStdString(highPath)).size() > QFile(QString::fromStdString(lowPath)).size(),
+        "jpegQuality 95 produces a larger file than 10");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+// The transforms applied one after another, as applyRandomTransforms did before they were fused.
+static void applySequentialTransforms(std::vector<float>& data, int c, int h, int w, AugmentationRNG& rng,
+                                      const Loader::AugmentationTransforms& transforms, float probability)
+{
+  std::bernoulli_distribution coin(probability);
+
+  if (transforms.horizontalFlip && coin(rng))
+    ImageLoader::horizontalFlip(data, c, h, w);
+
+  if (transforms.rotation > 0.0f && coin(rng))
+    ImageLoader::randomRotation(data, c, h, w, transforms.rotation, rng);
+
+  if (transforms.translation > 0.0f && coin(rng))
+    ImageLoader::randomTranslation(data, c, h, w, transforms.translation, rng);
+
+  if (transforms.brightness > 0.0f && coin(rng))
+    ImageLoader::randomBrightness(data, c, h, w, transforms.brightness, rng);
+
+  if (transforms.contrast > 0.0f && coin(rng))
+    ImageLoader::randomContrast(data, c, h, w, 1.0f - transforms.contrast, 1.0f + transforms.contrast, rng);
+
+  if (transforms.gaussianNoise > 0.0f && coin(rng))
+    ImageLoader::addGaussianNoise(data, transforms.gaussianNoise, rng);
+}
+
+static void testFusedAugmentationMatchesSequentialTransforms()
+{
+  std::cout << "  testFusedAugmentationMatchesSequentialTransforms... ";
+
+  const int c = 3, h = 17, w = 22;
+  std::mt19937 imageRng(3);
+  std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+  std::vector<float> image(c * h * w);
+
+  for (float& value : image)
+    value = pixel(imageRng);
+
+  Loader::AugmentationTransforms all;
+  all.rotation = 30.0f;
+  all.translation = 0.2f;
+
+  // Noise after a warp without contrast must still be drawn in addGaussianNoise's (channel-major) order
+  Loader::AugmentationTransforms noContrast = all;
+  noContrast.contrast = 0.0f;
+
+  Loader::AugmentationTransforms noNoise = all;
+  noNoise.gaussianNoise = 0.0f;
+
+  Loader::AugmentationTransforms geometricOnly = noNoise;
+  geometricOnly.brightness = 0.0f;
+  geometricOnly.contrast = 0.0f;
+
+  struct Case {
+      const Loader::AugmentationTransforms* transforms;
+      float probability;
+  };
+
+  std::vector<Case> cases = {{&all, 1.0f},     {&all, 0.5f},     {&noContrast, 1.0f},    {&noContrast, 0.5f},
+                             {&noNoise, 1.0f}, {&noNoise, 0.5f}, {&geometricOnly, 1.0f}, {&geometricOnly, 0.5f}};
+  float maxDifference = 0.0f;
+  bool sameSize = true;
+
+  for (const Case& testCase : cases) {
+    for (unsigned seed = 0; seed < 20; seed++) {
+      std::vector<float> fused = image;
+      std::vector<float> sequential = image;
+      AugmentationRNG fusedRng(seed, 0, 0);
+      AugmentationRNG sequentialRng(seed, 0, 0);
+
+      ImageLoader::applyRandomTransforms(fused, c, h, w, fusedRng, *testCase.transforms, testCase.probability);
+      applySequentialTransforms(sequential, c, h, w, sequentialRng, *testCase.transforms, testCase.probability);
+
+      sameSize = sameSize && fused.size() == sequential.size();
+
+      for (size_t i = 0; sameSize && i < fused.size(); i++)
+        maxDifference = std::max(maxDifference, std::fabs(fused[i] - sequential[i]));
+    }
+  }
+
+  CHECK(sameSize, "fused transforms keep the image size");
+  CHECK(maxDifference < 1e-4f, "fused transforms match the sequential ones");
+
+  // Any combination stays in [0, 1]
+  Loader::AugmentationTransforms strong = all;
+  strong.brightness = 0.5f;
+  strong.contrast = 0.9f;
+  strong.gaussianNoise = 0.3f;
+  bool inRange = true;
+
+  for (unsigned seed = 0; seed < 20; seed++) {
+    std::vector<float> data = image;
+    AugmentationRNG rng(seed, 0, 0);
+    strong.contrast = (seed % 2 == 0) ? 0.9f : 0.0f;
+    ImageLoader::applyRandomTransforms(data, c, h, w, rng, strong, 1.0f);
+
+    for (float value : data)
+      inRange = inRange && value >= 0.0f && value <= 1.0f;
+  }
+
+  CHECK(inRange, "augmented values stay within [0, 1]");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testPixelKernelsMatchScalarLoop()
+{
+  std::cout << "  testPixelKernelsMatchScalarLoop... ";
+
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::uniform_real_distribution<float> value(-0.2f, 1.2f);
+  bool sameFloats = true;
+  bool sameBytes = true;
+
+  // Every supported instruction set, every channel count (2 has no vector kernel), and sizes that leave a tail
+  for (int c : {1, 2, 3, 4}) {
+    for (size_t planeSize : {0ul, 1ul, 7ul, 16ul, 31ul, 64ul, 1000ul}) {
+      std::vector<unsigned char> pixels(c * planeSize);
+      std::vector<float> data(c * planeSize);
+
+      for (unsigned char& pixel : pixels)
+        pixel = static_cast<unsigned char>(byte(rng));
+
+      for (float& v : data)
+        v = value(rng);
+
+      // Out-of-range values, and values just either side of a rounding boundary
+      if (data.size() >= 4) {
+        data[0] = std::nanf("");
+        data[1] = -INFINITY;
+        data[2] = std::nextafter(0.5f / 255.0f, 0.0f);
+        data[3] = 0.5f / 255.0f;
+      }
+
+      std::vector<float> expectedData(data.size());
+      std::vector<unsigned char> expectedPixels(pixels.size());
+      PixelKernels::hwcToNCHW(pixels.data(), expectedData.data(), c, planeSize, PixelKernels::ISA::SCALAR);
+      PixelKernels::nchwToHWC(data.data(), expectedPixels.data(), c, planeSize, PixelKernels::ISA::SCALAR);
+
+      for (size_t p = 0; p < planeSize; p++)
+        for (int ch = 0; ch < c; ch++)
+          sameFloats = sameFloats && expectedData[ch * planeSize + p] == pixels[p * c + ch] / 255.0f;
+
+      for (int isa = 0; isa <= static_cast<int>(PixelKernels::detectISA()); isa++) {
+        std::vector<float> convertedData(data.size(), -1.0f);
+        std::vector<unsigned char> convertedPixels(pixels.size(), 7);
+        PixelKernels::hwcToNCHW(pixels.data(), convertedData.data(), c, planeSize, PixelKernels::ISA(isa));
+        PixelKernels::nchwToHWC(data.data(), convertedPixels.data(), c, planeSize, PixelKernels::ISA(isa));
+
+        sameFloats = sameFloats && convertedData == expectedData;
+        sameBytes = sameBytes && convertedPixels == expectedPixels;
+      }
+    }
+  }
+
+  CHECK(sameFloats, "HWC to NCHW matches the scalar loop on every instruction set");
+  CHECK(sameBytes, "NCHW to HWC matches the scalar loop on every instruction set");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testScratchArenaServesDecodingAfterWarmUp()
+{
+  std::cout << "  testScratchArenaServesDecodingAfterWarmUp... ";
+
+  ScratchArena::takeStats();
+
+  // The first Scope finds no arena and uses malloc; the arena then grows to what that Scope needed
+  auto allocateSome = []() {
+    ScratchArena::Scope scope;
+    void* small = ScratchArena::allocate(100);
+    void* grown = ScratchArena::reallocate(ScratchArena::allocate(1000), 1000, 50000);
+    bool aligned = reinterpret_cast<uintptr_t>(small) % alignof(std::max_align_t) == 0;
+    std::memset(grown, 1, 50000);
+    ScratchArena::release(grown);
+    ScratchArena::release(small);
+    return aligned;
+  };
+
+  // On a new thread, whose arena starts empty
+  ScratchArena::Stats coldStats, warmStats;
+  size_t grownCapacity = 0;
+  bool aligned = false;
+
+  std::thread([&]() {
+    allocateSome();
+    coldStats = ScratchArena::takeStats();
+    grownCapacity = ScratchArena::capacity();
+    aligned = allocateSome();
+    warmStats = ScratchArena::takeStats();
+  }).join();
+
+  CHECK(coldStats.heapAllocations == 3 && coldStats.scratchAllocations == 0, "cold arena falls back to malloc");
+  CHECK(grownCapacity >= 51100, "arena grows to the demand of its first Scope");
+  CHECK(warmStats.heapAllocations == 0 && warmStats.scratchAllocations == 2, "warm arena serves every allocation");
+  CHECK(aligned, "arena allocations are aligned like malloc's");
+
+  // Decoding and resizing an image: after the first load, stb's buffers all come from the arena
+  std::string imagePath = (tempDir() + "/scratch_arena.png").toStdString();
+  ImageLoader::saveImage(imagePath, std::vector<float>(3 * 40 * 30, 0.25f), 3, 40, 30);
+  std::vector<float> first = ImageLoader::loadImage(imagePath, 3, 20, 15);
+  ScratchArena::takeStats();
+
+  std::vector<float> second(first.size());
+  ImageLoader::loadImage(imagePath, 3, 20, 15, second.data());
+  ScratchArena::Stats decodeStats = ScratchArena::takeStats();
+
+  CHECK(decodeStats.scratchAllocations > 0 && decodeStats.heapAllocations == 0,
+        "a repeated decode does not touch the heap");
+  CHECK(second == first, "loading into a caller buffer gives the same image");
+
+  // Outside a Scope the functions behave like malloc and free
+  void* heap = ScratchArena::allocate(64);
+  ScratchArena::release(heap);
+  CHECK(ScratchArena::takeStats().scratchAllocations == 0, "no Scope, no arena");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testImageDecoderBackendsMatchStb()
+{
+  std::cout << "  testImageDecoderBackendsMatchStb... ";
+
+  // A smooth colour gradient, which every decoder reproduces to within a level or two
+  const int h = 96, w = 128;
+  std::vector<float> gradient(3 * h * w);
+
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      gradient[0 * h * w + y * w + x] = static_cast<float>(x) / w;
+      gradient[1 * h * w + y * w + x] = static_cast<float>(y) / h;
+      gradient[2 * h * w + y * w + x] = 0.5f + 0.25f * std::sin(0.1f * (x + y));
+    }
+  }
+
+  std::string jpegPath = (tempDir() + "/image_decoder.jpg").toStdString();
+  std::string pngPath = (tempDir() + "/image_decoder.png").toStdString();
+  ImageLoader::saveImage(jpegPath, gradient, 3, h, w, 95);
+  ImageLoader::saveImage(pngPath, gradient, 3, h, w);
+
+  CHECK(ImageDecoder::select(jpegPath, 3) ==
+          (ImageDecoder::available(ImageDecoder::Backend::LIBJPEG) ? ImageDecoder::Backend::LIBJPEG
+                                                                   : ImageDecoder::Backend::STB),
+        "JPEG goes to libjpeg when it is compiled in");
+  CHECK(ImageDecoder::select(pngPath, 3) ==
+          (ImageDecoder::available(ImageDecoder::Backend::LIBPNG) ? ImageDecoder::Backend::LIBPNG
+                                                                  : ImageDecoder::Backend::STB),
+        "PNG goes to libpng when it is compiled in");
+
+  // At full size, every channel count: PNG is lossless (grey may round differently), JPEG decoders differ slightly
+  for (const std::string& path : {jpegPath, pngPath}) {
+    bool isJpeg = (path == jpegPath);
+
+    for (int c = 1; c <= 4; c++) {
+      ImageDecoder::Image reference = ImageDecoder::decode(path, c, h, w, ImageDecoder::Backend::STB);
+      ImageDecoder::Image image = ImageDecoder::decode(path, c, h, w);
+      std::string label = ImageDecoder::backendName(ImageDecoder::select(path, c)) + " c=" + std::to_string(c);
+      CHECK(image.width == w && image.height == h, label + " decodes at full size");
+
+      double totalDiff = 0.0;
+      int maxDiff = 0;
+
+      for (size_t i = 0; i < static_cast<size_t>(c) * h * w; i++) {
+        int diff = std::abs(static_cast<int>(image.pixels[i]) - static_cast<int>(reference.pixels[i]));
+        totalDiff += diff;
+        maxDiff = std::max(maxDiff, diff);
+      }
+
+      double meanDiff = totalDiff / (static_cast<double>(c) * h * w);
+      CHECK(isJpeg ? (meanDiff < 1.0 && maxDiff <= 8) : maxDiff <= 1, label + " matches stb");
+      ScratchArena::release(image.pixels);
+      ScratchArena::release(reference.pixels);
+    }
+  }
+
+  // Scaled down: libjpeg decodes at 1/4 scale, and the resized result still matches an average of the full image
+  ImageDecoder::Image quarter = ImageDecoder::decode(jpegPath, 3, h / 4, w / 4);
+  bool scaled = ImageDecoder::available(ImageDecoder::Backend::LIBJPEG);
+  CHECK(quarter.width == (scaled ? w / 4 : w) && quarter.height == (scaled ? h / 4 : h),
+        "JPEG is decoded no larger than needed");
+  ScratchArena::release(quarter.pixels);
+
+  std::vector<unsigned char> small = ImageLoader::decodeImage(jpegPath, 3, h / 4, w / 4);
+  ImageDecoder::Image full = ImageDecoder::decode(jpegPath, 3, h, w, ImageDecoder::Backend::STB);
+  double totalDiff = 0.0;
+
+  for (int y = 0; y < h / 4; y++) {
+    for (int x = 0; x < w / 4; x++) {
+      for (int ch = 0; ch < 3; ch++) {
+        int sum = 0;
+
+        for (int dy = 0; dy < 4; dy++)
+          for (int dx = 0; dx < 4; dx++)
+            sum += full.pixels[((y * 4 + dy) * w + x * 4 + dx) * 3 + ch];
+
+        totalDiff += std::abs(sum / 16.0 - small[(y * (w / 4) + x) * 3 + ch]);
+      }
+    }
+  }
+
+  CHECK(totalDiff / (3 * (h / 4) * (w / 4)) < 2.0, "scaled decode matches the full image averaged down");
+  ScratchArena::release(full.pixels);
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testPredictPipelineWritesInInputOrder()
+{
+  std::cout << "  testPredictPipelineWritesInInputOrder... ";
+
+  std::string inputPath = (tempDir() + "/predict_pipeline_inputs.json").toStdString();
+  const int numInputs = 200;
+
+  QFile file(QString::fromStdString(inputPath));
+  file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  file.write("{\"inputs\": [");
+
+  for (int i = 0; i < numInputs; i++) {
+    std::string entry = (i > 0 ? ", [" : "[") + std::to_string(i) + "]";
+    file.write(entry.c_str(), entry.size());
+  }
+
+  file.write("]}");
+  file.close();
+
+  // Workers finish out of order (every third input is slow); the writer must still see 0, 1, 2, ...
+  PredictPipeline pipeline(4, 8);
+  std::vector<float> written;
+
+  auto predict = [](int, const nlohmann::json& entry) {
+    float value = entry.at(0).get<float>();
+
+    if (static_cast<int>(value) % 3 == 0)
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+    return std::vector<float>{value * 2.0f};
+  };
+
+  auto write = [&](ulong index, const std::vector<float>& output) {
+    CHECK(index == written.size(), "outputs are written in input order");
+    written.push_back(output[0]);
+  };
+
+  file.open(QIODevice::ReadOnly);
+  ulong count = pipeline.run(file, "inputs", predict, write, 0);
+  file.close();
+
+  bool ordered = count == numInputs && written.size() == numInputs;
+
+  for (int i = 0; ordered && i < numInputs; i++)
+    ordered = written[i] == i * 2.0f;
+
+  CHECK(ordered, "every input is predicted and written once, in order");
+
+  // finish runs once per output on the workers, before the writer sees that output
+  std::mutex finishMutex;
+  std::vector<int> finishedCount(numInputs, 0);
+  bool finishedBeforeWrite = true;
+
+  auto finish = [&](ulong index, const std::vector<float>& output) {
+    std::lock_guard<std::mutex> lock(finishMutex);
+    finishedCount[index] += (output[0] == index * 2.0f) ? 1 : 100;
+  };
+
+  auto checkFinished = [&](ulong index, const std::vector<float>&) {
+    std::lock_guard<std::mutex> lock(finishMutex);
+    finishedBeforeWrite = finishedBeforeWrite && finishedCount[index] == 1;
+  };
+
+  file.open(QIODevice::ReadOnly);
+  pipeline.run(file, "inputs", predict, finish, checkFinished, 0);
+  file.close();
+
+  CHECK(finishedBeforeWrite && std::count(finishedCount.begin(), finishedCount.end(), 1) == numInputs,
+        "finish sees every output once, before it is written");
+
+  // A failing input stops the pipeline and surfaces its error
+  bool threw = false;
+  file.open(QIODevice::ReadOnly);
+
+  try {
+    pipeline.run(
+      file, "inputs",
+      [](int, const nlohmann::json& entry) -> std::vector<float> {
+        if (entry.at(0).get<int>() == 57)
+          throw std::runtime_error("bad input 57");
+
+        return {0.0f};
+      },
+      [](ulong, const std::vector<float>&) {}, 0);
+  } catch (const std::runtime_error& e) {
+    threw = std::string(e.what()) == "bad input 57";
+  }
+
+  file.close();
+  CHECK(threw, "predict error is rethrown from run()");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testJsonLinesReadLineByLine()
+{
+  std::cout << "  testJsonLinesReadLineByLine... ";
+
+  CHECK(JsonStream::isJsonLinesPath("inputs.jsonl") && JsonStream::isJsonLinesPath("INPUTS.JSONL"),
+        ".jsonl paths are JSON Lines, in any case");
+  CHECK(!JsonStream::isJsonLinesPath("inputs.json") && !JsonStream::isJsonLinesPath("jsonl"),
+        "other paths are not JSON Lines");
+
+  // Blank lines and CRLF endings are tolerated; the last line need not end with a newline
+  std::string inputPath = (tempDir() + "/json_lines_inputs.jsonl").toStdString();
+  QFile file(QString::fromStdString(inputPath));
+  file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  file.write("[0, 1]\n\n[2, 3]\r\n  [4, 5]  \n[6, 7]");
+  file.close();
+
+  std::vector<std::vector<float>> values;
+  size_t lastCount = 0;
+  size_t lastBytesRead = 0;
+  size_t lastBytesTotal = 1;
+
+  file.open(QIODevice::ReadOnly);
+  size_t count = JsonStream::forEachRecord(
+    file, "inputs", [&](const nlohmann::json& entry) { values.push_back(entry.get<std::vector<float>>()); },
+    [&](size_t elements, size_t bytesRead, size_t bytesTotal) {
+      lastCount = elements;
+      lastBytesRead = bytesRead;
+      lastBytesTotal = bytesTotal;
+    });
+  file.close();
+
+  bool parsed = count == 4 && values.size() == 4;
+
+  for (size_t i = 0; parsed && i < values.size(); i++)
+    parsed = values[i] == std::vector<float>{2.0f * i, 2.0f * i + 1.0f};
+
+  CHECK(parsed, "every non-blank line is one value, in file order");
+  CHECK(lastCount == 4 && lastBytesRead == lastBytesTotal, "progress completes at the end of the file");
+
+  // The pipeline reads .jsonl inputs the same way
+  PredictPipeline pipeline(2, 4);
+  std::vector<float> written;
+  file.open(QIODevice::ReadOnly);
+  pipeline.run(
+    file, "inputs", [](int, const nlohmann::json& entry) { return std::vector<float>{entry.at(1).get<float>()}; },
+    [&](ulong, const std::vector<float>& output) { written.push_back(output[0]); }, 0);
+  file.close();
+  CHECK((written == std::vector<float>{1.0f, 3.0f, 5.0f, 7.0f}), "pipeline predicts every line in order");
+
+  // A malformed line is reported with its line number
+  file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  file.write("[0]\n[1]\n[2,\n[3]\n");
+  file.close();
+
+  std::string message;
+  file.open(QIODevice::ReadOnly);
+
+  try {
+    JsonStream::forEachLine(file, [](const nlohmann::json&) {});
+  } catch (const std::runtime_error& e) {
+    message = e.what();
+  }
+
+  file.close();
+  CHECK(message.find("line 3") != std::string::npos, "invalid line is reported by number");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testJsonWriterRoundTripsFloats()
+{
+  std::cout << "  testJsonWriterRoundTripsFloats... ";
+
+  std::vector<float> values = {0.0f, -0.0f, 1.0f, 0.1f, -2.5f, 1e-30f, 3.4028235e38f, 1.17549435e-38f, 123456.789f};
+  std::vector<std::vector<std::vector<float>>> nested = {{{1.5f, 2.0f}, {}}, {{0.3f}}};
+
+  nlohmann::ordered_json metadata;
+  metadata["numInputs"] = 3;
+  metadata["label"] = "a \"quoted\" name";
+
+  // A tiny buffer forces many partial writes, including a metadata string larger than the buffer
+  std::string path = (tempDir() + "/json_writer.json").toStdString();
+  QFile file(QString::fromStdString(path));
+  file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+
+  JsonWriter writer(file, 32);
+  writer.raw("{\n  \"metadata\": ");
+  writer.value(metadata, 2, 1);
+  writer.raw(",\n  \"values\": ");
+  writer.array(values);
+  writer.raw(",\n  \"nested\": ");
+  writer.array(nested);
+  writer.raw(",\n  \"notFinite\": ");
+  writer.array(std::vector<float>{std::nanf(""), INFINITY});
+  writer.raw("\n}\n");
+  writer.flush();
+  file.close();
+
+  file.open(QIODevice::ReadOnly);
+  QByteArray text = file.readAll();
+  file.close();
+
+  nlohmann::json parsed = nlohmann::json::parse(text.constData(), text.constData() + text.size());
+
+  CHECK(parsed.at("metadata") == nlohmann::json(metadata), "DOM values are written as nlohmann would");
+
+  std::vector<float> readBack = parsed.at("values").get<std::vector<float>>();
+  bool exact = readBack.size() == values.size();
+
+  for (size_t i = 0; exact && i < values.size(); i++)
+    exact = std::memcmp(&readBack[i], &values[i], sizeof(float)) == 0;
+
+  CHECK(exact, "every float parses back to the same bits");
+  CHECK(parsed.at("nested").get<std::vector<std::vector<std::vector<float>>>>() == nested,
+        "nested vectors become nested arrays");
+  CHECK(parsed.at("notFinite").at(0).is_null() && parsed.at("notFinite").at(1).is_null(),
+        "non-finite floats are written as null");
+  CHECK(std::string(text.constData(), text.size()).find("0.1,") != std::string::npos,
+        "floats use their shortest form");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testServerAnswersFramedRequests()
+{
+  std::cout << "  testServerAnswersFramedRequests... ";
+
+  // A model that doubles its 2 inputs
+  Server server(
+    2, [](const nlohmann::json& entry) { return entry.get<std::vector<float>>(); },
+    [](std::vector<std::vector<float>> inputs, PredictLatency&) {
+      for (auto& input : inputs)
+        for (float& value : input)
+          value *= 2.0f;
+
+      return inputs;
+    });
+
+  int requestPipe[2];
+  int responsePipe[2];
+  CHECK(::pipe(requestPipe) == 0 && ::pipe(responsePipe) == 0, "pipes created");
+
+  bool servedToEnd = false;
+  std::thread serving([&]() {
+    server.serveStream(requestPipe[0], responsePipe[1]);
+    servedToEnd = true;
+  });
+
+  Server::Frame response;
+
+  Server::writeFrame(requestPipe[1], {'J', R"({"inputs": [[1, 2], [3, 4]]})"});
+  CHECK(Server::readFrame(responsePipe[0], response) && response.type == 'J', "JSON request gets a JSON response");
+  CHECK(nlohmann::json::parse(response.payload).at("outputs") == nlohmann::json::parse("[[2.0, 4.0], [6.0, 8.0]]"),
+        "one output per input, in order");
+
+  Server::writeFrame(requestPipe[1], {'J', R"({"input": [0.5, -1]})"});
+  Server::readFrame(responsePipe[0], response);
+  CHECK(nlohmann::json::parse(response.payload).at("output") == nlohmann::json::parse("[1.0, -2.0]"),
+        "single input gets a single output");
+
+  Server::writeFrame(requestPipe[1], {'J', R"({"inputs": [[1, 2, 3]]})"});
+  Server::readFrame(responsePipe[0], response);
+  CHECK(response.type == 'E' && response.payload.find("Input size (3)") != std::string::npos,
+        "wrong input size gets an error frame");
+
+  std::vector<float> floats = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Server::writeFrame(requestPipe[1], {'F', std::string(reinterpret_cast<const char*>(floats.data()),
+                                                       floats.size() * sizeof(float))});
+  Server::readFrame(responsePipe[0], response);
+  std::vector<float> outputs(response.payload.size() / sizeof(float));
+  std::memcpy(outputs.data(), response.payload.data(), response.payload.size());
+  CHECK(response.type == 'F' && outputs == std::vector<float>({2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f}),
+        "float32 request is answered after an error, as float32");
+
+  // Closing the request stream ends the session without a response
+  ::close(requestPipe[1]);
+  serving.join();
+  CHECK(servedToEnd, "session ends at end of input");
+
+  ::close(requestPipe[0]);
+  ::close(responsePipe[0]);
+  ::close(responsePipe[1]);
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testPredictSchedulerBatchesConcurrentRequests()
+{
+  std::cout << "  testPredictSchedulerBatchesConcurrentRequests... ";
+
+  using Scheduler = PredictScheduler<ANN::Input<float>, ANN::Output<float>>;
+
+  //-- Concurrent single-input requests are predicted together, in batches of at most maxBatchSize --//
+  std::mutex batchSizesMutex;
+  std::vector<size_t> batchSizes;
+
+  {
+    Scheduler scheduler(1, 4, std::chrono::milliseconds(20), 16, std::chrono::microseconds(0),
+                        [&](int, std::vector<ANN::Input<float>>& batch) {
+                          {
+                            std::lock_guard<std::mutex> lock(batchSizesMutex);
+                            batchSizes.push_back(batch.size());
+                          }
+
+                          std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                          std::vector<ANN::Output<float>> outputs;
+
+                          for (const auto& input : batch)
+                            outputs.push_back({input[0] * 2.0f});
+
+                          return outputs;
+                        });
+
+    std::vector<std::thread> clients;
+    std::vector<float> results(8, 0.0f);
+    std::vector<PredictLatency> latencies(8);
+
+    for (int i = 0; i < 8; i++)
+      clients.emplace_back([&, i]() {
+        results[i] = scheduler.submit({{static_cast<float>(i)}}, &latencies[i]).front().front();
+      });
+
+    for (auto& client : clients)
+      client.join();
+
+    bool correct = true;
+
+    for (int i = 0; i < 8; i++)
+      correct = correct && results[i] == 2.0f * i && latencies[i].queueSeconds >= 0 && latencies[i].computeSeconds > 0;
+
+    CHECK(correct, "every request gets its own output and latency");
+    CHECK(batchSizes.size() < 8, "concurrent requests share batches");
+    CHECK(*std::max_element(batchSizes.begin(), batchSizes.end()) <= 4, "batches never exceed maxBatchSize");
+
+    std::vector<float> many = {1, 2, 3, 4, 5, 6};
+    std::vector<ANN::Input<float>> manyInputs;
+
+    for (float value : many)
+      manyInputs.push_back({value});
+
+    std::vector<ANN::Output<float>> manyOutputs = scheduler.submit(manyInputs);
+    correct = manyOutputs.size() == many.size();
+
+    for (size_t i = 0; correct && i < many.size(); i++)
+      correct = manyOutputs[i].front() == 2.0f * many[i];
+
+    CHECK(correct, "a multi-input request keeps input order across batches");
+  }
+
+  //-- With every worker idle, a lone request is predicted at once instead of waiting out maxWait --//
+  {
+    Scheduler scheduler(2, 32, std::chrono::seconds(2), 16, std::chrono::microseconds(0),
+                        [](int, std::vector<ANN::Input<float>>& batch) {
+                          return std::vector<ANN::Output<float>>(batch.size(), ANN::Output<float>{1.0f});
+                        });
+
+    bool prompt = true;
+
+    for (int i = 0; i < 3; i++) {
+      auto start = std::chrono::steady_clock::now();
+      scheduler.submit({{static_cast<float>(i)}});
+      prompt = prompt && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200);
+    }
+
+    CHECK(prompt, "lone requests finish well inside maxWait");
+  }
+
+  //-- A full queue rejects new requests once the admission timeout passes --//
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+
+  Scheduler blocked(1, 1, std::chrono::microseconds(0), 2, std::chrono::microseconds(0),
+                    [&](int, std::vector<ANN::Input<float>>& batch) {
+                      entered = true;
+
+                      while (!release)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                      return std::vector<ANN::Output<float>>(batch.size(), ANN::Output<float>{1.0f});
+                    });
+
+  std::vector<std::thread> waiting;
+  waiting.emplace_back([&]() { blocked.submit({{0.0f}}); });
+
+  while (!entered)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  // The worker is busy: these two fill the queue
+  waiting.emplace_back([&]() { blocked.submit({{1.0f}}); });
+  waiting.emplace_back([&]() { blocked.submit({{2.0f}}); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  bool rejected = false;
+
+  try {
+    blocked.submit({{3.0f}});
+  } catch (const std::runtime_error& e) {
+    rejected = std::string(e.what()).find("busy") != std::string::npos;
+  }
+
+  CHECK(rejected, "request rejected while the queue is full");
+
+  bool tooLarge = false;
+
+  try {
+    blocked.submit(std::vector<ANN::Input<float>>(3, ANN::Input<float>{0.0f}));
+  } catch (const std::runtime_error&) {
+    tooLarge = true;
+  }
+
+  CHECK(tooLarge, "request larger than the queue rejected");
+
+  release = true;
+
+  for (auto& thread : waiting)
+    thread.join();
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testIDXSourceNormalisesPerBatch()
+{
+  std::cout << "  testIDXSourceNormalisesPerBatch... ";
+
+  std::string dataPath = (tempDir() + "/dataloader_idx_data.idx3").toStdString();
+  std::string labelsPath = (tempDir() + "/dataloader_idx_labels.idx1").toStdString();
+
+  // Three 2x2 images with pixel values i*10 .. i*10+3, labels 2, 0, 1
+  QFile dataFile(QString::fromStdString(dataPath));
+  dataFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  writeBigEndian(dataFile, 0x00000803);
+  writeBigEndian(dataFile, 3);
+  writeBigEndian(dataFile, 2);
+  writeBigEndian(dataFile, 2);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      char value = static_cast<char>(i * 10 + j);
+      dataFile.write(&value, 1);
+    }
+  }
+
+  dataFile.close();
+
+  QFile labelsFile(QString::fromStdString(labelsPath));
+  labelsFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  writeBigEndian(labelsFile, 0x00000801);
+  writeBigEndian(labelsFile, 3);
+  labelsFile.write("\x02\x00\x01", 3);
+  labelsFile.close();
+
+  DataLoader<CNN::Sample<float>> loader;
+  loader.loadIDX(dataPath, labelsPath, 1, 2, 2);
+  CHECK(loader.numSamples() == 3, "IDX loader has 3 samples");
+
+  auto provider = loader.makeSampleProvider();
+  std::vector<ulong> indices = {2, 0};
+  auto batch = provider(indices, 2, 0);
+
+  CHECK(batch.size() == 2, "IDX batch has 2 samples");
+  CHECK(batch[0].input.data.size() == 4 && batch[0].input.data[3] == 23.0f / 255.0f, "IDX input normalised");
+  CHECK(batch[0].output == std::vector<float>({0.0f, 1.0f, 0.0f}), "IDX label 1 one-hot encoded");
+  CHECK(batch[1].output == std::vector<float>({0.0f, 0.0f, 1.0f}), "IDX label 2 one-hot encoded");
+
+  auto outputs = loader.getAllOutputs();
+  CHECK(outputs.size() == 3 && outputs[1][0] == 1.0f, "IDX getAllOutputs expands labels");
+
+  bool threw = false;
+
+  try {
+    DataLoader<CNN::Sample<float>> wrongShape;
+    wrongShape.loadIDX(dataPath, labelsPath, 1, 3, 3);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+
+  CHECK(threw, "IDX item size must match the input shape");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
+static void testIDXFileDecodesWideElementTypes()
+{
+  std::cout << "  testIDXFileDecodesWideElementTypes... ";
+
+  std::string dataPath = (tempDir() + "/dataloader_idx_float.idx").toStdString();
+  std::string labelsPath = (tempDir() + "/dataloader_idx_int.idx").toStdString();
+
+  // float32 data, 4 dimensions (2 items of 1x1x3), big-endian
+  QFile dataFile(QString::fromStdString(dataPath));
+  dataFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  writeBigEndian(dataFile, 0x00000D04);
+  writeBigEndian(dataFile, 2);
+  writeBigEndian(dataFile, 1);
+  writeBigEndian(dataFile, 1);
+  writeBigEndian(dataFile, 3);
+  for (float value : {0.5f, -1.25f, 3.0f, 7.5f, 0.0f, -0.125f}) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeBigEndian(dataFile, bits);
+  }
+
+  dataFile.close();
+
+  // int32 labels
+  QFile labelsFile(QString::fromStdString(labelsPath));
+  labelsFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  writeBigEndian(labelsFile, 0x00000C01);
+  writeBigEndian(labelsFile, 2);
+  writeBigEndian(labelsFile, 3);
+  writeBigEndian(labelsFile, 1);
+  labelsFile.close();
+
+  std::unique_ptr<IDXFile> idx = IDXFile::open(dataPath);
+  CHECK(idx->elementType() == IDXFile::ElementType::FLOAT, "float element type detected");
+  CHECK(idx->dims().size() == 4 && idx->numItems() == 2 && idx->itemSize() == 3, "dimensions read");
+  CHECK(idx->item(1)[0] == 7.5 && idx->item(0)[1] == -1.25, "item view decodes big-endian floats");
+
+  std::unique_ptr<IDXDataset> dataset = IDXDataset::open(dataPath, labelsPath);
+  CHECK(dataset->numClasses() == 4, "int labels give 4 classes");
+
+  std::vector<float> input(3), output(4);
+  dataset->readInput(1, input.data());
+  dataset->readOutput(0, output.data());
+  CHECK(input[2] == -0.125f, "float data is not rescaled");
+  CHECK(output == std::vector<float>({0.0f, 0.0f, 0.0f, 1.0f}), "int label one-hot encoded");
+
+  // Fewer elements than the dimensions promise
+  dataFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  writeBigEndian(dataFile, 0x00000802);
+  writeBigEndian(dataFile, 4);
+  writeBigEndian(dataFile, 8);
+  dataFile.write("short", 5);
+  dataFile.close();
+
+  bool threw = false;
+
+  try {
+    IDXFile::open(dataPath);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+
+  CHECK(threw, "truncated IDX file rejected");
+
+  std::cout << std::endl;
+}
+
+//===================================================================================================================//
+
 void runDataLoaderTests()
 {
   testProviderReturnsCorrectBatches();
   testProviderRespectsShuffledIndices();
   testPrefetchOverlapsWithProcessing();
   testNewEpochResetsPrefetch();
+  testRecycledBatchesReuseSampleBuffers();
+  testAugmentationIndependentOfThreadsAndBatches();
+  testPackedDatasetRoundTrip();
+  testPackedDatasetRejectsCorruptHeader();
+  testManifestStreamsSamplesArray();
+  testCheckpointWriterKeepsLatestAndFinishes();
+  testBinaryModelRejectsCorruptPreamble();
+  testImageCacheEvictsWithinBudget();
+  testManifestImagesServedFromCache();
+  testDiskImageCacheDetectsStaleAndCorruptEntries();
+  testParallelImageLoaderKeepsRequestOrder();
+  testParallelImageWriterSavesEveryImage();
+  testFusedAugmentationMatchesSequentialTransforms();
+  testPixelKernelsMatchScalarLoop();
+  testScratchArenaServesDecodingAfterWarmUp();
+  testImageDecoderBackendsMatchStb();
+  testPredictPipelineWritesInInputOrder();
+  testJsonLinesReadLineByLine();
+  testJsonWriterRoundTripsFloats();
+  testServerAnswersFramedRequests();
+  testPredictSchedulerBatchesConcurrentRequests();
+  testIDXSourceNormalisesPerBatch();
+  testIDXFileDecodesWideElementTypes();
 }
@@ -18,7 +18,8 @@ static void testInvalidMode()
   auto result = runNNCLI({"--config", fixturePath("ann_train_config.json"), "--mode", "invalid"});
 
   CHECK(result.exitCode == 1, "Invalid mode: exit code 1");
-  CHECK(result.stdErr.contains("Error: Mode must be 'train', 'predict', or 'test'."), "Invalid mode: error message");
+  CHECK(result.stdErr.contains("Error: Mode must be 'train', 'predict', 'test', 'convert', or 'serve'."),
+        "Invalid mode: error message");
   std::cout << std::endl;
 }
 
@@ -75,6 +76,24 @@ static void testPredictWithoutInput()
   std::cout << std::endl;
 }
 
+static void testStreamPredictMissingInput()
+{
+  std::cout << "  testStreamPredictMissingInput... ";
+
+  if (trainedANNModelPath.isEmpty() || !QFile::exists(trainedANNModelPath)) {
+    CHECK(false, "Stream predict missing input: skipped — no trained model available");
+    std::cout << std::endl;
+    return;
+  }
+
+  auto result = runNNCLI({"--config", trainedANNModelPath, "--mode", "predict", "--device", "cpu", "--stream",
+                          "--input", tempDir() + "/no_such_input.json", "--output", tempDir() + "/no_output.json"});
+
+  CHECK(result.exitCode == 1, "Stream predict missing input: exit code 1");
+  CHECK(result.stdErr.contains("Error: Failed to open input file:"), "Stream predict missing input: error message");
+  std::cout << std::endl;
+}
+
 static void testIdxWithoutLabels()
 {
   std::cout << "  testIdxWithoutLabels... ";
@@ -148,6 +167,7 @@ void runErrorTests()
   testMissingSamplesANN();
   testMissingSamplesCNN();
   testPredictWithoutInput();
+  testStreamPredictMissingInput();
   testIdxWithoutLabels();
   testBothSamplesAndIdx();
   testInvalidActvFuncANN();